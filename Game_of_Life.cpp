@@ -7,13 +7,25 @@
  * @date March, 2020
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <utility>
 
 // Uses cxxopts from https://github.com/jarro2783/cxxopts under the MIT license
 #include "cxxopts/cxxopts.hxx"
 
+#include "allocator.h"
+#include "batch.h"
+#include "distributed.h"
 #include "grid.h"
+#include "profile.h"
+#include "server.h"
+#include "shared.h"
+#include "statistics.h"
+#include "topology.h"
 #include "world.h"
 #include "zoo.h"
 
@@ -29,6 +41,20 @@ int main(int argc, char *argv[]) {
             ("s,steps","The number of steps to simulate the world.", cxxopts::value<int>()->default_value("10"))
             ("e,every","Print world to the console every N steps. 0 disables printing.", cxxopts::value<int>()->default_value("0"))
             ("t,toroidal", "Simulate the Game of Life on a torus.", cxxopts::value<bool>()->default_value("false"))
+            ("a,allocator", "Allocate grid cells with one of: pool, default, aligned, hugepage, arena.", cxxopts::value<std::string>()->default_value("pool"))
+            ("engine", "Step with one of: reference, kernel, bits.", cxxopts::value<std::string>()->default_value("reference"))
+            ("j,threads", "Threads for the kernel and bits engines and --daemon, or workers for --batch. 0 uses every core.", cxxopts::value<int>()->default_value("1"))
+            ("pin", "Pin the kernel and bits engines' threads to cores across NUMA nodes, and place each band of rows on its thread's node.", cxxopts::value<bool>()->default_value("false"))
+            ("processes", "Split the world across N processes exchanging halos through shared memory, with the bits engine. Only the final state is printed.", cxxopts::value<int>())
+            ("batch", "Run every job in a manifest of 'input output steps [toroidal|bounded]' lines, then exit.", cxxopts::value<std::string>())
+            ("daemon", "Serve requests on a Unix domain socket at the provided path until a client asks it to shut down.", cxxopts::value<std::string>())
+            ("io-threads", "Threads saving the results of --batch.", cxxopts::value<int>()->default_value("2"))
+            ("publish", "Publish every generation into the POSIX shared memory segment with the provided name, e.g. /gol, for viewers in other processes.", cxxopts::value<std::string>())
+            ("stats", "Save the population, births, deaths and time of recent steps to the provided path, as JSON if it ends in .json or CSV otherwise.", cxxopts::value<std::string>())
+            ("history", "The number of recent steps kept for --stats.", cxxopts::value<int>()->default_value("1024"))
+            ("q,quiet", "Do not print the grids, only the cell counts.", cxxopts::value<bool>()->default_value("false"))
+            ("profile", "Measure the step phases and file I/O with hardware performance counters and print a table at the end.", cxxopts::value<bool>()->default_value("false"))
+            ("b,bench", "Time the steps and report generations and cell updates per second. Implies --quiet.", cxxopts::value<bool>()->default_value("false"))
             ("h,help", "Print usage.");
 
     // Actually parse the command line arguments
@@ -44,6 +70,70 @@ int main(int argc, char *argv[]) {
     const int  steps    = result["steps"].as<int>();
     const int  every    = result["every"].as<int>();
     const bool toroidal = result["toroidal"].as<bool>();
+    const bool bench    = result["bench"].as<bool>();
+    const bool quiet    = result["quiet"].as<bool>() || bench;
+    const std::string engine = result["engine"].as<std::string>();
+    const int  threads  = result["threads"].as<int>();
+    Profile::enable(result["profile"].as<bool>());
+    Topology::enable(result["pin"].as<bool>());
+
+    // The reference engine is World::step cell by cell, kernel is the row kernel and bits the bit-packed kernel
+    if (engine != "reference" && engine != "kernel" && engine != "bits") {
+        std::cerr << "Unknown engine: " << engine << std::endl;
+        std::exit(-1);
+    }
+    const int processes = result.count("processes") ? result["processes"].as<int>() : 0;
+    if (result.count("processes") && (processes < 1 || engine != "bits")) {
+        std::cerr << "--processes needs at least 1 process and --engine bits" << std::endl;
+        std::exit(-1);
+    }
+    if (threads < 0) {
+        std::cerr << "The number of threads must not be negative: " << threads << std::endl;
+        std::exit(-1);
+    }
+
+    // Choose where grid cells are allocated before any grid is made
+    try {
+        Memory::set_default_policy(Memory::parse_policy(result["allocator"].as<std::string>()));
+    }
+    catch (const std::exception &ex) {
+        std::cerr << ex.what() << std::endl;
+        std::exit(-1);
+    }
+
+    // Keep worlds resident and answer requests on a socket instead of running a single world
+    if (result.count("daemon")) {
+        try {
+            Server::Options server_options;
+            server_options.threads = static_cast<unsigned int>(threads);
+            std::cout << "Listening on " << result["daemon"].as<std::string>() << std::endl;
+            Server::serve(result["daemon"].as<std::string>(), server_options);
+            std::exit(0);
+        }
+        catch (const std::exception &ex) {
+            std::cerr << ex.what() << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // Run a whole manifest of jobs in this process instead of a single world
+    if (result.count("batch")) {
+        try {
+            Batch::Options batch_options;
+            batch_options.threads = static_cast<unsigned int>(threads);
+            batch_options.io_threads = static_cast<unsigned int>(std::max(0, result["io-threads"].as<int>()));
+            const Batch::Report report = Batch::run(Batch::load_manifest(result["batch"].as<std::string>()), batch_options);
+            std::cout << report;
+            if (Profile::enabled()) {
+                Profile::report(std::cout);
+            }
+            std::exit(report.failures.empty() ? 0 : -1);
+        }
+        catch (const std::exception &ex) {
+            std::cerr << ex.what() << std::endl;
+            std::exit(-1);
+        }
+    }
 
     // Start with an empty grid
     Grid grid;
@@ -59,34 +149,187 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    // Construct a world from the parsed grid
-    World world(grid);
+    // Recent generations are only counted if they are going to be saved
+    std::unique_ptr<Statistics::History> history;
+    if (result.count("stats")) {
+        try {
+            history.reset(new Statistics::History(result["history"].as<int>()));
+        }
+        catch (const std::exception &ex) {
+            std::cerr << ex.what() << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // Viewers map the segment by name, it is made as large as the loaded grid and removed on exit
+    std::unique_ptr<Shared::Publisher> publisher;
+    if (result.count("publish")) {
+        try {
+            publisher.reset(new Shared::Publisher(result["publish"].as<std::string>(), grid.get_width(), grid.get_height()));
+        }
+        catch (const std::exception &ex) {
+            std::cerr << ex.what() << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // Only the chosen engine holds the grid, the kernels ping-pong between two grids of their own layout
+    World world;
+    Grid current, next;
+    BitGrid bits_current, bits_next;
+    if (engine == "reference") {
+        world = World(std::move(grid));
+        world.set_statistics(history.get());
+        world.set_publisher(publisher.get());
+    } else if (engine == "kernel") {
+        current = std::move(grid);
+    } else {
+        bits_current = BitGrid(grid);
+        grid = Grid();
+    }
+
+    // Threaded kernels step each band of rows on the node its pages are placed on
+    World::place(current, threads);
+    BitWorld::place(bits_current, threads);
+
+    // The world publishes its own steps, the kernels are published here
+    auto publish_state = [&]() {
+        if (publisher && engine == "kernel") {
+            publisher->publish(GridView(current));
+        } else if (publisher && engine == "bits") {
+            publisher->publish(BitGridView(bits_current));
+        }
+    };
+    publish_state();
+
+    auto alive_cells = [&]() {
+        return engine == "reference" ? world.get_alive_cells() :
+               engine == "kernel" ? current.get_alive_cells() : bits_current.get_alive_cells();
+    };
+    auto total_cells = [&]() {
+        return engine == "reference" ? world.get_total_cells() :
+               engine == "kernel" ? current.get_total_cells() : bits_current.get_total_cells();
+    };
+    auto print_state = [&]() {
+        if (engine == "bits") {
+            std::cout << bits_current << std::endl;
+        } else {
+            std::cout << (engine == "reference" ? world.get_state() : current) << std::endl;
+        }
+    };
 
     // Print the initial state of the grid
     std::cout << "Initial state..." << std::endl
-              << "Alive " << world.get_alive_cells() << " | Dead " << world.get_dead_cells()  << std::endl
-              << world.get_state() << std::endl;
+              << "Alive " << alive_cells() << " | Dead " << (total_cells() - alive_cells()) << std::endl;
+    if (!quiet) {
+        print_state();
+    }
 
-    // Perform the requested number of update steps
-    for (int step = 0; step < steps; step++) {
-        world.step(toroidal);
+    // Perform the requested number of update steps, timing only the steps themselves
+    std::chrono::steady_clock::duration elapsed(0);
+    if (processes > 0) {
+        // The processes step every generation before returning, so there is nothing to print or publish between
+        Distributed::Options distributed_options;
+        distributed_options.processes = processes;
+        distributed_options.threads = threads;
+        distributed_options.toroidal = toroidal;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            bits_current = Distributed::run(bits_current, steps, distributed_options);
+        }
+        catch (const std::exception &ex) {
+            std::cerr << ex.what() << std::endl;
+            std::exit(-1);
+        }
+        elapsed = std::chrono::steady_clock::now() - start;
+        publish_state();
+    }
+    for (int step = 0; processes == 0 && step < steps; step++) {
+        const auto start = std::chrono::steady_clock::now();
+        Statistics::Generation counts;
+        Statistics::Generation *kernel_counts = history ? &counts : nullptr;
+        if (engine == "reference") {
+            world.step(toroidal);
+        } else if (engine == "kernel") {
+            World::step(current, next, toroidal, threads, kernel_counts);
+            std::swap(current, next);
+        } else {
+            BitWorld::step(bits_current, bits_next, toroidal, threads, kernel_counts);
+            std::swap(bits_current, bits_next);
+        }
+        publish_state();
+        const auto step_time = std::chrono::steady_clock::now() - start;
+        elapsed += step_time;
+
+        // The world records its own steps, the kernels are recorded here
+        if (kernel_counts && engine != "reference") {
+            counts.seconds = std::chrono::duration<double>(step_time).count();
+            history->record(counts);
+        }
 
         // Print the state of the grid every N steps
-        if ((every > 0) && (step % every == 0)) {
-            std::cout << "Step " << (step + 1) << " of " << steps << std::endl
-                      << world.get_state() << std::endl;
+        if (!quiet && (every > 0) && (step % every == 0)) {
+            std::cout << "Step " << (step + 1) << " of " << steps << std::endl;
+            print_state();
         }
     }
 
     // Print the final state of the grid
     std::cout << "Final state..." << std::endl
-              << "Alive " << world.get_alive_cells() << " | Dead " << world.get_dead_cells()  << std::endl
-              << world.get_state() << std::endl;
+              << "Alive " << alive_cells() << " | Dead " << (total_cells() - alive_cells()) << std::endl;
+    if (!quiet) {
+        print_state();
+    }
+
+    // Report the throughput of the step loop
+    if (bench) {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const double updates = static_cast<double>(total_cells()) * steps;
+
+        // Report the threads that stepped, as the kernels split the rows, the reference engine only ever uses one.
+        // Each process steps its own rows, so processes with fewer rows may use fewer threads
+        std::string used_threads = "1";
+        if (processes > 0) {
+            Distributed::Options distributed_options;
+            distributed_options.processes = processes;
+            const Distributed::Layout layout = Distributed::layout(distributed_options, bits_current.get_width(),
+                                                                   bits_current.get_height());
+            const int rows = static_cast<int>(layout.rows);
+            const unsigned int fewest = BitWorld::bands(bits_current.get_height() / rows, threads);
+            const unsigned int most = BitWorld::bands((bits_current.get_height() + rows - 1) / rows, threads);
+            used_threads = std::to_string(fewest) + (fewest == most ? "" : " to " + std::to_string(most))
+                           + " per process | Processes " + std::to_string(processes) + " as "
+                           + std::to_string(layout.columns) + " x " + std::to_string(layout.rows);
+        } else if (engine != "reference") {
+            used_threads = std::to_string(engine == "kernel" ? World::bands(current.get_height(), threads) :
+                                          BitWorld::bands(bits_current.get_height(), threads));
+        }
+        std::cout << "Engine " << engine << " | Threads " << used_threads
+                  << " | Steps " << steps << " in " << seconds << " s"
+                  << " | " << (seconds > 0 ? steps / seconds : 0) << " generations/s"
+                  << " | " << (seconds > 0 ? updates / seconds : 0) << " cell updates/s" << std::endl;
+    }
+
+    // Attempt to save the recent generations if a path was given
+    if (history) {
+        try {
+            Statistics::save(result["stats"].as<std::string>(), *history);
+        }
+        catch (const std::exception &ex) {
+            std::cerr << ex.what() << std::endl;
+            std::exit(-1);
+        }
+    }
 
     // Attempt to save to the output directory if a path was given
     if (result.count("output")) {
         try {
-            Zoo::save_ascii(result["output"].as<std::string>(), world.get_state());
+            const std::string path = result["output"].as<std::string>();
+            if (engine == "bits") {
+                Zoo::save_ascii(path, bits_current);
+            } else {
+                Zoo::save_ascii(path, engine == "reference" ? world.get_state() : current);
+            }
         }
         catch (const std::exception &ex) {
             std::cerr << ex.what() << std::endl;
@@ -94,6 +337,11 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    // Print the measured phases, including the save above
+    if (Profile::enabled()) {
+        Profile::report(std::cout);
+    }
+
     // Destructors handle all the memory deallocation
     return 0;
 }
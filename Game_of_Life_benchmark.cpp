@@ -0,0 +1,974 @@
+/**
+ * Benchmarks for the Grid, World and Zoo hot paths on multi-megacell grids.
+ * i.e.
+ * ./Game_of_Life_benchmark
+ * ./Game_of_Life_benchmark --filter step --repetitions 9 --json results.json
+ *
+ * Each case is repeated and the best, median, mean and standard deviation of the times are kept.
+ * A summary line is printed as ns/cell, Mcells/s and, for cases which stream memory or files, MB/s.
+ *
+ * Options:
+ *      --filter text       Only run cases whose name contains text. Groups with no such case skip building their grids.
+ *      --repetitions n     Run every case n times instead of its default.
+ *      --json path         Also write every result to path as JSON, for comparing runs.
+ *      --profile           Measure the step phases and file I/O with hardware counters and print them at the end.
+ *                          World::step is split into separate passes while profiling, so its times are slower.
+ *      --pin               Pin step threads to cores across NUMA nodes and place each band of rows on its thread's node.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "allocator.h"
+#include "changes.h"
+#include "grid.h"
+#include "profile.h"
+#include "static_world.h"
+#include "tiled.h"
+#include "topology.h"
+#include "world.h"
+#include "zoo.h"
+
+/**
+ * The timings of one benchmark case, in seconds per run.
+ */
+struct Result {
+	std::string name;
+	std::uint64_t cells;
+	std::uint64_t bytes;
+	int repetitions;
+	double best;
+	double median;
+	double mean;
+	double deviation;
+};
+
+// Options from the command line, and every result so far
+static std::string filter;
+static int repetitions_override = 0;
+static std::vector<Result> results;
+static volatile std::uint64_t sink;
+
+/**
+ * Keep a result alive so the compiler cannot drop the work which made it.
+ * @param value - The result.
+ */
+static void consume(const std::uint64_t value) {
+	sink = sink + value;
+}
+
+/**
+ * Check whether any case of a group passes the filter, so a group with none can return before building its grids.
+ * @param names - The names of every case in the group.
+ * @return True if any of the names contains the filter.
+ */
+static bool selected(const std::vector<std::string> &names) {
+	for (const std::string &name : names) {
+		if (name.find(filter) != std::string::npos) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Keep the timings of a benchmark case and print a summary line.
+ * @param name - The name of the case.
+ * @param cells - The number of cells processed by one run.
+ * @param bytes - The number of bytes read or written by one run, or 0 if the case is not measured in bytes.
+ * @param seconds - The time of each run.
+ */
+static void record(const std::string &name, const std::uint64_t cells, const std::uint64_t bytes,
+				   std::vector<double> seconds) {
+	std::sort(seconds.begin(), seconds.end());
+
+	const int repetitions = static_cast<int>(seconds.size());
+	Result result = {name, cells, bytes, repetitions, seconds.front(), seconds[seconds.size() / 2], 0, 0};
+	for (const double time : seconds) {
+		result.mean += time / seconds.size();
+	}
+	for (const double time : seconds) {
+		result.deviation += (time - result.mean) * (time - result.mean) / seconds.size();
+	}
+	result.deviation = std::sqrt(result.deviation);
+	results.push_back(result);
+
+	std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(3)
+			  << " best " << std::setw(8) << (result.best * 1e9 / cells) << " ns/cell"
+			  << " | median " << std::setw(8) << (result.median * 1e9 / cells) << " ns/cell"
+			  << " | " << std::setw(9) << (cells / result.best / 1e6) << " Mcells/s";
+	if (bytes > 0) {
+		std::cout << " | " << std::setw(9) << (bytes / result.best / 1e6) << " MB/s";
+	}
+	std::cout << " | +- " << std::setprecision(1) << (100 * result.deviation / result.mean) << "%" << std::endl;
+}
+
+/**
+ * Time a benchmark case and print a summary line.
+ * @param name - The name of the case.
+ * @param cells - The number of cells processed by one run.
+ * @param bytes - The number of bytes read or written by one run, or 0 if the case is not measured in bytes.
+ * @param repetitions - The number of times to run the case.
+ * @param run - The case to time.
+ */
+static void benchmark(const std::string &name, const std::uint64_t cells, const std::uint64_t bytes, int repetitions,
+					  const std::function<void()> &run) {
+	if (name.find(filter) == std::string::npos) {
+		return;
+	}
+	if (repetitions_override > 0) {
+		repetitions = repetitions_override;
+	}
+
+	std::vector<double> seconds;
+	for (int i = 0; i < repetitions; i++) {
+		const auto start = std::chrono::steady_clock::now();
+		run();
+		const auto end = std::chrono::steady_clock::now();
+		seconds.push_back(std::chrono::duration<double>(end - start).count());
+	}
+	record(name, cells, bytes, seconds);
+}
+
+/**
+ * Time only one Profile phase of a benchmark case, for code which cannot be called on its own.
+ * Profiling is enabled while the case runs, and left as it was afterwards.
+ * @param name - The name of the case.
+ * @param phase - The name of the Profile phase to time.
+ * @param cells - The number of cells processed by the phase in one run.
+ * @param bytes - The number of bytes read or written by the phase in one run.
+ * @param repetitions - The number of times to run the case.
+ * @param run - The case to run.
+ */
+static void benchmark_phase(const std::string &name, const std::string &phase, const std::uint64_t cells,
+							const std::uint64_t bytes, int repetitions, const std::function<void()> &run) {
+	if (name.find(filter) == std::string::npos) {
+		return;
+	}
+	if (repetitions_override > 0) {
+		repetitions = repetitions_override;
+	}
+
+	auto total = [&phase]() {
+		for (const Profile::Phase &totals : Profile::phases()) {
+			if (totals.name == phase) {
+				return totals.seconds;
+			}
+		}
+		return 0.0;
+	};
+
+	const bool profiling = Profile::enabled();
+	Profile::enable();
+	std::vector<double> seconds;
+	for (int i = 0; i < repetitions; i++) {
+		const double before = total();
+		run();
+		seconds.push_back(total() - before);
+	}
+	Profile::enable(profiling);
+	record(name, cells, bytes, seconds);
+}
+
+/**
+ * Time a benchmark case which is only measured in cells.
+ */
+static void benchmark(const std::string &name, const std::uint64_t cells, const int repetitions,
+					  const std::function<void()> &run) {
+	benchmark(name, cells, 0, repetitions, run);
+}
+
+/**
+ * Write every result as a JSON array of objects, with times in seconds per run.
+ * @param path - The file to write.
+ */
+static void write_json(const std::string &path) {
+	std::ofstream file(path);
+	if (!file) {
+		throw std::runtime_error("File cannot be opened: " + path);
+	}
+
+	auto quote = [](const std::string &text) {
+		std::string quoted = "\"";
+		for (const char c : text) {
+			if (c == '"' || c == '\\') {
+				quoted += '\\';
+			}
+			quoted += c;
+		}
+		return quoted + "\"";
+	};
+
+	file << std::setprecision(9) << "[" << std::endl;
+	for (std::size_t i = 0; i < results.size(); i++) {
+		const Result &result = results[i];
+		file << "  {\"name\": " << quote(result.name)
+			 << ", \"cells\": " << result.cells
+			 << ", \"bytes\": " << result.bytes
+			 << ", \"repetitions\": " << result.repetitions
+			 << ", \"best_seconds\": " << result.best
+			 << ", \"median_seconds\": " << result.median
+			 << ", \"mean_seconds\": " << result.mean
+			 << ", \"deviation_seconds\": " << result.deviation
+			 << ", \"ns_per_cell\": " << (result.best * 1e9 / result.cells)
+			 << ", \"cells_per_second\": " << (result.cells / result.best)
+			 << ", \"bytes_per_second\": " << (result.bytes / result.best)
+			 << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+	file << "]" << std::endl;
+}
+
+/**
+ * Make a grid filled with random cells.
+ * @param width - The width of the grid.
+ * @param height - The height of the grid.
+ * @param density - The chance of each cell being alive.
+ * @return The random grid.
+ */
+static Grid random_grid(const int width, const int height, const double density) {
+	std::mt19937_64 rng(width * 31 + height);
+	std::bernoulli_distribution alive(density);
+	Grid grid(width, height);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			if (alive(rng)) {
+				grid(x, y) = Cell::ALIVE;
+			}
+		}
+	}
+	return grid;
+}
+
+/**
+ * Benchmark stepping bounded and toroidal worlds over a range of sizes and densities.
+ * World::step is the per-cell path through count_neighbours, the static step is the row kernel.
+ * count_neighbours is private, so it is timed as the neighbour count phase World::step runs while profiling.
+ * Each step reads the current grid and writes the next, so it streams two bytes per cell, as does the count
+ * writing one count per cell.
+ * @param size - The edge of the square world, toroidal worlds are square.
+ * @param density - The chance of each cell starting alive.
+ */
+static void benchmark_steps(const int size, const double density) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(size) * size;
+	const int kernel_generations = static_cast<int>(std::max<std::uint64_t>(1, (16u << 20) / cells));
+	const int world_generations = static_cast<int>(std::max<std::uint64_t>(1, (4u << 20) / cells));
+	std::stringstream label;
+	label << std::fixed << std::setprecision(1) << "density " << density << " " << size << "x" << size;
+	if (!selected({"step kernel bounded " + label.str(), "World::advance bounded " + label.str(),
+				   "count_neighbours bounded " + label.str(), "step kernel toroidal " + label.str(),
+				   "World::advance toroidal " + label.str(), "count_neighbours toroidal " + label.str()})) {
+		return;
+	}
+	const Grid soup = random_grid(size, size, density);
+
+	for (const bool toroidal : {false, true}) {
+		const std::string edges = toroidal ? "toroidal " : "bounded ";
+		Grid source(soup), destination;
+		benchmark("step kernel " + edges + label.str(), cells * kernel_generations, 2 * cells * kernel_generations,
+				  5, [&]() {
+			for (int generation = 0; generation < kernel_generations; generation++) {
+				World::step(source, destination, toroidal);
+				std::swap(source, destination);
+			}
+		});
+
+		World world(soup);
+		benchmark("World::advance " + edges + label.str(), cells * world_generations, 2 * cells * world_generations,
+				  3, [&]() {
+			world.advance(world_generations, toroidal);
+		});
+
+		benchmark_phase("count_neighbours " + edges + label.str(), "World::step neighbour count",
+						cells * world_generations, 2 * cells * world_generations, 3, [&]() {
+			world.advance(world_generations, toroidal);
+		});
+	}
+}
+
+/**
+ * Benchmark counting alive cells in a whole grid and in a view which does not start on a word boundary.
+ * @param width - The width of the grid.
+ * @param height - The height of the grid.
+ */
+static void benchmark_counts(const int width, const int height) {
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	if (!selected({"get_alive_cells " + size, "get_alive_cells view " + size})) {
+		return;
+	}
+	const Grid grid = random_grid(width, height, 0.3);
+	const GridView view = grid.crop_view(3, 5, width - 7, height - 2);
+
+	unsigned int alive = 0;
+	benchmark("get_alive_cells " + size, grid.get_total_cells(), grid.get_total_cells(), 9, [&]() {
+		alive += grid.get_alive_cells();
+	});
+	benchmark("get_alive_cells view " + size, view.get_total_cells(), view.get_total_cells(), 9, [&]() {
+		alive += view.get_alive_cells();
+	});
+	consume(alive);
+}
+
+/**
+ * Benchmark cropping sub-regions out of a large grid, as an owned copy and as a view materialized later.
+ * @param width - The width of the grid.
+ * @param height - The height of the grid.
+ */
+static void benchmark_crops(const int width, const int height) {
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	if (!selected({"crop quarter " + size, "crop_view materialize quarter " + size})) {
+		return;
+	}
+	const Grid grid = random_grid(width, height, 0.3);
+	const std::uint64_t cells = static_cast<std::uint64_t>(width / 2) * (height / 2);
+
+	Grid destination;
+	benchmark("crop quarter " + size, cells, 2 * cells, 5, [&]() {
+		destination = grid.crop(width / 4 + 1, height / 4, width / 4 + 1 + width / 2, height / 4 + height / 2);
+	});
+	benchmark("crop_view materialize quarter " + size, cells, 2 * cells, 5, [&]() {
+		destination = grid.crop_view(width / 4 + 1, height / 4, width / 4 + 1 + width / 2, height / 4 + height / 2)
+			.materialize();
+	});
+}
+
+/**
+ * Benchmark saving and loading a grid in both file formats.
+ * The byte rate is the size of the file.
+ * @param width - The width of the grid.
+ * @param height - The height of the grid.
+ */
+static void benchmark_files(const int width, const int height) {
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	if (!selected({"save_ascii " + size, "load_ascii " + size, "save_binary " + size, "load_binary " + size})) {
+		return;
+	}
+	const Grid grid = random_grid(width, height, 0.3);
+	const std::uint64_t cells = grid.get_total_cells();
+	const std::string ascii_path = "Game_of_Life_benchmark.gol";
+	const std::string binary_path = "Game_of_Life_benchmark.bgol";
+	const std::uint64_t ascii_bytes = std::to_string(width).size() + std::to_string(height).size() + 2 +
+									  static_cast<std::uint64_t>(width + 1) * height;
+	const std::uint64_t binary_bytes = 8 + (cells + 7) / 8;
+
+	unsigned int alive = 0;
+	benchmark("save_ascii " + size, cells, ascii_bytes, 5, [&]() {
+		Zoo::save_ascii(ascii_path, grid);
+	});
+	benchmark("load_ascii " + size, cells, ascii_bytes, 5, [&]() {
+		alive += Zoo::load_ascii(ascii_path).get_width();
+	});
+	benchmark("save_binary " + size, cells, binary_bytes, 5, [&]() {
+		Zoo::save_binary(binary_path, grid);
+	});
+	benchmark("load_binary " + size, cells, binary_bytes, 5, [&]() {
+		alive += Zoo::load_binary(binary_path).get_width();
+	});
+
+	std::remove(ascii_path.c_str());
+	std::remove(binary_path.c_str());
+	consume(alive);
+}
+
+/**
+ * Rotate by 90 degrees one cell at a time, the way Grid::rotate used to walk the source.
+ * Kept as a baseline to compare the tiled transforms against.
+ * @param grid - The grid to rotate.
+ * @return The rotated grid.
+ */
+static Grid rotate_cell_by_cell(const Grid &grid) {
+	Grid rotated(grid.get_height(), grid.get_width());
+	for (int x = 0; x < grid.get_width(); x++) {
+		for (int y = 0; y < grid.get_height(); y++) {
+			rotated(grid.get_height() - 1 - y, x) = grid(x, y);
+		}
+	}
+	return rotated;
+}
+
+/**
+ * Benchmark all 8 symmetries writing into a reused destination, against the cell by cell baseline.
+ * @param width - The width of the grid.
+ * @param height - The height of the grid.
+ */
+static void benchmark_transforms(const int width, const int height) {
+	const std::pair<Symmetry, std::string> symmetries[] = {
+		{Symmetry::IDENTITY, "identity"},
+		{Symmetry::ROTATE_90, "rotate 90"},
+		{Symmetry::ROTATE_180, "rotate 180"},
+		{Symmetry::ROTATE_270, "rotate 270"},
+		{Symmetry::FLIP_LEFT_RIGHT, "flip left right"},
+		{Symmetry::FLIP_TOP_BOTTOM, "flip top bottom"},
+		{Symmetry::TRANSPOSE, "transpose"},
+		{Symmetry::ANTI_TRANSPOSE, "anti transpose"},
+	};
+
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	std::vector<std::string> names = {"cell by cell rotate 90 " + size, "rotate(1) " + size};
+	for (const auto &symmetry : symmetries) {
+		names.push_back("transform_into " + symmetry.second + " " + size);
+	}
+	if (!selected(names)) {
+		return;
+	}
+
+	const Grid grid = random_grid(width, height, 0.5);
+	const std::uint64_t cells = grid.get_total_cells();
+	Grid destination;
+
+	benchmark("cell by cell rotate 90 " + size, cells, 3, [&]() {
+		destination = rotate_cell_by_cell(grid);
+	});
+	benchmark("rotate(1) " + size, cells, 5, [&]() {
+		destination = grid.rotate(1);
+	});
+	for (const auto &symmetry : symmetries) {
+		benchmark("transform_into " + symmetry.second + " " + size, cells, 5, [&]() {
+			grid.transform_into(destination, symmetry.first);
+		});
+	}
+}
+
+/**
+ * Benchmark stamping a small pattern across a large grid with each blend.
+ * @param width - The width of the grid.
+ * @param height - The height of the grid.
+ */
+static void benchmark_merges(const int width, const int height) {
+	const std::pair<Blend, std::string> blends[] = {
+		{Blend::OVERWRITE, "overwrite"},
+		{Blend::OR, "or"},
+		{Blend::AND, "and"},
+		{Blend::XOR, "xor"},
+		{Blend::AND_NOT, "and not"},
+	};
+
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	std::vector<std::string> names;
+	for (const auto &blend : blends) {
+		names.push_back("merge " + blend.second + " clipped stamps " + size);
+	}
+	if (!selected(names)) {
+		return;
+	}
+
+	Grid grid = random_grid(width, height, 0.5);
+	const Grid stamp = random_grid(61, 37, 0.3);
+
+	for (const auto &blend : blends) {
+		std::uint64_t cells = 0;
+		for (int y = -17; y < height; y += 29) {
+			for (int x = -23; x < width; x += 53) {
+				cells += stamp.get_total_cells();
+			}
+		}
+		benchmark("merge " + blend.second + " clipped stamps " + size, cells, 5, [&]() {
+			for (int y = -17; y < height; y += 29) {
+				for (int x = -23; x < width; x += 53) {
+					grid.merge(stamp, x, y, blend.first, true);
+				}
+			}
+		});
+	}
+}
+
+/**
+ * Benchmark a grid growing around its centre in small steps, with and without reserving capacity first.
+ * @param start - The starting edge size of the grid.
+ * @param end - The final edge size of the grid.
+ */
+static void benchmark_resizes(const int start, const int end) {
+	std::uint64_t cells = 0;
+	for (int size = start; size <= end; size += 16) {
+		cells += static_cast<std::uint64_t>(size) * size;
+	}
+	const std::string sizes = std::to_string(start) + " to " + std::to_string(end);
+
+	for (const bool reserve : {false, true}) {
+		benchmark(std::string("resize centre ") + (reserve ? "reserved " : "") + sizes, cells, 3, [&]() {
+			Grid grid = random_grid(start, start, 0.5);
+			if (reserve) {
+				grid.reserve(static_cast<std::size_t>(end) * end);
+			}
+			for (int size = start; size <= end; size += 16) {
+				grid.resize(size, size, Anchor::CENTRE);
+			}
+		});
+	}
+}
+
+/**
+ * Benchmark stepping a world whose grids are drawn from each allocation policy,
+ * both through World::step and through the static row kernel ping-ponging two grids.
+ * @param width - The width of the world.
+ * @param height - The height of the world.
+ * @param generations - The number of generations per run.
+ */
+static void benchmark_allocators(const int width, const int height, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(width) * height * generations;
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	const Memory::Policy policies[] = {Memory::Policy::DEFAULT, Memory::Policy::ALIGNED,
+									   Memory::Policy::HUGE_PAGES, Memory::Policy::ARENA, Memory::Policy::POOL};
+	std::vector<std::string> names;
+	for (const Memory::Policy policy : policies) {
+		names.push_back("step kernel " + Memory::policy_name(policy) + " " + size);
+		names.push_back("World::step " + Memory::policy_name(policy) + " " + size);
+	}
+	if (!selected(names)) {
+		return;
+	}
+	const Grid soup = random_grid(width, height, 0.3);
+
+	for (const Memory::Policy policy : policies) {
+		const std::string name = Memory::policy_name(policy);
+		if (!selected({"step kernel " + name + " " + size, "World::step " + name + " " + size})) {
+			continue;
+		}
+
+		Grid source(width, height, policy);
+		source.merge(soup, 0, 0, Blend::OVERWRITE);
+		Grid destination(width, height, policy);
+		World world(source);
+		benchmark("step kernel " + name + " " + size, cells, 5, [&]() {
+			for (int generation = 0; generation < generations; generation++) {
+				World::step(source, destination);
+				std::swap(source, destination);
+			}
+		});
+
+		benchmark("World::step " + name + " " + size, cells, 3, [&]() {
+			world.advance(generations);
+		});
+	}
+}
+
+/**
+ * Benchmark making and dropping many small grids, as analysis passes do, with and without the buffer pool.
+ * @param crops - The number of crops and rotations per run.
+ */
+static void benchmark_pool(const int crops) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(crops) * 64 * 64;
+	if (!selected({"crop and rotate 64x64 " + Memory::policy_name(Memory::Policy::DEFAULT),
+				   "crop and rotate 64x64 " + Memory::policy_name(Memory::Policy::POOL)})) {
+		return;
+	}
+	const Grid soup = random_grid(1024, 1024, 0.3);
+
+	for (const Memory::Policy policy : {Memory::Policy::DEFAULT, Memory::Policy::POOL}) {
+		const Memory::Policy previous = Memory::get_default_policy();
+		Memory::set_default_policy(policy);
+		Memory::reset_pool_statistics();
+		const std::size_t previous_results = results.size();
+
+		benchmark("crop and rotate 64x64 " + Memory::policy_name(policy), cells, 5, [&]() {
+			unsigned int alive = 0;
+			for (int i = 0; i < crops; i++) {
+				const int x = (i * 67) % (1024 - 64);
+				const int y = (i * 131) % (1024 - 64);
+				alive += soup.crop(x, y, x + 64, y + 64).rotate(1).get_alive_cells();
+			}
+			if (alive == 0) {
+				std::cout << "empty soup" << std::endl;
+			}
+		});
+
+		const Memory::PoolStatistics statistics = Memory::pool_statistics();
+		if (results.size() > previous_results) {
+			std::cout << "  pool hits " << statistics.hits << " | misses " << statistics.misses
+					  << " | recycled " << statistics.recycled << " | released " << statistics.released << std::endl;
+		}
+		Memory::set_default_policy(previous);
+	}
+}
+
+/**
+ * Time the threaded bit-packed kernel as threads are added, up to one per cpu.
+ * With --pin the grids are placed first and the workers pinned, so the cases show how well
+ * stepping scales across NUMA nodes.
+ * @param width - The width of the grid.
+ * @param height - The height of the grid.
+ * @param generations - The number of generations per repetition.
+ */
+static void benchmark_scaling(const int width, const int height, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(width) * height;
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	const unsigned int cpus = static_cast<unsigned int>(Topology::cpus().size());
+	auto case_name = [&size](const unsigned int threads) {
+		return "step kernel bits " + size + " threads " + std::to_string(threads) + (Topology::enabled() ? " pinned" : "");
+	};
+	std::vector<std::string> names;
+	for (unsigned int threads = 1; ; threads = std::min(threads * 2, cpus)) {
+		names.push_back(case_name(threads));
+		if (threads >= cpus) {
+			break;
+		}
+	}
+	if (!selected(names)) {
+		return;
+	}
+	const BitGrid soup(random_grid(width, height, 0.3));
+
+	for (unsigned int threads = 1; ; threads = std::min(threads * 2, cpus)) {
+		const std::string name = case_name(threads);
+		if (!selected({name})) {
+			if (threads >= cpus) {
+				break;
+			}
+			continue;
+		}
+		BitGrid source(soup), destination(width, height);
+		BitWorld::place(source, threads);
+		BitWorld::place(destination, threads);
+		benchmark(name, cells * generations, 5, [&]() {
+			for (int generation = 0; generation < generations; generation++) {
+				BitWorld::step(source, destination, false, threads);
+				std::swap(source, destination);
+			}
+		});
+		if (threads >= cpus) {
+			break;
+		}
+	}
+}
+
+/**
+ * Time looking a small window ahead with the light cone query, against advancing the whole grid and cropping.
+ * @param size - The width and height of the grid.
+ * @param window - The width and height of the window, in the centre of the grid.
+ * @param generations - The number of generations ahead.
+ */
+static void benchmark_light_cone(const int size, const int window, const int generations) {
+	const std::string name = std::to_string(window) + "x" + std::to_string(window) + " of " +
+							 std::to_string(size) + "x" + std::to_string(size) + " " + std::to_string(generations) + " ahead";
+	if (!selected({"crop ahead light cone " + name, "crop ahead advance then crop " + name})) {
+		return;
+	}
+	const BitGrid soup(random_grid(size, size, 0.3));
+	const int x0 = (size - window) / 2;
+	const int x1 = x0 + window;
+	const std::uint64_t cells = static_cast<std::uint64_t>(window) * window;
+
+	unsigned int alive = 0;
+	benchmark("crop ahead light cone " + name, cells, 5, [&]() {
+		alive += BitWorld::crop_ahead(soup, x0, x0, x1, x1, generations).get_alive_cells();
+	});
+	benchmark("crop ahead advance then crop " + name, cells, 3, [&]() {
+		BitGrid current(soup), next;
+		for (int generation = 0; generation < generations; generation++) {
+			BitWorld::step(current, next);
+			std::swap(current, next);
+		}
+		alive += current.crop(x0, x0, x1, x1).get_alive_cells();
+	});
+	consume(alive);
+}
+
+/**
+ * Time keeping a snapshot of every generation of a small soup in a large world,
+ * copying a whole BitGrid each time against sharing unchanged tiles of a TiledGrid.
+ * @param size - The width and height of the world.
+ * @param soup - The width and height of the random soup in its centre.
+ * @param generations - The number of generations kept.
+ */
+static void benchmark_snapshots(const int size, const int soup, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(size) * size;
+	const std::string name = std::to_string(soup) + "x" + std::to_string(soup) + " soup in " +
+							 std::to_string(size) + "x" + std::to_string(size);
+	if (!selected({"snapshot every generation bits " + name, "snapshot every generation tiled " + name})) {
+		return;
+	}
+	BitGrid initial(size, size);
+	initial.merge(BitGrid(random_grid(soup, soup, 0.3)), (size - soup) / 2, (size - soup) / 2);
+
+	std::size_t kept = 0;
+	benchmark("snapshot every generation bits " + name, cells * generations, 3, [&]() {
+		std::vector<BitGrid> history;
+		BitGrid current(initial), next;
+		for (int generation = 0; generation < generations; generation++) {
+			BitWorld::step(current, next);
+			std::swap(current, next);
+			history.push_back(current);
+		}
+		kept += history.size();
+	});
+	benchmark("snapshot every generation tiled " + name, cells * generations, 3, [&]() {
+		std::vector<TiledGrid> history;
+		TiledWorld world{TiledGrid(BitGridView(initial))};
+		for (int generation = 0; generation < generations; generation++) {
+			world.step();
+			history.push_back(world.get_state());
+		}
+		kept += TiledGrid::distinct_bytes(history);
+	});
+	consume(kept);
+}
+
+/**
+ * Time stepping a soup which has mostly settled into still lifes and blinkers, as a BitGrid, as a TiledGrid
+ * stepping every tile, and as a TiledWorld which replays the tiles whose neighbourhood repeats.
+ * @param size - The width and height of the soup, which is toroidal.
+ * @param settle - The number of generations the soup runs for before it is timed.
+ * @param generations - The number of generations timed.
+ */
+static void benchmark_settled(const int size, const int settle, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(size) * size;
+	const std::string name = std::to_string(size) + "x" + std::to_string(size) + " soup after " +
+							 std::to_string(settle) + " generations";
+	if (!selected({"settled bits " + name, "settled tiled " + name, "settled tiled replay " + name})) {
+		return;
+	}
+	TiledWorld settled{TiledGrid(GridView(random_grid(size, size, 0.3)))};
+	settled.advance(settle, true);
+	const BitGrid initial = settled.get_state().materialize();
+
+	std::uint64_t alive = 0;
+	benchmark("settled bits " + name, cells * generations, 3, [&]() {
+		BitGrid current(initial), next;
+		for (int generation = 0; generation < generations; generation++) {
+			BitWorld::step(current, next, true);
+			std::swap(current, next);
+		}
+		alive += current.get_alive_cells();
+	});
+	benchmark("settled tiled " + name, cells * generations, 3, [&]() {
+		TiledGrid current(settled.get_state()), next;
+		for (int generation = 0; generation < generations; generation++) {
+			TiledGrid::step(current, next, true);
+			std::swap(current, next);
+		}
+		alive += current.get_alive_cells();
+	});
+	std::size_t replayed = 0;
+	benchmark("settled tiled replay " + name, cells * generations, 3, [&]() {
+		TiledWorld world(settled);
+		for (int generation = 0; generation < generations; generation++) {
+			world.step(true);
+			replayed += world.get_replayed_tiles();
+		}
+		alive += world.get_alive_cells();
+	});
+	consume(alive + replayed);
+}
+
+/**
+ * Time finding what each step of a small soup in a large world changed, by comparing every row after the step
+ * against recording a change set during it, with and without listing the cells.
+ * @param size - The width and height of the world.
+ * @param soup - The width and height of the random soup in its centre.
+ * @param generations - The number of generations stepped.
+ */
+static void benchmark_changes(const int size, const int soup, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(size) * size;
+	const std::string name = std::to_string(soup) + "x" + std::to_string(soup) + " soup in " +
+							 std::to_string(size) + "x" + std::to_string(size);
+	if (!selected({"changes by rescan bits " + name, "changes tracked tiles " + name, "changes tracked cells " + name})) {
+		return;
+	}
+	BitGrid initial(size, size);
+	initial.merge(BitGrid(random_grid(soup, soup, 0.3)), (size - soup) / 2, (size - soup) / 2);
+
+	std::uint64_t changed = 0;
+	benchmark("changes by rescan bits " + name, cells * generations, 3, [&]() {
+		BitGrid current(initial), next;
+		for (int generation = 0; generation < generations; generation++) {
+			BitWorld::step(current, next);
+			for (int y = 0; y < size; y++) {
+				for (int x = 0; x < size; x += 64) {
+					changed += __builtin_popcountll(BitCells::load(current.row(y), x, std::min(64, size - x)) ^
+													BitCells::load(next.row(y), x, std::min(64, size - x)));
+				}
+			}
+			std::swap(current, next);
+		}
+	});
+	for (const bool list_cells : {false, true}) {
+		benchmark(std::string("changes tracked ") + (list_cells ? "cells " : "tiles ") + name,
+				  cells * generations, 3, [&]() {
+			BitGrid current(initial), next;
+			Changes::Set changes(64, list_cells);
+			for (int generation = 0; generation < generations; generation++) {
+				BitWorld::step(current, next, false, 1, nullptr, &changes);
+				std::swap(current, next);
+				changed += changes.count_dirty() + changes.get_born().size();
+			}
+		});
+	}
+	consume(changed);
+}
+
+/**
+ * Benchmark the one byte per cell layout against the bit-packed layout on the same soup.
+ * @param width - The width of the grids.
+ * @param height - The height of the grids.
+ * @param generations - The number of generations per step run.
+ */
+static void benchmark_layouts(const int width, const int height, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(width) * height;
+	const std::string size = std::to_string(width) + "x" + std::to_string(height);
+	std::vector<std::string> names;
+	for (const std::string operation : {"step kernel ", "count alive ", "rotate 90 ", "merge xor clipped stamps "}) {
+		names.push_back(operation + "bytes " + size);
+		names.push_back(operation + "bits " + size);
+	}
+	if (!selected(names)) {
+		return;
+	}
+	const Grid soup = random_grid(width, height, 0.3);
+	const Grid stamp = random_grid(61, 37, 0.3);
+
+	Grid bytes_source(soup), bytes_destination;
+	BitGrid bits_source(soup), bits_destination;
+	benchmark("step kernel bytes " + size, cells * generations, 5, [&]() {
+		for (int generation = 0; generation < generations; generation++) {
+			World::step(bytes_source, bytes_destination);
+			std::swap(bytes_source, bytes_destination);
+		}
+	});
+	benchmark("step kernel bits " + size, cells * generations, 5, [&]() {
+		for (int generation = 0; generation < generations; generation++) {
+			BitWorld::step(bits_source, bits_destination);
+			std::swap(bits_source, bits_destination);
+		}
+	});
+
+	const BitGrid bits(soup);
+	unsigned int alive = 0;
+	benchmark("count alive bytes " + size, cells, 5, [&]() { alive += soup.get_alive_cells(); });
+	benchmark("count alive bits " + size, cells, 5, [&]() { alive += bits.get_alive_cells(); });
+	benchmark("rotate 90 bytes " + size, cells, 5, [&]() { alive += soup.rotate(1).get_width(); });
+	benchmark("rotate 90 bits " + size, cells, 5, [&]() { alive += bits.rotate(1).get_width(); });
+	consume(alive);
+
+	Grid bytes_grid(soup);
+	BitGrid bits_grid(soup);
+	const BitGrid bits_stamp(stamp);
+	std::uint64_t stamped = 0;
+	for (int y = -17; y < height; y += 29) {
+		for (int x = -23; x < width; x += 53) {
+			stamped += stamp.get_total_cells();
+		}
+	}
+	benchmark("merge xor clipped stamps bytes " + size, stamped, 5, [&]() {
+		for (int y = -17; y < height; y += 29) {
+			for (int x = -23; x < width; x += 53) {
+				bytes_grid.merge(stamp, x, y, Blend::XOR, true);
+			}
+		}
+	});
+	benchmark("merge xor clipped stamps bits " + size, stamped, 5, [&]() {
+		for (int y = -17; y < height; y += 29) {
+			for (int x = -23; x < width; x += 53) {
+				bits_grid.merge(bits_stamp, x, y, Blend::XOR, true);
+			}
+		}
+	});
+}
+
+/**
+ * Benchmark many short runs of a small pattern, as a search does, in a World and in a StaticWorld.
+ * @param runs - The number of runs.
+ * @param generations - The number of generations per run.
+ */
+static void benchmark_small_worlds(const int runs, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(runs) * 16 * 16 * generations;
+	constexpr StaticGrid<16, 16> seed = StaticGrid<16, 16>::parse("//////.......##/......##./.......#.");
+
+	unsigned int alive = 0;
+	benchmark("r-pentomino runs World 16x16", cells, 5, [&]() {
+		for (int i = 0; i < runs; i++) {
+			World world(seed);
+			world.advance(generations);
+			alive += world.get_alive_cells();
+		}
+	});
+	benchmark("r-pentomino runs StaticWorld 16x16", cells, 5, [&]() {
+		for (int i = 0; i < runs; i++) {
+			StaticWorld<16, 16> world(seed);
+			world.advance(generations);
+			alive += world.get_alive_cells();
+		}
+	});
+	consume(alive);
+}
+
+int main(int argc, char *argv[]) {
+	std::string json_path;
+	for (int i = 1; i < argc; i++) {
+		const std::string argument = argv[i];
+		if (argument == "--filter" && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (argument == "--repetitions" && i + 1 < argc) {
+			repetitions_override = std::atoi(argv[++i]);
+		} else if (argument == "--json" && i + 1 < argc) {
+			json_path = argv[++i];
+		} else if (argument == "--profile") {
+			Profile::enable();
+		} else if (argument == "--pin") {
+			Topology::enable();
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--filter text] [--repetitions n] [--json path] [--profile] [--pin]" << std::endl;
+			return -1;
+		}
+	}
+
+	for (const int size : {256, 1024, 4096}) {
+		for (const double density : {0.1, 0.3, 0.5}) {
+			benchmark_steps(size, density);
+		}
+	}
+
+	benchmark_counts(4096, 4096);
+	benchmark_crops(4096, 4096);
+
+	benchmark_transforms(1024, 1024);
+	benchmark_transforms(4096, 4096);
+	benchmark_transforms(4099, 2053);
+
+	benchmark_merges(4096, 4096);
+
+	benchmark_resizes(256, 2048);
+
+	benchmark_allocators(4096, 4096, 4);
+	benchmark_pool(100000);
+
+	benchmark_layouts(4096, 4096, 4);
+	benchmark_scaling(4096, 4096, 4);
+	benchmark_light_cone(4096, 16, 64);
+	benchmark_snapshots(4096, 256, 32);
+	benchmark_changes(4096, 256, 32);
+	benchmark_settled(1024, 4000, 64);
+
+	benchmark_small_worlds(10000, 16);
+
+	benchmark_files(2048, 2048);
+
+	if (!json_path.empty()) {
+		try {
+			write_json(json_path);
+		} catch (const std::exception &ex) {
+			std::cerr << ex.what() << std::endl;
+			return -1;
+		}
+	}
+
+	if (Profile::enabled()) {
+		Profile::report(std::cout);
+	}
+
+	return 0;
+}
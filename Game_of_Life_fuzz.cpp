@@ -0,0 +1,946 @@
+/**
+ * Differential fuzzer which checks every step engine against the reference World::step, generation by generation.
+ * i.e.
+ * ./Game_of_Life_fuzz
+ * ./Game_of_Life_fuzz --seed 7 --cases 1000 --generations 128
+ * ./Game_of_Life_fuzz --seed 7 --case 213
+ * ./Game_of_Life_fuzz --bench 1024 --generations 32
+ *
+ * Each case is a starting grid and a topology. Every engine which can run the case starts from the same grid,
+ * and after each generation the hash of every engine's state is compared with the reference engine's.
+ * On a mismatch the first differing cell is found and reported, with the seed and case number to reproduce it.
+ *
+ * The distributed engine splits each case across 1 to 4 forked processes, bounded or toroidal as the case is.
+ *
+ * The first cases are fixed adversarial grids: 1x1, 1xN, Nx1, widths either side of a 64 cell word, rows tall
+ * enough to be split into threaded bands, and patterns which live on the edges, each bounded and toroidal.
+ * The rest are random sizes, densities and topologies drawn from the seed.
+ *
+ * Once every generation has been checked, World::crop_ahead and BitWorld::crop_ahead are asked for a corner,
+ * a middle and a whole-grid window at the last generation, and must match the reference engine's state.
+ * The change sets World::step and the threaded BitWorld::step record for the first 8 generations must match
+ * the changes found by comparing every cell.
+ *
+ * A daemon is then forked and driven through a Server::Client. A world loaded over the socket must step as the
+ * reference engine does, and every rejected request must be answered with an error which leaves the daemon's
+ * worlds as they were.
+ *
+ * The time each engine spends stepping is totalled, so the run ends with a throughput table.
+ * --bench runs a single large random soup instead, to compare the engines' speed on the same work.
+ *
+ * Options:
+ *      --seed n            Seed the random cases with n. Defaults to 1.
+ *      --cases n           Run n random cases after the adversarial ones. Defaults to 200.
+ *      --generations n     Step each case n generations. Defaults to 64.
+ *      --case n            Only run case n, as reported by a failure.
+ *      --bench size        Only run a size x size random soup, and report the throughput of each engine.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "changes.h"
+#include "distributed.h"
+#include "grid.h"
+#include "server.h"
+#include "static_world.h"
+#include "tiled.h"
+#include "world.h"
+#include "zoo.h"
+
+/**
+ * One engine stepping one case, holding its own state in its own layout.
+ */
+class Runner {
+public:
+	virtual ~Runner() = default;
+	virtual void step() = 0;
+	virtual std::uint64_t hash() const = 0;
+	virtual Cell get(int x, int y) const = 0;
+};
+
+/**
+ * Steps a World or BitWorld with its member step, the per-cell path through count_neighbours.
+ */
+template <typename Storage>
+class MemberRunner : public Runner {
+private:
+	BasicWorld<Storage> world;
+	bool toroidal;
+
+public:
+	MemberRunner(const Grid &initial, const bool toroidal) : world(BasicGrid<Storage>(initial)), toroidal(toroidal) {}
+
+	void step() override {
+		this->world.step(this->toroidal);
+	}
+
+	std::uint64_t hash() const override {
+		return this->world.get_state().hash();
+	}
+
+	Cell get(const int x, const int y) const override {
+		return this->world.get_state().get(x, y);
+	}
+};
+
+/**
+ * Steps a pair of grids with the static step kernel of their layout, swapping them after each step.
+ */
+template <typename Storage>
+class KernelRunner : public Runner {
+private:
+	BasicGrid<Storage> current;
+	BasicGrid<Storage> next;
+	bool toroidal;
+	unsigned int threads;
+
+public:
+	KernelRunner(const Grid &initial, const bool toroidal, const unsigned int threads)
+		: current(initial), next(initial.get_width(), initial.get_height()), toroidal(toroidal), threads(threads) {}
+
+	void step() override {
+		BasicWorld<Storage>::step(this->current, this->next, this->toroidal, this->threads);
+		std::swap(this->current, this->next);
+	}
+
+	std::uint64_t hash() const override {
+		return this->current.hash();
+	}
+
+	Cell get(const int x, const int y) const override {
+		return this->current.get(x, y);
+	}
+};
+
+/**
+ * Steps a TiledWorld, keeping a snapshot of the generation before so that shared tiles are copied on write.
+ */
+class TiledRunner : public Runner {
+private:
+	TiledWorld world;
+	TiledGrid snapshot;
+	bool toroidal;
+
+public:
+	TiledRunner(const Grid &initial, const bool toroidal) : world(TiledGrid(GridView(initial))), toroidal(toroidal) {}
+
+	void step() override {
+		this->snapshot = this->world.get_state();
+		this->world.step(this->toroidal);
+	}
+
+	std::uint64_t hash() const override {
+		return this->world.get_state().materialize().hash();
+	}
+
+	Cell get(const int x, const int y) const override {
+		return this->world.get_state().get(x, y);
+	}
+};
+
+/**
+ * Steps a StaticWorld, which only runs cases of exactly its compile time size.
+ */
+template <int Width, int Height>
+class StaticRunner : public Runner {
+private:
+	StaticWorld<Width, Height> world;
+	bool toroidal;
+
+	static StaticGrid<Width, Height> convert(const Grid &initial) {
+		StaticGrid<Width, Height> grid;
+		for (int y = 0; y < Height; y++) {
+			for (int x = 0; x < Width; x++) {
+				grid(x, y) = initial.get(x, y);
+			}
+		}
+		return grid;
+	}
+
+public:
+	StaticRunner(const Grid &initial, const bool toroidal) : world(convert(initial)), toroidal(toroidal) {}
+
+	void step() override {
+		this->world.step(this->toroidal);
+	}
+
+	std::uint64_t hash() const override {
+		return this->world.get_state().hash();
+	}
+
+	Cell get(const int x, const int y) const override {
+		return this->world.get_state().get(x, y);
+	}
+};
+
+/**
+ * Steps a bit-packed world split across forked processes with Distributed::run.
+ * Most generations are a run of one step from the generation before. Every 8th is a run of 8 steps from
+ * the 8th before, so halos are also exchanged between processes from one generation to the next.
+ */
+class DistributedRunner : public Runner {
+private:
+	BitGrid checkpoint;
+	BitGrid current;
+	Distributed::Options options;
+	int generation;
+
+public:
+	DistributedRunner(const Grid &initial, const Distributed::Options &options)
+		: checkpoint(initial), current(initial), options(options), generation(0) {}
+
+	void step() override {
+		this->generation++;
+		if (this->generation % 8 == 0) {
+			this->current = Distributed::run(this->checkpoint, 8, this->options);
+			this->checkpoint = this->current;
+		} else {
+			this->current = Distributed::run(this->current, 1, this->options);
+		}
+	}
+
+	std::uint64_t hash() const override {
+		return this->current.hash();
+	}
+
+	Cell get(const int x, const int y) const override {
+		return this->current.get(x, y);
+	}
+};
+
+/**
+ * Start a world split across 1 to 4 processes, the number drawn from the size of the case.
+ * A case too small for that many subdomains takes the most processes it has room for.
+ * @param initial - The starting grid of the case.
+ * @param toroidal - The topology of the case.
+ * @return The runner, or nullptr if the grid has no cells.
+ */
+static std::unique_ptr<Runner> start_distributed(const Grid &initial, const bool toroidal) {
+	Distributed::Options options;
+	options.toroidal = toroidal;
+	for (options.processes = 1 + (initial.get_width() * 31u + initial.get_height()) % 4; options.processes > 0;
+		 options.processes--) {
+		try {
+			Distributed::layout(options, initial.get_width(), initial.get_height());
+			return std::unique_ptr<Runner>(new DistributedRunner(initial, options));
+		}
+		catch (const std::runtime_error &) {
+		}
+	}
+	return std::unique_ptr<Runner>();
+}
+
+/**
+ * Start a StaticWorld if the case is its size.
+ * @param initial - The starting grid of the case.
+ * @param toroidal - The topology of the case.
+ * @return The runner, or nullptr if the grid is another size.
+ */
+template <int Width, int Height>
+static std::unique_ptr<Runner> start_static(const Grid &initial, const bool toroidal) {
+	if (initial.get_width() != Width || initial.get_height() != Height) {
+		return nullptr;
+	}
+	return std::unique_ptr<Runner>(new StaticRunner<Width, Height>(initial, toroidal));
+}
+
+/**
+ * A named way of stepping a case, and its running totals.
+ * start gives nullptr if the engine cannot run the case.
+ */
+struct Engine {
+	std::string name;
+	std::function<std::unique_ptr<Runner>(const Grid &, bool)> start;
+	std::uint64_t steps = 0;
+	std::uint64_t cells = 0;
+	double seconds = 0;
+	unsigned int failures = 0;
+};
+
+/**
+ * Make every engine, the reference World::step first.
+ * Threaded engines use a fixed 4 threads, so a case splits into the same bands on any machine.
+ * @return The engines.
+ */
+static std::vector<Engine> make_engines() {
+	std::vector<Engine> engines(9);
+
+	engines[0].name = "reference";
+	engines[0].start = [](const Grid &initial, const bool toroidal) {
+		return std::unique_ptr<Runner>(new MemberRunner<ByteCells>(initial, toroidal));
+	};
+
+	engines[1].name = "reference bits";
+	engines[1].start = [](const Grid &initial, const bool toroidal) {
+		return std::unique_ptr<Runner>(new MemberRunner<BitCells>(initial, toroidal));
+	};
+
+	engines[2].name = "kernel";
+	engines[2].start = [](const Grid &initial, const bool toroidal) {
+		return std::unique_ptr<Runner>(new KernelRunner<ByteCells>(initial, toroidal, 1));
+	};
+
+	engines[3].name = "kernel x4";
+	engines[3].start = [](const Grid &initial, const bool toroidal) {
+		return std::unique_ptr<Runner>(new KernelRunner<ByteCells>(initial, toroidal, 4));
+	};
+
+	engines[4].name = "bits";
+	engines[4].start = [](const Grid &initial, const bool toroidal) {
+		return std::unique_ptr<Runner>(new KernelRunner<BitCells>(initial, toroidal, 1));
+	};
+
+	engines[5].name = "bits x4";
+	engines[5].start = [](const Grid &initial, const bool toroidal) {
+		return std::unique_ptr<Runner>(new KernelRunner<BitCells>(initial, toroidal, 4));
+	};
+
+	// Only the adversarial sizes have a StaticWorld compiled for them
+	engines[6].name = "static";
+	engines[6].start = [](const Grid &initial, const bool toroidal) {
+		for (const auto start : {start_static<1, 1>, start_static<1, 64>, start_static<64, 1>, start_static<3, 3>,
+								 start_static<63, 63>, start_static<64, 64>, start_static<65, 65>,
+								 start_static<129, 5>}) {
+			std::unique_ptr<Runner> runner = start(initial, toroidal);
+			if (runner) {
+				return runner;
+			}
+		}
+		return std::unique_ptr<Runner>();
+	};
+
+	engines[7].name = "tiled";
+	engines[7].start = [](const Grid &initial, const bool toroidal) {
+		return std::unique_ptr<Runner>(new TiledRunner(initial, toroidal));
+	};
+
+	// Forking costs far more than a step, so this is the slowest engine by some way
+	engines[8].name = "distributed";
+	engines[8].start = start_distributed;
+
+	return engines;
+}
+
+/**
+ * A starting grid and topology, with a description for reports.
+ */
+struct Case {
+	std::string description;
+	Grid grid;
+	bool toroidal;
+};
+
+// The patterns a case can start from
+enum Pattern {
+	EMPTY,
+	FULL,
+	BORDER,
+	CHECKERBOARD,
+	STRIPES,
+	RANDOM,
+	EDGE_GLIDERS,
+	PATTERNS
+};
+
+/**
+ * Fill a grid with a pattern.
+ * @param grid - The dead grid to fill.
+ * @param pattern - The pattern to draw.
+ * @param density - The chance of each cell being alive for RANDOM.
+ * @param rng - The generator for RANDOM.
+ * @return The name of the pattern.
+ */
+static std::string fill(Grid &grid, const Pattern pattern, const double density, std::mt19937_64 &rng) {
+	const int width = grid.get_width();
+	const int height = grid.get_height();
+	std::bernoulli_distribution alive(density);
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			bool cell = false;
+			switch (pattern) {
+				case FULL: cell = true; break;
+				case BORDER: cell = x == 0 || y == 0 || x == width - 1 || y == height - 1; break;
+				case CHECKERBOARD: cell = (x + y) % 2 == 0; break;
+				case STRIPES: cell = y % 2 == 0; break;
+				case RANDOM: cell = alive(rng); break;
+				default: break;
+			}
+			if (cell) {
+				grid(x, y) = Cell::ALIVE;
+			}
+		}
+	}
+
+	// Gliders in each corner heading out of the grid, so a toroidal world carries them across the edges
+	if (pattern == EDGE_GLIDERS && width >= 3 && height >= 3) {
+		const Grid glider = Zoo::glider();
+		grid.merge(glider.rotate(2), 0, 0, true);
+		grid.merge(glider.rotate(3), width - 3, 0, true);
+		grid.merge(glider, width - 3, height - 3, true);
+		grid.merge(glider.rotate(1), 0, height - 3, true);
+	}
+
+	const char *names[PATTERNS] = {"empty", "full", "border", "checkerboard", "stripes", "random", "edge gliders"};
+	std::stringstream name;
+	name << names[pattern];
+	if (pattern == RANDOM) {
+		name << " " << std::fixed << std::setprecision(2) << density;
+	}
+	return name.str();
+}
+
+// Sizes which sit on the edges of the engines' loops: single cells, single rows and columns, either side of
+// a 64 cell word, and tall enough for 4 threads to split into bands
+static const std::pair<int, int> adversarial_sizes[] = {
+	{1, 1}, {2, 1}, {1, 2}, {1, 64}, {64, 1}, {1, 65}, {65, 1}, {3, 3}, {5, 8}, {63, 63}, {64, 64}, {65, 65},
+	{127, 3}, {129, 5}, {1, 200}, {200, 1}, {8, 130}, {67, 257}
+};
+static const int adversarial_cases = sizeof(adversarial_sizes) / sizeof(adversarial_sizes[0]) * PATTERNS * 2;
+
+/**
+ * Make a case, the adversarial ones first and random ones after.
+ * Each case has its own generator seeded from the seed and index, so any case can be made on its own.
+ * @param seed - The seed of the run.
+ * @param index - The number of the case.
+ * @return The case.
+ */
+static Case make_case(const std::uint64_t seed, const int index) {
+	std::mt19937_64 rng(seed * 1000003 + index);
+	int width;
+	int height;
+	Pattern pattern;
+	bool toroidal;
+	double density = std::uniform_real_distribution<double>(0.05, 0.7)(rng);
+
+	if (index < adversarial_cases) {
+		const std::pair<int, int> &size = adversarial_sizes[index / (PATTERNS * 2)];
+		width = size.first;
+		height = size.second;
+		pattern = static_cast<Pattern>(index / 2 % PATTERNS);
+		toroidal = index % 2 == 1;
+	} else {
+		// Mostly small random sizes, sometimes near a word boundary or tall enough to be banded
+		auto dimension = [&rng](const int tall) {
+			switch (std::uniform_int_distribution<int>(0, 3)(rng)) {
+				case 0: return std::uniform_int_distribution<int>(1, 8)(rng);
+				case 1: return std::uniform_int_distribution<int>(60, 70)(rng);
+				case 2: return std::uniform_int_distribution<int>(120, 136)(rng);
+				default: return std::uniform_int_distribution<int>(1, tall)(rng);
+			}
+		};
+		width = dimension(200);
+		height = dimension(400);
+		pattern = std::uniform_int_distribution<int>(0, 3)(rng) == 0
+				  ? static_cast<Pattern>(std::uniform_int_distribution<int>(0, PATTERNS - 1)(rng))
+				  : RANDOM;
+		toroidal = std::bernoulli_distribution(0.5)(rng);
+	}
+
+	Case made = {"", Grid(width, height), toroidal};
+	std::stringstream description;
+	description << fill(made.grid, pattern, density, rng) << " " << width << "x" << height
+				<< (toroidal ? " toroidal" : " bounded");
+	made.description = description.str();
+	return made;
+}
+
+/**
+ * Check the light cone queries of both layouts against the reference engine's final state, for a few windows.
+ * @param run - The case, at generation 0.
+ * @param label - How to refer to the case in a report.
+ * @param generations - The number of generations the reference engine has stepped.
+ * @param reference - The reference engine, at its final generation.
+ * @return True if every window matched.
+ */
+static bool check_light_cones(const Case &run, const std::string &label, const int generations, const Runner &reference) {
+	const int width = run.grid.get_width();
+	const int height = run.grid.get_height();
+	const int windows[][4] = {
+		{0, 0, std::min(width, 3), std::min(height, 3)},
+		{width / 3, height / 3, width - width / 3, height - height / 3},
+		{0, 0, width, height}
+	};
+	const BitGrid bits(run.grid);
+
+	bool passed = true;
+	for (const auto &window : windows) {
+		const Grid bytes_window = World::crop_ahead(run.grid, window[0], window[1], window[2], window[3],
+													generations, run.toroidal);
+		const BitGrid bits_window = BitWorld::crop_ahead(bits, window[0], window[1], window[2], window[3],
+														 generations, run.toroidal);
+		for (int y = window[1]; y < window[3] && passed; y++) {
+			for (int x = window[0]; x < window[2] && passed; x++) {
+				const Cell expected = reference.get(x, y);
+				const Cell bytes_cell = bytes_window.get(x - window[0], y - window[1]);
+				const Cell bits_cell = bits_window.get(x - window[0], y - window[1]);
+				if (bytes_cell != expected || bits_cell != expected) {
+					std::cout << "FAIL " << label << " (" << run.description << "): crop_ahead of window ("
+							  << window[0] << ", " << window[1] << ", " << window[2] << ", " << window[3]
+							  << ") diverged at (" << x << ", " << y << ") expected '" << static_cast<char>(expected)
+							  << "' got '" << static_cast<char>(bytes_cell) << "' bytes and '"
+							  << static_cast<char>(bits_cell) << "' bits" << std::endl;
+					passed = false;
+				}
+			}
+		}
+	}
+	return passed;
+}
+
+/**
+ * Compare a change set with the changes found by comparing every cell of two grids.
+ * @param changes - The change set recorded by a step from before to after.
+ * @param before - The grid before the step.
+ * @param after - The grid after the step.
+ * @return An empty string if they match, otherwise the first difference.
+ */
+static std::string compare_changes(const Changes::Set &changes, const Grid &before, const Grid &after) {
+	const int width = before.get_width();
+	const int height = before.get_height();
+	const int size = changes.get_tile_size();
+	if (changes.get_width() != width || changes.get_height() != height) {
+		return "sized " + std::to_string(changes.get_width()) + "x" + std::to_string(changes.get_height());
+	}
+
+	std::vector<Changes::Point> born, died;
+	std::vector<Changes::Rows> rows;
+	std::vector<bool> dirty(static_cast<std::size_t>(changes.get_tiles_across()) * changes.get_tiles_down());
+	for (int y = 0; y < height; y++) {
+		bool row_changed = false;
+		for (int x = 0; x < width; x++) {
+			if (before.get(x, y) == after.get(x, y)) {
+				continue;
+			}
+			Changes::Point point;
+			point.x = x;
+			point.y = y;
+			(after.get(x, y) == Cell::ALIVE ? born : died).push_back(point);
+			dirty[static_cast<std::size_t>(y / size) * changes.get_tiles_across() + x / size] = true;
+			row_changed = true;
+		}
+		if (row_changed && !rows.empty() && rows.back().end == y) {
+			rows.back().end = y + 1;
+		} else if (row_changed) {
+			Changes::Rows run;
+			run.first = y;
+			run.end = y + 1;
+			rows.push_back(run);
+		}
+	}
+
+	if (changes.get_rows().size() != rows.size()) {
+		return std::to_string(changes.get_rows().size()) + " runs of rows, expected " + std::to_string(rows.size());
+	}
+	for (std::size_t i = 0; i < rows.size(); i++) {
+		if (changes.get_rows()[i].first != rows[i].first || changes.get_rows()[i].end != rows[i].end) {
+			return "run of rows " + std::to_string(i) + " is " + std::to_string(changes.get_rows()[i].first) + "-"
+				   + std::to_string(changes.get_rows()[i].end) + ", expected " + std::to_string(rows[i].first) + "-"
+				   + std::to_string(rows[i].end);
+		}
+	}
+	for (int ty = 0; ty < changes.get_tiles_down(); ty++) {
+		for (int tx = 0; tx < changes.get_tiles_across(); tx++) {
+			if (changes.is_dirty(tx, ty) != dirty[static_cast<std::size_t>(ty) * changes.get_tiles_across() + tx]) {
+				return "tile (" + std::to_string(tx) + ", " + std::to_string(ty) + ") dirty flag is wrong";
+			}
+		}
+	}
+	const std::vector<Changes::Point> *lists[][2] = {{&changes.get_born(), &born}, {&changes.get_died(), &died}};
+	for (const auto &list : lists) {
+		if (list[0]->size() != list[1]->size()) {
+			return std::to_string(list[0]->size()) + " cells listed, expected " + std::to_string(list[1]->size());
+		}
+		for (std::size_t i = 0; i < list[1]->size(); i++) {
+			if ((*list[0])[i].x != (*list[1])[i].x || (*list[0])[i].y != (*list[1])[i].y) {
+				return "cell " + std::to_string(i) + " listed at (" + std::to_string((*list[0])[i].x) + ", "
+					   + std::to_string((*list[0])[i].y) + ")";
+			}
+		}
+	}
+	return std::string();
+}
+
+/**
+ * Check the change sets recorded by the member step and the threaded bit-packed kernel for the first generations
+ * of a case, against the changes found by comparing every cell. Tiles of 24 cells do not line up with 64 cell words.
+ * @param run - The case, at generation 0.
+ * @param label - How to refer to the case in a report.
+ * @param generations - The number of generations to check, at most 8 are.
+ * @return True if every change set matched.
+ */
+static bool check_change_sets(const Case &run, const std::string &label, const int generations) {
+	World world(run.grid);
+	Changes::Set world_changes(24);
+	world.set_changes(&world_changes);
+	BitGrid current(run.grid), next;
+	Changes::Set bits_changes(24);
+
+	for (int generation = 1; generation <= std::min(generations, 8); generation++) {
+		const Grid before = world.get_state();
+		world.step(run.toroidal);
+		BitWorld::step(current, next, run.toroidal, 4, nullptr, &bits_changes);
+		std::swap(current, next);
+
+		const std::string world_difference = compare_changes(world_changes, before, world.get_state());
+		const std::string bits_difference = compare_changes(bits_changes, before, Grid(current));
+		if (!world_difference.empty() || !bits_difference.empty()) {
+			std::cout << "FAIL " << label << " (" << run.description << "): change set of generation " << generation
+					  << " " << (world_difference.empty() ? "bits " + bits_difference : "world " + world_difference)
+					  << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Run a case on every engine which can take it, comparing each with the reference after every generation.
+ * An engine which diverges is reported at its first differing cell and dropped from the rest of the case.
+ * @param engines - The engines, the first is the reference.
+ * @param run - The case.
+ * @param label - How to refer to the case in a report.
+ * @param generations - The number of generations to step.
+ * @return True if every engine matched the reference for every generation.
+ */
+static bool run_case(std::vector<Engine> &engines, const Case &run, const std::string &label, const int generations) {
+	const std::uint64_t cells = static_cast<std::uint64_t>(run.grid.get_width()) * run.grid.get_height();
+
+	std::vector<std::unique_ptr<Runner>> runners;
+	for (Engine &engine : engines) {
+		runners.push_back(engine.start(run.grid, run.toroidal));
+	}
+
+	bool passed = true;
+	for (int generation = 0; generation <= generations; generation++) {
+		if (generation > 0) {
+			for (std::size_t e = 0; e < engines.size(); e++) {
+				if (!runners[e]) {
+					continue;
+				}
+				const auto start = std::chrono::steady_clock::now();
+				runners[e]->step();
+				const auto end = std::chrono::steady_clock::now();
+				engines[e].seconds += std::chrono::duration<double>(end - start).count();
+				engines[e].steps++;
+				engines[e].cells += cells;
+			}
+		}
+
+		const Runner &reference = *runners[0];
+		const std::uint64_t expected = reference.hash();
+		for (std::size_t e = 1; e < engines.size(); e++) {
+			if (!runners[e] || runners[e]->hash() == expected) {
+				continue;
+			}
+
+			std::cout << "FAIL " << label << " (" << run.description << "): " << engines[e].name
+					  << " diverged from " << engines[0].name << " at generation " << generation;
+			for (int y = 0; y < run.grid.get_height(); y++) {
+				int x = 0;
+				while (x < run.grid.get_width() && runners[e]->get(x, y) == reference.get(x, y)) {
+					x++;
+				}
+				if (x < run.grid.get_width()) {
+					std::cout << ", first at (" << x << ", " << y << ") expected '"
+							  << static_cast<char>(reference.get(x, y)) << "' got '"
+							  << static_cast<char>(runners[e]->get(x, y)) << "'";
+					break;
+				}
+			}
+			std::cout << std::endl;
+
+			engines[e].failures++;
+			runners[e].reset();
+			passed = false;
+		}
+	}
+	const bool cones_passed = check_light_cones(run, label, generations, *runners[0]);
+	const bool changes_passed = check_change_sets(run, label, generations);
+	return cones_passed && changes_passed && passed;
+}
+
+/**
+ * Check that a request to a daemon fails with a message starting as expected.
+ * @param what - How to refer to the request in a report.
+ * @param expected - The start of the message.
+ * @param request - Makes the request.
+ * @return True if the request failed with that message.
+ */
+template <typename Request>
+static bool expect_error(const std::string &what, const std::string &expected, const Request &request) {
+	try {
+		request();
+	}
+	catch (const std::exception &ex) {
+		if (std::string(ex.what()).compare(0, expected.size(), expected) == 0) {
+			return true;
+		}
+		std::cout << "FAIL daemon: " << what << " failed with \"" << ex.what() << "\", expected \"" << expected
+				  << "\"" << std::endl;
+		return false;
+	}
+	std::cout << "FAIL daemon: " << what << " succeeded, expected \"" << expected << "\"" << std::endl;
+	return false;
+}
+
+/**
+ * Check that a resident world has the size and generation expected, and the cells of the reference engine.
+ * @param client - The connection to the daemon.
+ * @param id - The world.
+ * @param expected - The reference engine's state.
+ * @param generation - The generation the world should be at.
+ * @param what - How to refer to the check in a report.
+ * @return True if the world matched.
+ */
+static bool expect_world(Server::Client &client, const std::uint32_t id, const Grid &expected,
+						 const std::uint64_t generation, const std::string &what) {
+	const Server::Info info = client.info(id);
+	BitGrid region;
+	client.query(id, 0, 0, info.width, info.height, region);
+	if (info.width != expected.get_width() || info.height != expected.get_height() || info.generation != generation ||
+		info.population != expected.get_alive_cells() || Grid(region).hash() != expected.hash()) {
+		std::cout << "FAIL daemon: " << what << " left world " << id << " " << info.width << "x" << info.height
+				  << " at generation " << info.generation << " with " << info.population << " alive, expected "
+				  << expected.get_width() << "x" << expected.get_height() << " at generation " << generation
+				  << " with " << expected.get_alive_cells() << " alive" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Fork a daemon and drive it through a client: load, advance and query worlds against the reference engine,
+ * then send requests which must be rejected, checking each leaves the resident worlds as they were.
+ * @param seed - Seeds the soup loaded into the daemon.
+ * @return True if every response was as expected.
+ */
+static bool check_daemon(const std::uint64_t seed) {
+	const std::string path = "/tmp/Game_of_Life_fuzz." + std::to_string(getpid()) + ".sock";
+	const pid_t daemon = fork();
+	if (daemon < 0) {
+		std::cout << "FAIL daemon: cannot fork" << std::endl;
+		return false;
+	}
+	if (daemon == 0) {
+		Server::Options options;
+		options.threads = 4;
+		options.max_message = 1 << 20;
+		try {
+			Server::serve(path, options);
+		}
+		catch (const std::exception &ex) {
+			std::cerr << ex.what() << std::endl;
+			_exit(1);
+		}
+		_exit(0);
+	}
+
+	bool passed = true;
+	try {
+		// The daemon makes its socket file once it is listening
+		std::unique_ptr<Server::Client> connection;
+		for (int attempt = 0; !connection; attempt++) {
+			try {
+				connection.reset(new Server::Client(path));
+			}
+			catch (const std::exception &) {
+				if (attempt == 500) {
+					throw;
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+		Server::Client &client = *connection;
+
+		// A soup tall enough to be stepped in bands, loaded as .bgol and stepped toroidally
+		std::mt19937_64 rng(seed);
+		Grid soup(150, 300);
+		fill(soup, RANDOM, 0.3, rng);
+		World reference(soup);
+		client.load(1, soup);
+		passed &= expect_world(client, 1, reference.get_state(), 0, "LOAD");
+		client.advance(1, 20, true);
+		reference.advance(20, true);
+		passed &= expect_world(client, 1, reference.get_state(), 20, "ADVANCE");
+
+		// Long enough to be stepped in several turns
+		client.advance(1, 1000, true);
+		reference.advance(1000, true);
+		passed &= expect_world(client, 1, reference.get_state(), 1020, "an ADVANCE of several turns");
+
+		// A glider loaded as .rle and stepped bounded
+		Grid start(15, 15);
+		start.merge(Grid(Zoo::glider()), 1, 0);
+		World glider(start);
+		client.load_rle(2, "#C A glider\nx = 15, y = 15, rule = B3/S23\n2bo$3bo$b3o!\n");
+		passed &= expect_world(client, 2, glider.get_state(), 0, "LOAD_RLE");
+		client.advance(2, 12);
+		glider.advance(12);
+		passed &= expect_world(client, 2, glider.get_state(), 12, "ADVANCE of an .rle world");
+		client.set_rule(2, "B3/S23");
+
+		// Rejected loads neither make a world nor change one
+		passed &= expect_error("LOAD_RLE of another rule", Zoo::unsupported_rule_error, [&client]() {
+			client.load_rle(3, "x = 3, y = 3, rule = B36/S23\nbo$2bo$3o!\n");
+		});
+		passed &= expect_error("INFO after a failed LOAD_RLE", Server::unknown_world_error, [&client]() {
+			client.info(3);
+		});
+		passed &= expect_error("LOAD_RLE of a row too wide", Zoo::rle_row_too_long_error, [&client]() {
+			client.load_rle(2, "x = 2, y = 2\n3o!\n");
+		});
+		passed &= expect_error("LOAD_RLE of too many cells", Zoo::rle_too_many_cells_error, [&client]() {
+			client.load_rle(2, "x = 100000, y = 100000\no!\n");
+		});
+		passed &= expect_world(client, 2, glider.get_state(), 12, "a failed LOAD_RLE");
+		const std::string truncated = path + ".bgol";
+		std::vector<unsigned char> bytes;
+		Zoo::encode_binary(GridView(soup), bytes);
+		std::ofstream(truncated, std::ios::binary).write(reinterpret_cast<const char *>(bytes.data()),
+														 static_cast<std::streamsize>(bytes.size() / 2));
+		passed &= expect_error("LOAD_FILE of half a file", Zoo::file_ends_unexpectedly_error, [&client, &truncated]() {
+			client.load_file(1, truncated);
+		});
+		std::remove(truncated.c_str());
+		passed &= expect_world(client, 1, reference.get_state(), 1020, "a failed LOAD_FILE");
+
+		// Requests for worlds which are not loaded, and rules which cannot be stepped
+		passed &= expect_error("SET_RULE of another rule", Zoo::unsupported_rule_error, [&client]() {
+			client.set_rule(2, "B36/S23");
+		});
+		passed &= expect_error("ADVANCE of no world", Server::unknown_world_error, [&client]() {
+			client.advance(4, 1);
+		});
+		passed &= expect_error("LOAD_FILE of no file", Zoo::file_cannot_be_opened_error, [&client]() {
+			client.load_file(4, "/nonexistent/pattern.rle");
+		});
+		passed &= expect_error("QUERY after a failed LOAD_FILE", Server::unknown_world_error, [&client]() {
+			BitGrid region;
+			client.query(4, 0, 0, 1, 1, region);
+		});
+		client.drop(2);
+		passed &= expect_error("INFO after DROP", Server::unknown_world_error, [&client]() {
+			client.info(2);
+		});
+		passed &= expect_world(client, 1, reference.get_state(), 1020, "the failed requests");
+
+		client.shutdown();
+	}
+	catch (const std::exception &ex) {
+		std::cout << "FAIL daemon: " << ex.what() << std::endl;
+		passed = false;
+		kill(daemon, SIGTERM);
+	}
+
+	int status = 0;
+	waitpid(daemon, &status, 0);
+	if (passed && !(WIFEXITED(status) && WEXITSTATUS(status) == 0)) {
+		std::cout << "FAIL daemon: did not shut down cleanly" << std::endl;
+		passed = false;
+	}
+	return passed;
+}
+
+/**
+ * Print the steps, cells and throughput of every engine.
+ * @param engines - The engines with their totals.
+ */
+static void report(const std::vector<Engine> &engines) {
+	std::cout << std::left << std::setw(16) << "engine" << std::right
+			  << std::setw(10) << "steps"
+			  << std::setw(14) << "cells"
+			  << std::setw(12) << "seconds"
+			  << std::setw(12) << "Mcells/s"
+			  << std::setw(10) << "failures" << std::endl;
+	for (const Engine &engine : engines) {
+		std::cout << std::left << std::setw(16) << engine.name << std::right
+				  << std::setw(10) << engine.steps
+				  << std::setw(14) << engine.cells
+				  << std::setw(12) << std::fixed << std::setprecision(3) << engine.seconds
+				  << std::setw(12) << std::setprecision(1) << (engine.seconds > 0 ? engine.cells / engine.seconds / 1e6 : 0)
+				  << std::setw(10) << engine.failures << std::endl;
+	}
+}
+
+int main(int argc, char *argv[]) {
+	std::uint64_t seed = 1;
+	int cases = 200;
+	int generations = 64;
+	int only_case = -1;
+	int bench_size = 0;
+	for (int i = 1; i < argc; i++) {
+		const std::string argument = argv[i];
+		if (argument == "--seed" && i + 1 < argc) {
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		} else if (argument == "--cases" && i + 1 < argc) {
+			cases = std::atoi(argv[++i]);
+		} else if (argument == "--generations" && i + 1 < argc) {
+			generations = std::atoi(argv[++i]);
+		} else if (argument == "--case" && i + 1 < argc) {
+			only_case = std::atoi(argv[++i]);
+		} else if (argument == "--bench" && i + 1 < argc) {
+			bench_size = std::atoi(argv[++i]);
+		} else {
+			std::cerr << "Usage: " << argv[0]
+					  << " [--seed n] [--cases n] [--generations n] [--case n] [--bench size]" << std::endl;
+			return -1;
+		}
+	}
+
+	std::vector<Engine> engines = make_engines();
+	unsigned int failed = 0;
+	unsigned int ran = 0;
+
+	if (bench_size > 0) {
+		std::mt19937_64 rng(seed);
+		Case soup = {"", Grid(bench_size, bench_size), false};
+		soup.description = fill(soup.grid, RANDOM, 0.3, rng) + " " + std::to_string(bench_size) + "x"
+						   + std::to_string(bench_size) + " bounded";
+		failed += !run_case(engines, soup, "bench", generations);
+		ran++;
+	} else {
+		const int first = only_case >= 0 ? only_case : 0;
+		const int end = only_case >= 0 ? only_case + 1 : adversarial_cases + cases;
+		for (int index = first; index < end; index++) {
+			std::stringstream label;
+			label << "--seed " << seed << " --case " << index;
+			failed += !run_case(engines, make_case(seed, index), label.str(), generations);
+			ran++;
+		}
+	}
+
+	const bool check_the_daemon = bench_size == 0 && only_case < 0;
+	const bool daemon_passed = !check_the_daemon || check_daemon(seed);
+
+	report(engines);
+	std::cout << (ran - failed) << " of " << ran << " cases matched " << engines[0].name
+			  << " for " << generations << " generations" << std::endl;
+	if (check_the_daemon) {
+		std::cout << "The daemon " << (daemon_passed ? "answered every request as expected" : "failed") << std::endl;
+	}
+
+	return failed == 0 && daemon_passed ? 0 : -1;
+}
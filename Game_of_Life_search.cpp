@@ -0,0 +1,97 @@
+/**
+ * Searches random soups in process on every core, and censuses what each one settles into.
+ * i.e.
+ * ./Game_of_Life_search --soups 100000
+ * ./Game_of_Life_search --seed 7 --soups 1000000 --output soups.csv
+ *
+ * Each soup is a square of random cells in the centre of a dead world, stepped until a state repeats.
+ * Any soup can be rerun alone from its seed and number, e.g. --seed 7 --first 4242 --soups 1.
+ *
+ * Options:
+ *      --seed n            Seed the soups with n. Defaults to 1.
+ *      --first n           The number of the first soup. Defaults to 0.
+ *      --soups n           The number of soups to run. Defaults to 10000.
+ *      --soup-size n       The edge of the random square. Defaults to 16.
+ *      --world-size n      The edge of the world the soup is placed in. Defaults to 128.
+ *      --density d         The chance of each soup cell being alive. Defaults to 0.5.
+ *      --generations n     Give up on a soup which has not settled after n generations. Defaults to 10000.
+ *      --period n          The longest cycle looked for when deciding a soup has settled. Defaults to 30.
+ *      --toroidal          Wrap the world, so escaping spaceships are never destroyed at the edge.
+ *      --threads n         Run n soups at once, 0 uses every core. Defaults to 0.
+ *      --output path       Stream one CSV line per soup to path, in soup order.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "soup.h"
+
+int main(int argc, char *argv[]) {
+	Soup::Options options;
+	std::uint64_t first = 0;
+	std::uint64_t soups = 10000;
+	std::string output_path;
+	for (int i = 1; i < argc; i++) {
+		const std::string argument = argv[i];
+		if (argument == "--seed" && i + 1 < argc) {
+			options.seed = std::strtoull(argv[++i], nullptr, 10);
+		} else if (argument == "--first" && i + 1 < argc) {
+			first = std::strtoull(argv[++i], nullptr, 10);
+		} else if (argument == "--soups" && i + 1 < argc) {
+			soups = std::strtoull(argv[++i], nullptr, 10);
+		} else if (argument == "--soup-size" && i + 1 < argc) {
+			options.soup_size = std::atoi(argv[++i]);
+		} else if (argument == "--world-size" && i + 1 < argc) {
+			options.world_size = std::atoi(argv[++i]);
+		} else if (argument == "--density" && i + 1 < argc) {
+			options.density = std::atof(argv[++i]);
+		} else if (argument == "--generations" && i + 1 < argc) {
+			options.max_generations = std::atoi(argv[++i]);
+		} else if (argument == "--period" && i + 1 < argc) {
+			options.max_period = std::atoi(argv[++i]);
+		} else if (argument == "--toroidal") {
+			options.toroidal = true;
+		} else if (argument == "--threads" && i + 1 < argc) {
+			options.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+		} else if (argument == "--output" && i + 1 < argc) {
+			output_path = argv[++i];
+		} else {
+			std::cerr << "Usage: " << argv[0] << " [--seed n] [--first n] [--soups n] [--soup-size n] [--world-size n]"
+					  << " [--density d] [--generations n] [--period n] [--toroidal] [--threads n] [--output path]"
+					  << std::endl;
+			return -1;
+		}
+	}
+
+	std::unique_ptr<std::ofstream> output;
+	if (!output_path.empty()) {
+		output.reset(new std::ofstream(output_path));
+		if (!*output) {
+			std::cerr << "File cannot be opened: " << output_path << std::endl;
+			return -1;
+		}
+	}
+
+	try {
+		const auto start = std::chrono::steady_clock::now();
+		const Soup::Summary summary = Soup::search(options, first, soups, output.get());
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << summary;
+		std::cout << "Searched " << summary.soups << " soups in " << seconds << " s | "
+				  << (seconds > 0 ? summary.soups / seconds : 0) << " soups/s" << std::endl;
+	}
+	catch (const std::exception &ex) {
+		std::cerr << ex.what() << std::endl;
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,596 @@
+/**
+ * Implements a Memory namespace with the allocation policies that Grid storage can be drawn from.
+ *      - Each policy is a Resource which hands out raw memory.
+ *          - Policy::DEFAULT uses global operator new.
+ *          - Policy::ALIGNED aligns every buffer to 64 bytes, so rows can be loaded with aligned SIMD instructions.
+ *          - Policy::HUGE_PAGES maps buffers of 2 MiB or more directly from the kernel aligned to 2 MiB and
+ *            advises it to back them with transparent huge pages, smaller buffers are only aligned.
+ *          - Policy::ARENA bumps through large chunks and never frees a single buffer,
+ *            the chunks are reused once every buffer in the arena has been freed.
+ *          - Policy::POOL is the default. Each thread keeps the buffers it frees in buckets by size,
+ *            so the next grid of a similar size reuses one instead of going to the system.
+ *              - Buckets are a quarter of a power of two apart, wasting at most a fifth of a buffer.
+ *              - Buffers over 16 MiB are never pooled, and each thread keeps at most 64 MiB.
+ *              - A buffer may be freed on a different thread to the one it came from, it joins that thread's pool.
+ *
+ *      - Memory::move_to_local_node(begin, bytes) migrates the pages of part of a buffer to the NUMA node of the
+ *        calling thread, whichever policy the buffer came from. The pages have usually been touched already,
+ *        by zeroing or copying the grid, so they are moved where they are rather than placed by first touch.
+ *
+ *      - Memory::Allocator<T> adapts a Resource for standard containers.
+ *          - A default constructed allocator uses the default policy, which can be changed at any time.
+ *            Buffers that were already allocated stay with the resource they came from.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "allocator.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Transparent huge pages are 2 MiB on x86-64 and most arm64 kernels
+static const std::size_t huge_page_size = std::size_t(2) << 20;
+
+// Arena chunks are at least this big, larger requests get a chunk of their own size
+static const std::size_t arena_chunk_size = std::size_t(64) << 20;
+
+// Largest buffer the pool keeps, a 4096x4096 grid
+static const std::size_t pool_max_buffer = std::size_t(16) << 20;
+
+// Most bytes each thread's pool keeps before freeing buffers back to the system
+static const std::size_t pool_max_cached = std::size_t(64) << 20;
+
+// Pages passed to each move_pages call by Memory::move_to_local_node
+static const unsigned long move_batch = 512;
+
+// Buckets from 64 bytes up to pool_max_buffer, four per power of two
+static const std::size_t pool_buckets = 4 * (24 - 6) + 1;
+
+/**
+ * Round a size up to a multiple of a power of two.
+ * @param bytes - The size to round.
+ * @param multiple - The power of two to round to.
+ * @return The rounded size.
+ */
+static std::size_t round_up(const std::size_t bytes, const std::size_t multiple) {
+	return (bytes + multiple - 1) & ~(multiple - 1);
+}
+
+/**
+ * Policy::DEFAULT, plain global operator new.
+ */
+class DefaultResource : public Memory::Resource {
+public:
+	void *allocate(const std::size_t bytes) override {
+		return ::operator new(bytes);
+	}
+
+	void deallocate(void *pointer, const std::size_t) override {
+		::operator delete(pointer);
+	}
+
+	Memory::Policy policy() const override {
+		return Memory::Policy::DEFAULT;
+	}
+};
+
+/**
+ * Policy::ALIGNED, global operator new with 64 byte alignment.
+ */
+class AlignedResource : public Memory::Resource {
+public:
+	void *allocate(const std::size_t bytes) override {
+		return ::operator new(bytes, std::align_val_t(Memory::alignment));
+	}
+
+	void deallocate(void *pointer, const std::size_t) override {
+		::operator delete(pointer, std::align_val_t(Memory::alignment));
+	}
+
+	Memory::Policy policy() const override {
+		return Memory::Policy::ALIGNED;
+	}
+};
+
+/**
+ * Policy::HUGE_PAGES, buffers of a huge page or more are mapped from the kernel aligned to a huge page
+ * and marked with MADV_HUGEPAGE. Smaller buffers, and every buffer off Linux, fall back to 64 byte alignment.
+ */
+class HugePageResource : public Memory::Resource {
+private:
+	AlignedResource small;
+
+public:
+	void *allocate(const std::size_t bytes) override {
+#if defined(__linux__)
+		if (bytes >= huge_page_size) {
+			const std::size_t size = round_up(bytes, huge_page_size);
+
+			// Over-map by one huge page then trim, so the buffer starts on a huge page boundary
+			void *mapping = mmap(nullptr, size + huge_page_size, PROT_READ | PROT_WRITE,
+								 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (mapping == MAP_FAILED) {
+				throw std::bad_alloc();
+			}
+			char *start = static_cast<char *>(mapping);
+			char *aligned = reinterpret_cast<char *>(round_up(reinterpret_cast<std::size_t>(start), huge_page_size));
+			if (aligned > start) {
+				munmap(start, aligned - start);
+			}
+			const std::size_t tail = (start + size + huge_page_size) - (aligned + size);
+			if (tail > 0) {
+				munmap(aligned + size, tail);
+			}
+
+			madvise(aligned, size, MADV_HUGEPAGE);
+			return aligned;
+		}
+#endif
+		return small.allocate(bytes);
+	}
+
+	void deallocate(void *pointer, const std::size_t bytes) override {
+#if defined(__linux__)
+		if (bytes >= huge_page_size) {
+			munmap(pointer, round_up(bytes, huge_page_size));
+			return;
+		}
+#endif
+		small.deallocate(pointer, bytes);
+	}
+
+	Memory::Policy policy() const override {
+		return Memory::Policy::HUGE_PAGES;
+	}
+};
+
+/**
+ * Policy::ARENA, a thread safe bump allocator over chunks drawn from the huge page resource.
+ * Freeing a buffer only counts it off. When the count reaches zero every chunk is reused from the start.
+ */
+class ArenaResource : public Memory::Resource {
+private:
+	struct Chunk {
+		char *start;
+		std::size_t size;
+	};
+
+	HugePageResource upstream;
+	std::mutex lock;
+	std::vector<Chunk> chunks;
+	std::size_t current = 0;
+	std::size_t offset = 0;
+	std::size_t outstanding = 0;
+
+public:
+	~ArenaResource() override {
+		for (const Chunk &chunk : chunks) {
+			upstream.deallocate(chunk.start, chunk.size);
+		}
+	}
+
+	void *allocate(const std::size_t bytes) override {
+		const std::size_t size = round_up(bytes == 0 ? 1 : bytes, Memory::alignment);
+		std::lock_guard<std::mutex> guard(lock);
+
+		// Move on to the next chunk which has room, adding one if none do
+		while (current < chunks.size() && offset + size > chunks[current].size) {
+			current++;
+			offset = 0;
+		}
+		if (current == chunks.size()) {
+			const std::size_t chunk_size = std::max(arena_chunk_size, round_up(size, huge_page_size));
+			chunks.push_back(Chunk{static_cast<char *>(upstream.allocate(chunk_size)), chunk_size});
+			offset = 0;
+		}
+
+		void *pointer = chunks[current].start + offset;
+		offset += size;
+		outstanding++;
+		return pointer;
+	}
+
+	void deallocate(void *, const std::size_t) override {
+		std::lock_guard<std::mutex> guard(lock);
+		outstanding--;
+		if (outstanding == 0) {
+			current = 0;
+			offset = 0;
+		}
+	}
+
+	Memory::Policy policy() const override {
+		return Memory::Policy::ARENA;
+	}
+};
+
+/**
+ * Index of the highest set bit.
+ * @param value - A non zero value.
+ * @return The bit index.
+ */
+static int top_bit(std::size_t value) {
+	int bit = 0;
+	while (value >>= 1) {
+		bit++;
+	}
+	return bit;
+}
+
+/**
+ * Round a buffer size up to its pool bucket, the next 64, 80, 96, 112, 128, 160 ... bytes.
+ * @param bytes - The requested size.
+ * @param bucket - Set to the index of the bucket.
+ * @return The size of buffers in the bucket.
+ */
+static std::size_t bucket_size(const std::size_t bytes, std::size_t &bucket) {
+	if (bytes <= 64) {
+		bucket = 0;
+		return 64;
+	}
+	const std::size_t step = std::size_t(1) << (top_bit(bytes - 1) - 2);
+	const std::size_t size = round_up(bytes, step);
+	const int bit = top_bit(size);
+	bucket = (bit - 6) * 4 + ((size >> (bit - 2)) & 3);
+	return size;
+}
+
+// Pool counters shared by every thread
+static std::atomic<std::uint64_t> pool_hits(0);
+static std::atomic<std::uint64_t> pool_misses(0);
+static std::atomic<std::uint64_t> pool_recycled(0);
+static std::atomic<std::uint64_t> pool_released(0);
+
+// Set once the calling thread's pool has been destroyed, so buffers freed later by static destructors bypass it
+static thread_local bool pool_destroyed = false;
+
+/**
+ * The free buffers of one thread, freed back to the system when the thread exits.
+ */
+class ThreadPool {
+private:
+	AlignedResource upstream;
+	std::array<std::vector<void *>, pool_buckets> buckets;
+	std::size_t cached = 0;
+
+public:
+	~ThreadPool() {
+		trim();
+		pool_destroyed = true;
+	}
+
+	void *allocate(const std::size_t bytes) {
+		if (bytes > pool_max_buffer) {
+			pool_misses.fetch_add(1, std::memory_order_relaxed);
+			return upstream.allocate(bytes);
+		}
+
+		std::size_t bucket;
+		const std::size_t size = bucket_size(bytes, bucket);
+		std::vector<void *> &free = buckets[bucket];
+		if (!free.empty()) {
+			void *pointer = free.back();
+			free.pop_back();
+			cached -= size;
+			pool_hits.fetch_add(1, std::memory_order_relaxed);
+			return pointer;
+		}
+
+		pool_misses.fetch_add(1, std::memory_order_relaxed);
+		return upstream.allocate(size);
+	}
+
+	void deallocate(void *pointer, const std::size_t bytes) {
+		if (bytes <= pool_max_buffer) {
+			std::size_t bucket;
+			const std::size_t size = bucket_size(bytes, bucket);
+			if (cached + size <= pool_max_cached) {
+				buckets[bucket].push_back(pointer);
+				cached += size;
+				pool_recycled.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+		}
+
+		pool_released.fetch_add(1, std::memory_order_relaxed);
+		upstream.deallocate(pointer, bytes);
+	}
+
+	void trim() {
+		for (std::vector<void *> &free : buckets) {
+			for (void *pointer : free) {
+				upstream.deallocate(pointer, 0);
+			}
+			free.clear();
+		}
+		cached = 0;
+	}
+};
+
+/**
+ * The pool of the calling thread.
+ * @return The thread local pool.
+ */
+static ThreadPool &thread_pool() {
+	static thread_local ThreadPool pool;
+	return pool;
+}
+
+/**
+ * Policy::POOL, thread local size buckets of recently freed buffers in front of the aligned resource.
+ */
+class PoolResource : public Memory::Resource {
+private:
+	AlignedResource upstream;
+
+public:
+	void *allocate(const std::size_t bytes) override {
+		if (pool_destroyed) {
+			return upstream.allocate(bytes);
+		}
+		return thread_pool().allocate(bytes);
+	}
+
+	void deallocate(void *pointer, const std::size_t bytes) override {
+		if (pool_destroyed) {
+			upstream.deallocate(pointer, bytes);
+			return;
+		}
+		thread_pool().deallocate(pointer, bytes);
+	}
+
+	Memory::Policy policy() const override {
+		return Memory::Policy::POOL;
+	}
+};
+
+/**
+ * Memory::resource(policy)
+ *
+ * Gets the shared resource implementing a policy.
+ * Resources live for the whole program so buffers can outlive any scope.
+ *
+ * @example
+ *
+ *      // Make a grid backed by huge pages regardless of the default policy
+ *      Grid grid(8192, 8192, Memory::Policy::HUGE_PAGES);
+ *
+ * @param policy
+ *      The allocation policy.
+ *
+ * @return
+ *      The resource for the policy.
+ */
+Memory::Resource *Memory::resource(const Policy policy) {
+	// Leaked on purpose, grids in static storage may free into them during shutdown
+	static DefaultResource *default_resource = new DefaultResource();
+	static AlignedResource *aligned_resource = new AlignedResource();
+	static HugePageResource *huge_page_resource = new HugePageResource();
+	static ArenaResource *arena_resource = new ArenaResource();
+	static PoolResource *pool_resource = new PoolResource();
+
+	switch (policy) {
+		case Policy::DEFAULT:
+			return default_resource;
+		case Policy::ALIGNED:
+			return aligned_resource;
+		case Policy::HUGE_PAGES:
+			return huge_page_resource;
+		case Policy::ARENA:
+			return arena_resource;
+		case Policy::POOL:
+			return pool_resource;
+	}
+	return default_resource;
+}
+
+/**
+ * The resource used by default constructed allocators.
+ * @return The atomic holding the default resource.
+ */
+static std::atomic<Memory::Resource *> &current_default() {
+	static std::atomic<Memory::Resource *> current(Memory::resource(Memory::Policy::POOL));
+	return current;
+}
+
+/**
+ * Memory::default_resource()
+ *
+ * @return The resource used by default constructed allocators.
+ */
+Memory::Resource *Memory::default_resource() {
+	return current_default().load(std::memory_order_relaxed);
+}
+
+/**
+ * Memory::set_default_policy(policy)
+ *
+ * Change the policy used for every buffer allocated from now on without an explicit policy.
+ *
+ * @example
+ *
+ *      // Back every new Grid with huge pages
+ *      Memory::set_default_policy(Memory::Policy::HUGE_PAGES);
+ *
+ * @param policy
+ *      The new default allocation policy.
+ */
+void Memory::set_default_policy(const Policy policy) {
+	current_default().store(resource(policy), std::memory_order_relaxed);
+}
+
+/**
+ * Memory::get_default_policy()
+ *
+ * @return The policy used for buffers allocated without an explicit policy.
+ */
+Memory::Policy Memory::get_default_policy() {
+	return default_resource()->policy();
+}
+
+/**
+ * Memory::parse_policy(name)
+ *
+ * Parse the name of a policy as given on the command line.
+ *
+ * @param name
+ *      One of "default", "aligned", "hugepage", "arena" or "pool".
+ *
+ * @return
+ *      The named policy.
+ *
+ * @throws
+ *      std::invalid_argument if the name is not a policy.
+ */
+Memory::Policy Memory::parse_policy(const std::string &name) {
+	for (const Policy policy : {Policy::DEFAULT, Policy::ALIGNED, Policy::HUGE_PAGES, Policy::ARENA, Policy::POOL}) {
+		if (name == policy_name(policy)) {
+			return policy;
+		}
+	}
+	throw std::invalid_argument(unknown_policy_error + name);
+}
+
+/**
+ * Memory::policy_name(policy)
+ *
+ * @param policy - The allocation policy.
+ * @return The name of the policy as accepted by Memory::parse_policy(name).
+ */
+std::string Memory::policy_name(const Policy policy) {
+	switch (policy) {
+		case Policy::DEFAULT:
+			return "default";
+		case Policy::ALIGNED:
+			return "aligned";
+		case Policy::HUGE_PAGES:
+			return "hugepage";
+		case Policy::ARENA:
+			return "arena";
+		case Policy::POOL:
+			return "pool";
+	}
+	return "default";
+}
+
+/**
+ * Memory::pool_statistics()
+ *
+ * Gets the pool counters summed over every thread since the program started or the counters were reset.
+ *
+ * @example
+ *
+ *      // See how often cropping reused a buffer
+ *      Memory::reset_pool_statistics();
+ *      for (int i = 0; i < 1000; i++) {
+ *          Grid part = grid.crop(0, 0, 64, 64);
+ *      }
+ *      std::cout << Memory::pool_statistics().hits << std::endl;
+ *
+ * @return
+ *      The pool counters.
+ */
+Memory::PoolStatistics Memory::pool_statistics() {
+	PoolStatistics statistics;
+	statistics.hits = pool_hits.load(std::memory_order_relaxed);
+	statistics.misses = pool_misses.load(std::memory_order_relaxed);
+	statistics.recycled = pool_recycled.load(std::memory_order_relaxed);
+	statistics.released = pool_released.load(std::memory_order_relaxed);
+	return statistics;
+}
+
+/**
+ * Memory::reset_pool_statistics()
+ *
+ * Set every pool counter back to zero.
+ */
+void Memory::reset_pool_statistics() {
+	pool_hits.store(0, std::memory_order_relaxed);
+	pool_misses.store(0, std::memory_order_relaxed);
+	pool_recycled.store(0, std::memory_order_relaxed);
+	pool_released.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * Memory::trim_pool()
+ *
+ * Free every buffer held by the calling thread's pool back to the system.
+ * Other threads keep their buffers until they exit or trim their own pool.
+ */
+void Memory::trim_pool() {
+	if (!pool_destroyed) {
+		thread_pool().trim();
+	}
+}
+
+/**
+ * Memory::move_to_local_node(begin, bytes)
+ *
+ * Move the whole pages within a range to the NUMA node of the calling thread, keeping their contents.
+ * The kernel migrates them in place with move_pages(2), so the range is never copied or dropped, and a
+ * transparent huge page stays huge and moves whole. Pages already on the node are left alone, as are
+ * pages the range only partly covers, since they hold other data.
+ * Neighbouring ranges, such as two bands of rows of one grid moved by their own threads, can share a page
+ * at their boundary. Each only partly covers it, so neither thread moves it and it stays where it was.
+ * The kernel copies each page not already on the node, so a grid is moved once before stepping, not every step.
+ * Does nothing where move_pages is not supported or not permitted, such as on kernels built without NUMA.
+ *
+ * @example
+ *
+ *      // Each thread moves its own half of a buffer
+ *      std::thread worker([&]() { Memory::move_to_local_node(cells + half, half); });
+ *      Memory::move_to_local_node(cells, half);
+ *      worker.join();
+ *
+ * @param begin
+ *      The start of the range, in private anonymous memory such as any Resource hands out.
+ *
+ * @param bytes
+ *      The length of the range.
+ */
+void Memory::move_to_local_node(void *begin, const std::size_t bytes) {
+#if defined(__linux__)
+	const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+	const std::uintptr_t start = round_up(reinterpret_cast<std::uintptr_t>(begin), page);
+	const std::uintptr_t stop = (reinterpret_cast<std::uintptr_t>(begin) + bytes) / page * page;
+	if (stop <= start) {
+		return;
+	}
+
+	unsigned int cpu = 0, node = 0;
+	if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+		return;
+	}
+
+	// Pages are moved a batch at a time, so no list of every page is allocated
+	void *pages[move_batch];
+	int nodes[move_batch];
+	int status[move_batch];
+	for (std::uintptr_t address = start; address < stop;) {
+		unsigned long count = 0;
+		for (; count < move_batch && address < stop; count++, address += page) {
+			pages[count] = reinterpret_cast<void *>(address);
+			nodes[count] = static_cast<int>(node);
+		}
+		if (syscall(SYS_move_pages, 0, count, pages, nodes, status, MPOL_MF_MOVE) < 0) {
+			return;
+		}
+	}
+#else
+	(void) begin;
+	(void) bytes;
+#endif
+}
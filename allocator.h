@@ -0,0 +1,130 @@
+/**
+ * Declares a Memory namespace with the allocation policies that Grid storage can be drawn from.
+ * Rich documentation for the api and behaviour the Memory namespace can be found in allocator.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/**
+ * Declare the interface of the Memory namespace for choosing where grid cells live.
+ */
+namespace Memory {
+
+	// Alignment of every buffer, one cache line and wide enough for any SIMD load
+	const std::size_t alignment = 64;
+
+	// Errors
+	const std::string unknown_policy_error = "Unknown allocator policy: ";
+
+	/**
+	 * The ways a buffer can be allocated.
+	 *      - DEFAULT uses global operator new.
+	 *      - ALIGNED uses 64 byte aligned allocations.
+	 *      - HUGE_PAGES backs large buffers with transparent huge pages to cut TLB misses.
+	 *      - ARENA carves buffers out of large shared chunks which are only returned when every buffer is freed.
+	 *      - POOL keeps freed buffers in thread local size buckets and hands them straight back out.
+	 */
+	enum class Policy {
+		DEFAULT,
+		ALIGNED,
+		HUGE_PAGES,
+		ARENA,
+		POOL
+	};
+
+	/**
+	 * Counters for the buffer pool, summed over every thread.
+	 *      - hits are allocations served from a bucket.
+	 *      - misses are allocations which had to go to the system.
+	 *      - recycled are frees kept in a bucket for reuse.
+	 *      - released are frees returned to the system because the buffer was too large or the pool was full.
+	 */
+	struct PoolStatistics {
+		std::uint64_t hits = 0;
+		std::uint64_t misses = 0;
+		std::uint64_t recycled = 0;
+		std::uint64_t released = 0;
+	};
+
+	/**
+	 * A source of raw memory implementing one policy.
+	 */
+	class Resource {
+	public:
+		virtual ~Resource() = default;
+		virtual void *allocate(std::size_t bytes) = 0;
+		virtual void deallocate(void *pointer, std::size_t bytes) = 0;
+		virtual Policy policy() const = 0;
+	};
+
+	Resource *resource(Policy policy);
+	Resource *default_resource();
+	void set_default_policy(Policy policy);
+	Policy get_default_policy();
+
+	Policy parse_policy(const std::string &name);
+	std::string policy_name(Policy policy);
+
+	PoolStatistics pool_statistics();
+	void reset_pool_statistics();
+	void trim_pool();
+
+	// Migrates pages which are already in use, so a buffer can follow the thread which works on it
+	void move_to_local_node(void *begin, std::size_t bytes);
+
+	/**
+	 * A standard library allocator which draws from a Resource.
+	 * The resource travels with a container when it is copied, moved or swapped,
+	 * so buffers are always returned to the resource they came from.
+	 */
+	template <typename T>
+	class Allocator {
+	private:
+		Resource *source;
+
+		template <typename U> friend class Allocator;
+
+	public:
+		typedef T value_type;
+		typedef std::true_type propagate_on_container_copy_assignment;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+		typedef std::false_type is_always_equal;
+
+		Allocator() : source(default_resource()) {}
+		explicit Allocator(Policy policy) : source(resource(policy)) {}
+		explicit Allocator(Resource *source) : source(source) {}
+		template <typename U> Allocator(const Allocator<U> &other) : source(other.source) {}
+
+		T *allocate(std::size_t n) {
+			return static_cast<T *>(source->allocate(n * sizeof(T)));
+		}
+
+		void deallocate(T *pointer, std::size_t n) {
+			source->deallocate(pointer, n * sizeof(T));
+		}
+
+		Resource *get_resource() const {
+			return source;
+		}
+
+		Policy policy() const {
+			return source->policy();
+		}
+
+		template <typename U> bool operator==(const Allocator<U> &other) const {
+			return source == other.source;
+		}
+
+		template <typename U> bool operator!=(const Allocator<U> &other) const {
+			return source != other.source;
+		}
+	};
+};
@@ -0,0 +1,420 @@
+/**
+ * Implements a Batch namespace for stepping many pattern files concurrently in one process.
+ *      - A manifest lists one job per line: an input .gol path, an output .gol path, a number of steps,
+ *        and optionally toroidal or bounded.
+ *          - Blank lines and lines starting with '#' are skipped. Paths cannot contain spaces.
+ *          - Relative paths are relative to the working directory, as they are for Game_of_Life.
+ *
+ *      - Jobs are packed into tasks before anything is stepped.
+ *          - The size of each job is read from the header line of its input, without loading the cells.
+ *          - Small jobs are sorted by size and packed together, so a worker steps a run of similar small worlds
+ *            back to back, reusing its buffers while they are still in cache.
+ *          - Large jobs are tasks of their own.
+ *
+ *      - Tasks are run on a work-stealing pool.
+ *          - Tasks are dealt out largest first, so the longest jobs start early.
+ *          - Each worker takes from the front of its own queue and, once that is empty, steals from the back
+ *            of another's, so the work evens out however unequal the jobs are.
+ *          - Worlds are loaded and saved bit-packed and stepped with the bit-packed kernel.
+ *
+ *      - Results are saved through the Zoo on separate I/O threads.
+ *          - Workers hand each stepped grid to a bounded queue and move straight on to the next job.
+ *          - A full queue makes the workers wait, so a slow disk cannot fill memory with unsaved grids.
+ *          - Each saved grid goes back to the free list of the worker which stepped it, and the worker loads its
+ *            next job into one from there. Grids are allocated and freed by their worker, so its buffers are
+ *            reused rather than freed into the caches of the I/O threads.
+ *
+ *      - A job which cannot be loaded or saved is reported as a failure, the rest of the batch carries on.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "batch.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "world.h"
+#include "zoo.h"
+
+// Grids waiting to be saved per I/O thread, before workers wait for the savers to catch up
+static const std::size_t saves_per_io_thread = 16;
+
+/**
+ * A run of jobs for one worker to step back to back.
+ */
+struct Task {
+	std::vector<std::size_t> jobs;
+	std::uint64_t cost = 0;
+};
+
+/**
+ * A worker's queue of tasks. The owner takes from the front and thieves take from the back.
+ */
+struct TaskQueue {
+	std::mutex lock;
+	std::deque<Task> tasks;
+};
+
+/**
+ * A stepped grid, the job it is the result of and the worker it goes back to once saved.
+ */
+struct Save {
+	std::size_t job;
+	unsigned int worker;
+	BitGrid grid;
+};
+
+/**
+ * A bounded queue of stepped grids waiting for an I/O thread to save them.
+ */
+struct SaveQueue {
+	std::mutex lock;
+	std::condition_variable not_empty;
+	std::condition_variable not_full;
+	std::deque<Save> grids;
+	std::size_t capacity = 0;
+	bool closed = false;
+};
+
+/**
+ * Saved grids waiting to be reused by the worker which stepped them.
+ */
+struct FreeList {
+	std::mutex lock;
+	std::vector<BitGrid> grids;
+};
+
+/**
+ * Read the width and height from the header of a .gol file to estimate the size of its job.
+ * @param path - The path of the file.
+ * @return The number of cells, or 0 if the header cannot be read, leaving the error for the load to report.
+ */
+static std::uint64_t read_cells(const std::string &path) {
+	std::ifstream input(path);
+	long long width = 0;
+	long long height = 0;
+	if (!(input >> width >> height) || width <= 0 || height <= 0) {
+		return 0;
+	}
+	return static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);
+}
+
+/**
+ * Batch::parse_manifest(input_stream)
+ *
+ * Read the jobs of a manifest from a stream.
+ *
+ * @example
+ *
+ *      # input            output               steps  topology
+ *      soups/0001.gol     results/0001.gol     1000   toroidal
+ *      soups/0002.gol     results/0002.gol     1000
+ *
+ * @param input_stream
+ *      The stream to read the manifest from.
+ *
+ * @return
+ *      The jobs in the order they are listed.
+ *
+ * @throws
+ *      Throws std::runtime_error if a line does not have an input, an output, a non-negative number of steps
+ *      and an optional toroidal or bounded, naming the line.
+ */
+std::vector<Batch::Job> Batch::parse_manifest(std::istream &input_stream) {
+	std::vector<Job> jobs;
+	std::string text;
+	int line = 0;
+	while (std::getline(input_stream, text)) {
+		line++;
+		std::istringstream fields(text);
+		Job job;
+		job.line = line;
+		if (!(fields >> job.input) || job.input[0] == '#') {
+			continue;
+		}
+
+		std::string topology = "bounded";
+		std::string extra;
+		if (!(fields >> job.output >> job.steps) || job.steps < 0) {
+			throw std::runtime_error(manifest_line_not_valid_error + std::to_string(line) + ": " + text);
+		}
+		fields >> topology;
+		if ((topology != "toroidal" && topology != "bounded") || (fields >> extra)) {
+			throw std::runtime_error(manifest_line_not_valid_error + std::to_string(line) + ": " + text);
+		}
+		job.toroidal = topology == "toroidal";
+		jobs.push_back(job);
+	}
+	return jobs;
+}
+
+/**
+ * Batch::load_manifest(path)
+ *
+ * Read the jobs of a manifest file, see Batch::parse_manifest(input_stream).
+ *
+ * @param path
+ *      The path to the manifest.
+ *
+ * @return
+ *      The jobs in the order they are listed.
+ *
+ * @throws
+ *      Throws std::runtime_error if the file cannot be opened or a line is not a valid job.
+ */
+std::vector<Batch::Job> Batch::load_manifest(const std::string &path) {
+	std::ifstream input(path);
+	if (!input) {
+		throw std::runtime_error(file_cannot_be_opened_error + path);
+	}
+	return parse_manifest(input);
+}
+
+/**
+ * Batch::run(jobs, options)
+ *
+ * Load, step and save every job on a pool of worker threads and I/O threads.
+ *
+ * @example
+ *
+ *      // Run a nightly manifest on every core
+ *      Batch::Report report = Batch::run(Batch::load_manifest("nightly.txt"));
+ *      std::cout << report;
+ *
+ * @param jobs
+ *      The jobs to run.
+ *
+ * @param options
+ *      Optional parameter. The number of worker and I/O threads and the size small jobs are packed to.
+ *
+ * @return
+ *      How many jobs completed, how long they took, and why any failed.
+ */
+Batch::Report Batch::run(const std::vector<Job> &jobs, const Options &options) {
+	const auto start = std::chrono::steady_clock::now();
+	Report report;
+	report.jobs = jobs.size();
+
+	// Pack small jobs in order of size, large jobs stand alone
+	std::vector<std::uint64_t> cells(jobs.size());
+	std::vector<std::size_t> order(jobs.size());
+	for (std::size_t i = 0; i < jobs.size(); i++) {
+		cells[i] = read_cells(jobs[i].input);
+		order[i] = i;
+	}
+	std::stable_sort(order.begin(), order.end(), [&cells](const std::size_t a, const std::size_t b) {
+		return cells[a] < cells[b];
+	});
+
+	std::vector<Task> tasks;
+	std::uint64_t packed_cells = 0;
+	for (const std::size_t i : order) {
+		if (tasks.empty() || cells[i] >= options.group_cells || packed_cells + cells[i] > options.group_cells) {
+			tasks.emplace_back();
+			packed_cells = 0;
+		}
+		tasks.back().jobs.push_back(i);
+		tasks.back().cost += std::max<std::uint64_t>(1, cells[i]) * (jobs[i].steps + 1);
+		packed_cells += cells[i];
+	}
+	std::stable_sort(tasks.begin(), tasks.end(), [](const Task &a, const Task &b) {
+		return a.cost > b.cost;
+	});
+	report.tasks = tasks.size();
+
+	unsigned int threads = options.threads;
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threads = static_cast<unsigned int>(std::max<std::size_t>(1, std::min<std::size_t>(threads, tasks.size())));
+
+	// Deal the tasks out largest first
+	std::vector<std::unique_ptr<TaskQueue>> queues;
+	for (unsigned int t = 0; t < threads; t++) {
+		queues.emplace_back(new TaskQueue());
+	}
+	for (std::size_t i = 0; i < tasks.size(); i++) {
+		queues[i % threads]->tasks.push_back(std::move(tasks[i]));
+	}
+
+	std::mutex failure_lock;
+	std::vector<std::pair<int, std::string>> failures;
+	auto fail = [&](const std::size_t job, const std::string &what) {
+		std::lock_guard<std::mutex> guard(failure_lock);
+		failures.emplace_back(jobs[job].line, "line " + std::to_string(jobs[job].line) + ": " + jobs[job].input +
+											  ": " + what);
+	};
+
+	std::atomic<std::uint64_t> completed(0);
+	std::atomic<std::uint64_t> cell_updates(0);
+
+	auto save = [&](const std::size_t job, const BitGrid &grid) {
+		try {
+			Zoo::save_ascii(jobs[job].output, grid);
+			completed++;
+		}
+		catch (const std::exception &ex) {
+			fail(job, ex.what());
+		}
+	};
+
+	SaveQueue saves;
+	saves.capacity = std::max(1u, options.io_threads) * saves_per_io_thread;
+
+	std::vector<std::unique_ptr<FreeList>> spares;
+	for (unsigned int t = 0; t < threads; t++) {
+		spares.emplace_back(new FreeList());
+	}
+
+	auto io = [&]() {
+		std::unique_lock<std::mutex> guard(saves.lock);
+		for (;;) {
+			saves.not_empty.wait(guard, [&saves] { return saves.closed || !saves.grids.empty(); });
+			if (saves.grids.empty()) {
+				return;
+			}
+			Save next = std::move(saves.grids.front());
+			saves.grids.pop_front();
+			saves.not_full.notify_one();
+
+			guard.unlock();
+			save(next.job, next.grid);
+			{
+				FreeList &spare = *spares[next.worker];
+				std::lock_guard<std::mutex> spare_guard(spare.lock);
+				spare.grids.push_back(std::move(next.grid));
+			}
+			guard.lock();
+		}
+	};
+
+	// Take from the front of our own queue, or steal from the back of another's
+	auto take = [&](const unsigned int worker, Task &task) {
+		for (unsigned int k = 0; k < threads; k++) {
+			TaskQueue &queue = *queues[(worker + k) % threads];
+			std::lock_guard<std::mutex> guard(queue.lock);
+			if (!queue.tasks.empty()) {
+				if (k == 0) {
+					task = std::move(queue.tasks.front());
+					queue.tasks.pop_front();
+				} else {
+					task = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+				}
+				return true;
+			}
+		}
+		return false;
+	};
+
+	auto work = [&](const unsigned int worker) {
+		BitGrid current;
+		BitGrid next;
+		Task task;
+		while (take(worker, task)) {
+			for (const std::size_t job : task.jobs) {
+				try {
+					Zoo::load_ascii(jobs[job].input, current);
+					for (int step = 0; step < jobs[job].steps; step++) {
+						BitWorld::step(current, next, jobs[job].toroidal);
+						std::swap(current, next);
+					}
+					cell_updates += static_cast<std::uint64_t>(current.get_total_cells()) * jobs[job].steps;
+				}
+				catch (const std::exception &ex) {
+					fail(job, ex.what());
+					continue;
+				}
+
+				if (options.io_threads == 0) {
+					save(job, current);
+					continue;
+				}
+
+				{
+					std::unique_lock<std::mutex> guard(saves.lock);
+					saves.not_full.wait(guard, [&saves] { return saves.grids.size() < saves.capacity; });
+					saves.grids.push_back(Save{job, worker, std::move(current)});
+					saves.not_empty.notify_one();
+				}
+
+				// Load the next job into a grid the savers have finished with, if there is one yet
+				FreeList &spare = *spares[worker];
+				std::lock_guard<std::mutex> guard(spare.lock);
+				if (!spare.grids.empty()) {
+					current = std::move(spare.grids.back());
+					spare.grids.pop_back();
+				}
+			}
+		}
+	};
+
+	std::vector<std::thread> io_threads;
+	for (unsigned int t = 0; t < options.io_threads; t++) {
+		io_threads.emplace_back(io);
+	}
+	std::vector<std::thread> workers;
+	for (unsigned int t = 1; t < threads; t++) {
+		workers.emplace_back(work, t);
+	}
+	work(0);
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(saves.lock);
+		saves.closed = true;
+	}
+	saves.not_empty.notify_all();
+	for (std::thread &io_thread : io_threads) {
+		io_thread.join();
+	}
+
+	std::stable_sort(failures.begin(), failures.end(),
+					 [](const std::pair<int, std::string> &a, const std::pair<int, std::string> &b) {
+		return a.first < b.first;
+	});
+	for (const auto &failure : failures) {
+		report.failures.push_back(failure.second);
+	}
+	report.completed = completed;
+	report.cell_updates = cell_updates;
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return report;
+}
+
+/**
+ * operator<<(output_stream, report)
+ *
+ * Print a batch report as a summary line followed by one line per failed job.
+ *
+ * @param output_stream - An ascii mode output stream such as std::cout.
+ * @param report - The report to print.
+ * @return Returns a reference to the output stream to enable operator chaining.
+ */
+std::ostream &operator<<(std::ostream &output_stream, const Batch::Report &report) {
+	output_stream << "Jobs " << report.jobs <<
+		" | Completed " << report.completed <<
+		" | Failed " << report.failures.size() <<
+		" | Tasks " << report.tasks <<
+		" | " << report.seconds << " s" <<
+		" | " << (report.seconds > 0 ? report.jobs / report.seconds : 0) << " jobs/s" <<
+		" | " << (report.seconds > 0 ? report.cell_updates / report.seconds : 0) << " cell updates/s" << std::endl;
+
+	for (const std::string &failure : report.failures) {
+		output_stream << "  " << failure << std::endl;
+	}
+
+	return output_stream;
+}
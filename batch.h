@@ -0,0 +1,68 @@
+/**
+ * Declares a Batch namespace for stepping many pattern files concurrently in one process.
+ * Rich documentation for the api and behaviour the Batch namespace can be found in batch.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Declare the interface of the Batch namespace for reading a manifest and running its jobs on a pool of threads.
+ */
+namespace Batch {
+
+	// Errors
+	const std::string file_cannot_be_opened_error = "File cannot be opened: ";
+	const std::string manifest_line_not_valid_error = "Manifest line is not 'input output steps [toroidal|bounded]': ";
+
+	/**
+	 * One pattern file to step and save.
+	 * line is where the job was found in its manifest, for reporting failures.
+	 */
+	struct Job {
+		std::string input;
+		std::string output;
+		int steps = 0;
+		bool toroidal = false;
+		int line = 0;
+	};
+
+	/**
+	 * How a batch is run.
+	 *      - threads step the jobs, 0 uses every core.
+	 *      - io_threads save the results, so stepping never waits on the disk.
+	 *      - Jobs of fewer than group_cells cells are packed together into tasks of up to group_cells cells,
+	 *        so a worker steps a run of small worlds back to back with its buffers still in cache.
+	 */
+	struct Options {
+		unsigned int threads = 0;
+		unsigned int io_threads = 2;
+		std::uint64_t group_cells = 1 << 16;
+	};
+
+	/**
+	 * What happened to a batch.
+	 * failures has one message per job which could not be loaded, stepped or saved.
+	 */
+	struct Report {
+		std::uint64_t jobs = 0;
+		std::uint64_t completed = 0;
+		std::uint64_t tasks = 0;
+		std::uint64_t cell_updates = 0;
+		double seconds = 0;
+		std::vector<std::string> failures;
+	};
+
+	std::vector<Job> parse_manifest(std::istream &input_stream);
+	std::vector<Job> load_manifest(const std::string &path);
+
+	Report run(const std::vector<Job> &jobs, const Options &options = Options());
+};
+
+std::ostream &operator<<(std::ostream &output_stream, const Batch::Report &report);
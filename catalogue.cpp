@@ -0,0 +1,481 @@
+/**
+ * Implements a Catalogue namespace holding a database of known lifeforms in the Game of Life.
+ *      - Known patterns are embedded at compile time as constexpr bit tables.
+ *          - Each row of a pattern is a 64 bit word, bit x is set if the cell in column x is alive.
+ *
+ *      - Patterns are identified by a canonical hash.
+ *          - The hash is invariant under translation, by trimming a grid to the bounding box of its alive cells.
+ *          - The hash is invariant under the 8 rotations and reflections, by taking the smallest hash
+ *            of the 8 transformed grids.
+ *
+ *      - Every phase of every known oscillator and spaceship is indexed, so a grid can be looked up
+ *        against the whole catalogue with a single hash table probe.
+ *          - Each phase is stored with its cells in the orientation whose hash is canonical, and a hit is only
+ *            a match if the cells are the same, so two shapes whose hashes collide are never confused.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "catalogue.h"
+#include "world.h"
+#include <algorithm>
+#include <utility>
+#include <unordered_map>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * The compile time table of known patterns.
+ * https://www.conwaylife.com/wiki/
+ */
+static constexpr Catalogue::Pattern known_patterns[] = {
+	// Still lifes
+	{"block",            Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse("##/##")},
+	{"beehive",          Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse(".##./#..#/.##.")},
+	{"loaf",             Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse(".##./#..#/.#.#/..#.")},
+	{"boat",             Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse("##./#.#/.#.")},
+	{"ship",             Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse("##./#.#/.##")},
+	{"tub",              Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse(".#./#.#/.#.")},
+	{"pond",             Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse(".##./#..#/#..#/.##.")},
+	{"barge",            Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse(".#../#.#./.#.#/..#.")},
+	{"long boat",        Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse("##../#.#./.#.#/..#.")},
+	{"snake",            Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse("##.#/#.##")},
+	{"aircraft carrier", Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse("##../#..#/..##")},
+	{"eater 1",          Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse("##../#.#./..#./..##")},
+	{"mango",            Catalogue::Kind::STILL_LIFE, 1, Catalogue::parse(".##../#..#./.#..#/..##.")},
+
+	// Oscillators
+	{"blinker",          Catalogue::Kind::OSCILLATOR, 2, Catalogue::parse("###")},
+	{"toad",             Catalogue::Kind::OSCILLATOR, 2, Catalogue::parse(".###/###.")},
+	{"beacon",           Catalogue::Kind::OSCILLATOR, 2, Catalogue::parse("##../##../..##/..##")},
+	{"clock",            Catalogue::Kind::OSCILLATOR, 2, Catalogue::parse("..#./#.#./.#.#/.#..")},
+	{"pulsar",           Catalogue::Kind::OSCILLATOR, 3, Catalogue::parse(
+		"..###...###../............./#....#.#....#/#....#.#....#/#....#.#....#/..###...###../"
+		"............./..###...###../#....#.#....#/#....#.#....#/#....#.#....#/............./"
+		"..###...###..")},
+	{"pentadecathlon",   Catalogue::Kind::OSCILLATOR, 15, Catalogue::parse("..#....#../##.####.##/..#....#..")},
+
+	// Spaceships
+	{"glider",           Catalogue::Kind::SPACESHIP, 4, Catalogue::parse(".#./..#/###")},
+	{"light weight spaceship",  Catalogue::Kind::SPACESHIP, 4, Catalogue::parse(".#..#/#..../#...#/####.")},
+	{"middle weight spaceship", Catalogue::Kind::SPACESHIP, 4, Catalogue::parse("..#.../#...#./.....#/#....#/.#####")},
+	{"heavy weight spaceship",  Catalogue::Kind::SPACESHIP, 4, Catalogue::parse("..##.../#....#./......#/#.....#/.######")},
+
+	// Methuselahs
+	{"r-pentomino",      Catalogue::Kind::METHUSELAH, 0, Catalogue::parse(".##/##./.#.")},
+	{"diehard",          Catalogue::Kind::METHUSELAH, 0, Catalogue::parse("......#./##....../.#...###")},
+	{"acorn",            Catalogue::Kind::METHUSELAH, 0, Catalogue::parse(".#...../...#.../##..###")},
+	{"pi-heptomino",     Catalogue::Kind::METHUSELAH, 0, Catalogue::parse("###/#.#/#.#")},
+};
+
+static_assert(known_patterns[0].bits.width == 2 && known_patterns[0].bits.height == 2, "Block should be 2x2");
+static_assert(known_patterns[0].bits.rows[0] == 3 && known_patterns[0].bits.rows[1] == 3, "Block should be full");
+
+// Every rotation and reflection, for finding the canonical one
+static const Symmetry symmetries[] = {
+	Symmetry::IDENTITY, Symmetry::ROTATE_90, Symmetry::ROTATE_180, Symmetry::ROTATE_270,
+	Symmetry::FLIP_LEFT_RIGHT, Symmetry::FLIP_TOP_BOTTOM, Symmetry::TRANSPOSE, Symmetry::ANTI_TRANSPOSE
+};
+
+/**
+ * Check whether a symmetry swaps the width and height of a grid.
+ * @param symmetry - The rotation or reflection.
+ * @return True if the symmetry transposes the grid.
+ */
+static bool transposes(const Symmetry symmetry) {
+	return symmetry == Symmetry::ROTATE_90 || symmetry == Symmetry::ROTATE_270 ||
+		   symmetry == Symmetry::TRANSPOSE || symmetry == Symmetry::ANTI_TRANSPOSE;
+}
+
+/**
+ * Read a cell of a view as if the view had been transformed by a symmetry, matching Grid::transform(symmetry).
+ * @param view - The view.
+ * @param symmetry - The rotation or reflection.
+ * @param x - The x coordinate in the transformed view.
+ * @param y - The y coordinate in the transformed view.
+ * @return The cell of the view which lands at x, y.
+ */
+static const Cell & transformed_cell(const GridView &view, const Symmetry symmetry, const int x, const int y) {
+	const int width = view.get_width();
+	const int height = view.get_height();
+	switch (symmetry) {
+		case Symmetry::IDENTITY:        return view(x, y);
+		case Symmetry::ROTATE_90:       return view(y, height - 1 - x);
+		case Symmetry::ROTATE_180:      return view(width - 1 - x, height - 1 - y);
+		case Symmetry::ROTATE_270:      return view(width - 1 - y, x);
+		case Symmetry::FLIP_LEFT_RIGHT: return view(width - 1 - x, y);
+		case Symmetry::FLIP_TOP_BOTTOM: return view(x, height - 1 - y);
+		case Symmetry::TRANSPOSE:       return view(y, x);
+		case Symmetry::ANTI_TRANSPOSE:  return view(width - 1 - y, height - 1 - x);
+	}
+	return view(x, y);
+}
+
+/**
+ * Hash the cells of a view along with its size, as if the view had been transformed by a symmetry.
+ * The transformed view is never built, each transformed cell is read straight from the view.
+ * Rows are packed into 64 bit words before mixing so the hash costs one multiply per 64 cells.
+ *
+ * @param view - The view to hash.
+ * @param symmetry - The rotation or reflection to hash the view under.
+ * @return The 64 bit hash of the transformed view.
+ */
+static std::uint64_t hash_view(const GridView &view, const Symmetry symmetry) {
+	const int hashed_width = transposes(symmetry) ? view.get_height() : view.get_width();
+	const int hashed_height = transposes(symmetry) ? view.get_width() : view.get_height();
+
+	CellHash hash(hashed_width, hashed_height);
+	for (int y = 0; y < hashed_height; y++) {
+		hash.mix_row(hashed_width, [&view, symmetry, y](const int x) {
+			return transformed_cell(view, symmetry, x, y) == Cell::ALIVE;
+		});
+	}
+	return hash.finish();
+}
+
+/**
+ * Catalogue::trim(view)
+ *
+ * Narrow a view down to the bounding box of its alive cells, without copying.
+ * A view with no alive cells is trimmed to an empty 0x0 view.
+ *
+ * @example
+ *
+ *      // Place a glider in the middle of a large grid
+ *      Grid grid(32);
+ *      grid.merge(Zoo::glider(), 10, 20);
+ *
+ *      // View just the 3x3 glider
+ *      GridView glider = Catalogue::trim(grid);
+ *
+ * @param view
+ *      The grid or view to trim.
+ *
+ * @return
+ *      A view the size of the bounding box of the alive cells.
+ */
+GridView Catalogue::trim(const GridView &view) {
+	int x0 = view.get_width(), y0 = view.get_height();
+	int x1 = 0, y1 = 0;
+
+	for (int y = 0; y < view.get_height(); y++) {
+		const Cell *row = view.row(y);
+		for (int x = 0; x < view.get_width(); x++) {
+			if (row[x] == Cell::ALIVE) {
+				x0 = std::min(x0, x);
+				y0 = std::min(y0, y);
+				x1 = std::max(x1, x + 1);
+				y1 = std::max(y1, y + 1);
+			}
+		}
+	}
+
+	if (x1 == 0) {
+		return GridView();
+	}
+	return view.crop(x0, y0, x1, y1);
+}
+
+/**
+ * Catalogue::canonical_hash(view)
+ *
+ * Hash a grid so that any translation, rotation or reflection of the same alive cells gives the same hash.
+ * The grid is trimmed to its bounding box and the smallest hash over the 8 symmetries is returned.
+ * Neither the trimmed nor the transformed grids are copied.
+ *
+ * @example
+ *
+ *      // Every orientation of a glider hashes the same
+ *      Grid glider = Zoo::glider();
+ *      bool same = Catalogue::canonical_hash(glider) == Catalogue::canonical_hash(glider.transform(Symmetry::TRANSPOSE));
+ *
+ * @param view
+ *      The grid or view to hash.
+ *
+ * @return
+ *      The canonical 64 bit hash.
+ */
+std::uint64_t Catalogue::canonical_hash(const GridView &view) {
+	const GridView trimmed = trim(view);
+
+	std::uint64_t hash = UINT64_MAX;
+	for (const Symmetry symmetry : symmetries) {
+		hash = std::min(hash, hash_view(trimmed, symmetry));
+	}
+	return hash;
+}
+
+/**
+ * Catalogue::to_grid(bits)
+ *
+ * Construct a grid the size of a compile time bit table containing its pattern.
+ *
+ * @example
+ *
+ *      // Build a block from its plaintext
+ *      Grid block = Catalogue::to_grid(Catalogue::parse("##/##"));
+ *
+ * @param bits
+ *      The bit table to expand.
+ *
+ * @return
+ *      Returns a Grid containing the pattern.
+ */
+Grid Catalogue::to_grid(const Bits &bits) {
+	Grid grid = Grid(bits.width, bits.height);
+	for (int y = 0; y < bits.height; y++) {
+		for (int x = 0; x < bits.width; x++) {
+			if ((bits.rows[y] >> x) & 1) {
+				grid(x, y) = Cell::ALIVE;
+			}
+		}
+	}
+	return grid;
+}
+
+/**
+ * One indexed phase of a known pattern, with its cells trimmed and in the orientation whose hash is canonical.
+ */
+struct Shape {
+	const Catalogue::Pattern *pattern;
+	Catalogue::Bits bits;
+};
+
+typedef std::unordered_map<std::uint64_t, std::vector<Shape>> Database;
+
+/**
+ * Check whether a trimmed view transformed by a symmetry has the same cells as a bit table.
+ * @param trimmed - The trimmed view.
+ * @param symmetry - The rotation or reflection to compare the view under.
+ * @param bits - The bit table.
+ * @return True if the transformed view and the bit table are the same size with the same alive cells.
+ */
+static bool same_cells(const GridView &trimmed, const Symmetry symmetry, const Catalogue::Bits &bits) {
+	const int width = transposes(symmetry) ? trimmed.get_height() : trimmed.get_width();
+	const int height = transposes(symmetry) ? trimmed.get_width() : trimmed.get_height();
+	if (width != bits.width || height != bits.height) {
+		return false;
+	}
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			if ((transformed_cell(trimmed, symmetry, x, y) == Cell::ALIVE) != (((bits.rows[y] >> x) & 1) != 0)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Index one phase of a known pattern under its canonical hash, unless the same cells are already indexed.
+ * @param database - The table to add to.
+ * @param phase - A grid holding the phase, which must trim to at most 64 x 32 cells.
+ * @param pattern - The pattern the phase belongs to.
+ */
+static void index_phase(Database &database, const GridView &phase, const Catalogue::Pattern &pattern) {
+	const GridView trimmed = Catalogue::trim(phase);
+
+	// The first symmetry with the smallest hash gives the stored orientation
+	Symmetry canonical = Symmetry::IDENTITY;
+	std::uint64_t hash = UINT64_MAX;
+	for (const Symmetry symmetry : symmetries) {
+		const std::uint64_t transformed_hash = hash_view(trimmed, symmetry);
+		if (transformed_hash < hash) {
+			hash = transformed_hash;
+			canonical = symmetry;
+		}
+	}
+
+	Shape shape = {&pattern, {0, 0, {}}};
+	shape.bits.width = transposes(canonical) ? trimmed.get_height() : trimmed.get_width();
+	shape.bits.height = transposes(canonical) ? trimmed.get_width() : trimmed.get_height();
+	if (shape.bits.width > Catalogue::max_pattern_width || shape.bits.height > Catalogue::max_pattern_height) {
+		throw std::logic_error(std::string("A phase of ") + pattern.name + " is larger than a bit table");
+	}
+	for (int y = 0; y < shape.bits.height; y++) {
+		for (int x = 0; x < shape.bits.width; x++) {
+			if (transformed_cell(trimmed, canonical, x, y) == Cell::ALIVE) {
+				shape.bits.rows[y] |= std::uint64_t(1) << x;
+			}
+		}
+	}
+
+	std::vector<Shape> &bucket = database[hash];
+	for (const Shape &indexed : bucket) {
+		if (same_cells(trimmed, canonical, indexed.bits)) {
+			return;
+		}
+	}
+	bucket.push_back(shape);
+}
+
+/**
+ * Build the hash table over every phase of every known pattern.
+ * Oscillators and spaceships are stepped through their period inside a grid padded
+ * far enough that a spaceship can never reach the edge.
+ * A phase with the same cells as one already indexed, such as the second phase of a blinker, is not added again.
+ *
+ * @return The table from canonical hash to the shapes with that hash.
+ */
+static Database build_database() {
+	Database database;
+
+	for (const Catalogue::Pattern &pattern : known_patterns) {
+		const Grid shape = Catalogue::to_grid(pattern.bits);
+		index_phase(database, shape, pattern);
+
+		if (pattern.period > 1) {
+			const int padding = pattern.period + 2;
+			Grid padded = Grid(shape.get_width() + 2 * padding, shape.get_height() + 2 * padding);
+			padded.merge(shape, padding, padding);
+
+			World world(std::move(padded));
+			for (int phase = 1; phase < pattern.period; phase++) {
+				world.step();
+				index_phase(database, world.get_state(), pattern);
+			}
+		}
+	}
+
+	return database;
+}
+
+/**
+ * Get the lazily built hash table of known patterns.
+ * The table is built once on first use and shared between threads.
+ *
+ * @return The table from canonical hash to the shapes with that hash.
+ */
+static const Database &database() {
+	static const Database database = build_database();
+	return database;
+}
+
+/**
+ * Catalogue::lookup(view)
+ *
+ * Identify the pattern in a grid or view, in any position, orientation or phase, in constant time.
+ * A pattern is only returned if its cells match, not just its hash.
+ *
+ * @example
+ *
+ *      // Identify a rotated spaceship
+ *      const Catalogue::Pattern *pattern = Catalogue::lookup(Zoo::light_weight_spaceship().rotate(1));
+ *      if (pattern) {
+ *          std::cout << pattern->name << std::endl;
+ *      }
+ *
+ * @param view
+ *      The grid or view containing a single pattern to identify.
+ *
+ * @return
+ *      A pointer to the known pattern, or nullptr if the pattern is not in the catalogue.
+ */
+const Catalogue::Pattern *Catalogue::lookup(const GridView &view) {
+	const GridView trimmed = trim(view);
+	std::uint64_t hashes[8];
+	std::uint64_t hash = UINT64_MAX;
+	for (int i = 0; i < 8; i++) {
+		hashes[i] = hash_view(trimmed, symmetries[i]);
+		hash = std::min(hash, hashes[i]);
+	}
+
+	const auto &table = database();
+	const auto match = table.find(hash);
+	if (match == table.end()) {
+		return nullptr;
+	}
+
+	// A symmetric shape has several canonical orientations, any of which may be the stored one
+	for (const Shape &shape : match->second) {
+		for (int i = 0; i < 8; i++) {
+			if (hashes[i] == hash && same_cells(trimmed, symmetries[i], shape.bits)) {
+				return shape.pattern;
+			}
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Catalogue::find(name)
+ *
+ * Find a known pattern by its name.
+ *
+ * @example
+ *
+ *      // Spawn a pulsar
+ *      Grid pulsar = Catalogue::to_grid(Catalogue::find("pulsar")->bits);
+ *
+ * @param name
+ *      The name of the pattern.
+ *
+ * @return
+ *      A pointer to the known pattern, or nullptr if there is no pattern with that name.
+ */
+const Catalogue::Pattern *Catalogue::find(const std::string &name) {
+	for (const Pattern &pattern : known_patterns) {
+		if (name == pattern.name) {
+			return &pattern;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Catalogue::pattern_count()
+ *
+ * @return The number of named patterns in the catalogue.
+ */
+unsigned int Catalogue::pattern_count() {
+	return sizeof(known_patterns) / sizeof(known_patterns[0]);
+}
+
+/**
+ * Catalogue::pattern(index)
+ *
+ * @param index - The index of the pattern, less than Catalogue::pattern_count().
+ * @return A reference to the pattern.
+ *
+ * @throws - out_of_range exception if the index is not in the catalogue.
+ */
+const Catalogue::Pattern &Catalogue::pattern(const unsigned int index) {
+	if (index >= pattern_count()) {
+		throw std::out_of_range("Pattern index is not within the catalogue");
+	}
+	return known_patterns[index];
+}
+
+/**
+ * Catalogue::shape_count()
+ *
+ * @return The number of distinct shapes indexed, counting each phase of a pattern once.
+ */
+unsigned int Catalogue::shape_count() {
+	unsigned int count = 0;
+	for (const auto &bucket : database()) {
+		count += static_cast<unsigned int>(bucket.second.size());
+	}
+	return count;
+}
+
+/**
+ * Catalogue::kind_name(kind)
+ *
+ * @param kind - The kind of pattern.
+ * @return A human readable name for the kind of pattern.
+ */
+std::string Catalogue::kind_name(const Kind kind) {
+	switch (kind) {
+		case Kind::STILL_LIFE:
+			return "still life";
+		case Kind::OSCILLATOR:
+			return "oscillator";
+		case Kind::SPACESHIP:
+			return "spaceship";
+		case Kind::METHUSELAH:
+			return "methuselah";
+	}
+	return "unknown";
+}
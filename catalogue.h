@@ -0,0 +1,96 @@
+/**
+ * Declares a Catalogue namespace holding a database of known lifeforms in the Game of Life.
+ * Rich documentation for the api and behaviour the Catalogue namespace can be found in catalogue.cpp.
+ *
+ * Known patterns are embedded at compile time as constexpr bit tables, one 64 bit word per row.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "grid.h"
+
+/**
+ * Declare the interface of the Catalogue namespace for hashing and identifying patterns.
+ */
+namespace Catalogue {
+
+	// Limits of the compile time bit tables
+	const int max_pattern_width = 64;
+	const int max_pattern_height = 32;
+
+	/**
+	 * The broad family a known pattern belongs to.
+	 */
+	enum class Kind {
+		STILL_LIFE,
+		OSCILLATOR,
+		SPACESHIP,
+		METHUSELAH
+	};
+
+	/**
+	 * A pattern stored as a bit table, bit x of rows[y] is set if the cell at x,y is alive.
+	 */
+	struct Bits {
+		int width;
+		int height;
+		std::uint64_t rows[max_pattern_height];
+	};
+
+	/**
+	 * A named entry in the catalogue.
+	 * The period is the number of generations for the pattern to return to its first phase.
+	 * Methuselahs have a period of 0 as they never return.
+	 */
+	struct Pattern {
+		const char *name;
+		Kind kind;
+		int period;
+		Bits bits;
+	};
+
+	/**
+	 * Parse a plaintext pattern at compile time, rows are separated by '/' with '#' alive and '.' dead.
+	 *
+	 * @example
+	 *
+	 *      constexpr Catalogue::Bits block = Catalogue::parse("##/##");
+	 */
+	constexpr Bits parse(const char *plaintext) {
+		Bits bits = {0, 0, {}};
+		int x = 0;
+		for (const char *c = plaintext; *c != '\0'; c++) {
+			if (*c == '/') {
+				bits.height++;
+				x = 0;
+			} else {
+				if (*c == '#') {
+					bits.rows[bits.height] |= std::uint64_t(1) << x;
+				}
+				x++;
+				if (x > bits.width) {
+					bits.width = x;
+				}
+			}
+		}
+		bits.height++;
+		return bits;
+	}
+
+	std::uint64_t canonical_hash(const GridView &view);
+	GridView trim(const GridView &view);
+	Grid to_grid(const Bits &bits);
+
+	const Pattern *lookup(const GridView &view);
+	const Pattern *find(const std::string &name);
+
+	unsigned int pattern_count();
+	const Pattern &pattern(unsigned int index);
+	unsigned int shape_count();
+
+	std::string kind_name(Kind kind);
+};
@@ -0,0 +1,471 @@
+/**
+ * Implements a Census namespace for splitting a Grid into separate objects and counting what they are.
+ *      - Objects are connected components of alive cells.
+ *          - Two alive cells are connected if they are within (gap + 1) cells of each other in both x and y,
+ *            so a gap of 0 is the usual 8-connectivity.
+ *
+ *      - Components are labelled with a two-pass union-find scan over runs of alive cells.
+ *          - Each row is read 64 cells at a time as words of alive bits, and split into runs of alive cells.
+ *            The union-find joins runs rather than cells, so its tables grow with the runs in the grid,
+ *            which a settled soup has few of, rather than with its cells.
+ *          - A run joins the run before it in its row and every run within reach in the rows above,
+ *            found by sweeping both rows' runs left to right together.
+ *          - The first pass is run in parallel on the calling thread's Workers::current() pool,
+ *            each band of rows labelling its own runs.
+ *          - The bands are then stitched together along their edges, and every run is resolved to its root.
+ *
+ *      - Each object is cropped to its bounding box and classified against the Catalogue,
+ *        which includes every creature in the Zoo.
+ *
+ *      - Objects not in the catalogue are labelled again with one more cell of gap, and a merge which is
+ *        in the catalogue replaces its parts.
+ *          - The weight spaceships each have a phase with a cell touching no other, so with a gap of 0
+ *            they are found as two unknown parts. Only the unknown objects are labelled again, so a
+ *            catalogued object beside debris is not swallowed by it.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "census.h"
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include "workers.h"
+
+// Bands are never shorter than this, so small grids are not split into slivers which cost more to start than to label
+static const int min_band_rows = 32;
+
+/**
+ * A run of alive cells [x0, x1) in one row.
+ */
+struct Run {
+	int x0;
+	int x1;
+};
+
+/**
+ * The runs of a band of rows, and the union-find parent of each run.
+ * The runs of row y are runs[row_start[y - first_row]] up to runs[row_start[y - first_row + 1]].
+ * The bands are gathered into the first once labelled, so its table then covers every row.
+ */
+struct Band {
+	int first_row = 0;
+	std::vector<Run> runs;
+	std::vector<std::size_t> row_start;
+	std::vector<std::size_t> parent;
+};
+
+/**
+ * Find the root of the set containing a run, halving the path as it goes.
+ * @param parent - The union-find parent table.
+ * @param i - The index of the run.
+ * @return The index of the root run.
+ */
+static std::size_t find_root(std::vector<std::size_t> &parent, std::size_t i) {
+	while (parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+/**
+ * Join the sets containing two runs, the smaller index always becomes the root.
+ * @param parent - The union-find parent table.
+ * @param a - The index of the first run.
+ * @param b - The index of the second run.
+ */
+static void join(std::vector<std::size_t> &parent, std::size_t a, std::size_t b) {
+	a = find_root(parent, a);
+	b = find_root(parent, b);
+	if (a < b) {
+		parent[b] = a;
+	} else if (b < a) {
+		parent[a] = b;
+	}
+}
+
+/**
+ * Split a row into its runs of alive cells, reading it 64 cells at a time.
+ * @param grid - The grid being labelled.
+ * @param y - The row.
+ * @param runs - The runs are appended to this.
+ */
+static void find_runs(const GridView &grid, const int y, std::vector<Run> &runs) {
+	const int width = grid.get_width();
+	const GridView::Word *row = grid.row(y);
+	bool open = false;
+	for (int x = 0; x < width; x += 64) {
+		const int count = std::min(64, width - x);
+		const std::uint64_t alive = ByteCells::load(row, grid.get_offset() + x, count);
+		const std::uint64_t dead = ~alive & (count == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1);
+
+		// Alternately find the next alive cell to open a run and the next dead cell to close it, a run left open
+		// at the end of the word carries on into the next
+		int bit = 0;
+		while (bit < count) {
+			const std::uint64_t ahead = (open ? dead : alive) >> bit;
+			if (ahead == 0) {
+				break;
+			}
+			bit += __builtin_ctzll(ahead);
+			if (open) {
+				runs.back().x1 = x + bit;
+			} else {
+				runs.push_back(Run{x + bit, width});
+			}
+			open = !open;
+		}
+	}
+}
+
+/**
+ * Join each run of a row with the runs within reach of it in a row above.
+ * Runs are sorted and apart within a row, so the runs of the row above within reach of each run are found by
+ * sweeping both rows left to right together.
+ * @param runs - Every run, indexed as the parent table is.
+ * @param parent - The union-find parent table.
+ * @param above - The index of the first run of the row above and one past its last.
+ * @param row - The index of the first run of the row and one past its last.
+ * @param reach - The distance at which cells are connected.
+ */
+static void join_rows(const std::vector<Run> &runs, std::vector<std::size_t> &parent, const std::size_t above[2],
+					  const std::size_t row[2], const int reach) {
+	std::size_t first = above[0];
+	for (std::size_t i = row[0]; i < row[1]; i++) {
+		while (first < above[1] && runs[first].x1 - 1 + reach < runs[i].x0) {
+			first++;
+		}
+		for (std::size_t j = first; j < above[1] && runs[j].x0 <= runs[i].x1 - 1 + reach; j++) {
+			join(parent, i, j);
+		}
+	}
+}
+
+/**
+ * Join each run of a row with the run before it if within reach, and with the runs within reach in the rows above,
+ * never looking above the row first_row.
+ * @param runs - Every run, indexed as the parent table is.
+ * @param parent - The union-find parent table.
+ * @param row_start - The index of the first run of each row from row_base, and one past the last row.
+ * @param row_base - The row whose runs start at row_start[0].
+ * @param y - The row.
+ * @param reach - The distance at which cells are connected.
+ * @param first_row - The first row that may be read.
+ */
+static void join_previous(const std::vector<Run> &runs, std::vector<std::size_t> &parent,
+						  const std::vector<std::size_t> &row_start, const int row_base, const int y,
+						  const int reach, const int first_row) {
+	const std::size_t row[2] = {row_start[y - row_base], row_start[y - row_base + 1]};
+	for (std::size_t i = row[0] + 1; i < row[1]; i++) {
+		if (runs[i].x0 - (runs[i - 1].x1 - 1) <= reach) {
+			join(parent, i - 1, i);
+		}
+	}
+	for (int above_y = std::max(first_row, y - reach); above_y < y; above_y++) {
+		const std::size_t above[2] = {row_start[above_y - row_base], row_start[above_y - row_base + 1]};
+		join_rows(runs, parent, above, row, reach);
+	}
+}
+
+/**
+ * First pass over a band of rows, finding its runs and only joining runs within the band.
+ * Bands only write to their own runs and parent table so they can run in parallel.
+ * @param grid - The grid being labelled.
+ * @param band - The band, its first row set, to fill in.
+ * @param reach - The distance at which cells are connected.
+ * @param end_row - One past the last row of the band.
+ */
+static void label_band(const GridView &grid, Band &band, const int reach, const int end_row) {
+	band.runs.clear();
+	band.row_start.assign(1, 0);
+	for (int y = band.first_row; y < end_row; y++) {
+		find_runs(grid, y, band.runs);
+		band.row_start.push_back(band.runs.size());
+	}
+
+	band.parent.resize(band.runs.size());
+	for (std::size_t i = 0; i < band.runs.size(); i++) {
+		band.parent[i] = i;
+	}
+	for (int y = band.first_row; y < end_row; y++) {
+		join_previous(band.runs, band.parent, band.row_start, band.first_row, y, reach, band.first_row);
+	}
+}
+
+/**
+ * Split a grid into its connected objects and classify each of them, without labelling unknown objects again.
+ * @param grid - The grid to split.
+ * @param gap - The number of dead cells allowed between two alive cells of the same object.
+ * @param threads - The number of threads to label with, 0 uses every core.
+ * @return The objects, in the order of their top left most cell.
+ */
+static std::vector<Census::Object> label(const GridView &grid, const int gap, unsigned int threads) {
+	const int height = grid.get_height();
+	const int reach = std::max(gap, 0) + 1;
+
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Bands must be taller than the reach so stitching only looks into the band above
+	const int min_band = std::max(reach, min_band_rows);
+	const int count = std::max(1, std::min<int>(threads, height / min_band));
+	std::vector<int> band_start(count + 1);
+	std::vector<Band> bands(count);
+	for (int b = 0; b <= count; b++) {
+		band_start[b] = (height * b) / count;
+	}
+
+	// First pass, each band in parallel
+	Workers::current().run(static_cast<unsigned int>(count), [&grid, &bands, &band_start, reach](const unsigned int b) {
+		bands[b].first_row = band_start[b];
+		label_band(grid, bands[b], reach, band_start[b + 1]);
+	});
+
+	// Gather the bands into the first band's table, offsetting each band's runs and parents by the runs before it
+	std::vector<Run> &runs = bands[0].runs;
+	std::vector<std::size_t> &parent = bands[0].parent;
+	std::vector<std::size_t> &row_start = bands[0].row_start;
+	for (int b = 1; b < count; b++) {
+		const std::size_t base = runs.size();
+		runs.insert(runs.end(), bands[b].runs.begin(), bands[b].runs.end());
+		for (const std::size_t up : bands[b].parent) {
+			parent.push_back(base + up);
+		}
+		for (std::size_t y = 1; y < bands[b].row_start.size(); y++) {
+			row_start.push_back(base + bands[b].row_start[y]);
+		}
+		bands[b] = Band();
+	}
+
+	// Stitch each band to the rows above it
+	for (int b = 1; b < count; b++) {
+		for (int y = band_start[b]; y < std::min(band_start[b] + reach, height); y++) {
+			const std::size_t row[2] = {row_start[y], row_start[y + 1]};
+			for (int above_y = y - reach; above_y < band_start[b]; above_y++) {
+				const std::size_t above[2] = {row_start[above_y], row_start[above_y + 1]};
+				join_rows(runs, parent, above, row, reach);
+			}
+		}
+	}
+
+	// Second pass, resolve every run to an object and grow its bounding box
+	std::vector<Census::Object> found;
+	std::vector<std::size_t> object_of(runs.size());
+	std::vector<std::size_t> object_of_root(runs.size(), SIZE_MAX);
+	for (int y = 0; y < height; y++) {
+		for (std::size_t i = row_start[y]; i < row_start[y + 1]; i++) {
+			const std::size_t root = find_root(parent, i);
+			if (object_of_root[root] == SIZE_MAX) {
+				object_of_root[root] = found.size();
+				found.push_back(Census::Object{runs[i].x0, y, runs[i].x1, y + 1, 0, nullptr, Grid()});
+			}
+			object_of[i] = object_of_root[root];
+			Census::Object &object = found[object_of[i]];
+			object.x0 = std::min(object.x0, runs[i].x0);
+			object.x1 = std::max(object.x1, runs[i].x1);
+			object.y1 = y + 1;
+			object.population += static_cast<unsigned int>(runs[i].x1 - runs[i].x0);
+		}
+	}
+
+	// Crop out only the runs of each object, the bounding boxes of objects can overlap
+	for (Census::Object &object : found) {
+		object.cells = Grid(object.x1 - object.x0, object.y1 - object.y0);
+	}
+	for (int y = 0; y < height; y++) {
+		for (std::size_t i = row_start[y]; i < row_start[y + 1]; i++) {
+			Census::Object &object = found[object_of[i]];
+			ByteCells::fill(object.cells.row(y - object.y0), runs[i].x0 - object.x0, runs[i].x1 - runs[i].x0,
+							Cell::ALIVE);
+		}
+	}
+
+	for (Census::Object &object : found) {
+		object.pattern = Catalogue::lookup(object.cells);
+	}
+
+	return found;
+}
+
+/**
+ * Census::objects(grid, gap, threads)
+ *
+ * Split a grid into its separate objects and classify each of them.
+ * Objects are returned in the order of their top left most cell, scanning across then down.
+ * Unknown objects which make a catalogued object when joined with one more cell of gap are returned as it,
+ * so a light weight spaceship is found whole with the default gap of 0.
+ *
+ * @example
+ *
+ *      // Place a glider and a block on a grid
+ *      Grid grid(16);
+ *      grid.merge(Zoo::glider(), 1, 1);
+ *      grid.merge(Catalogue::to_grid(Catalogue::find("block")->bits), 10, 10);
+ *
+ *      // Find the two objects
+ *      for (const Census::Object &object : Census::objects(grid)) {
+ *          std::cout << object.cells << std::endl;
+ *      }
+ *
+ * @param grid
+ *      The grid or view to split into objects.
+ *
+ * @param gap
+ *      Optional parameter. The number of dead cells allowed between two alive cells of the same object.
+ *      Defaults to 0, joining cells which touch including diagonally.
+ *
+ * @param threads
+ *      Optional parameter. The number of threads to label with. Defaults to 0, using every core.
+ *
+ * @return
+ *      The objects found in the grid.
+ */
+std::vector<Census::Object> Census::objects(const GridView &grid, const int gap, const unsigned int threads) {
+	std::vector<Object> found = label(grid, gap, threads);
+
+	// The bounds of every unknown object
+	int x0 = INT_MAX, y0 = INT_MAX, x1 = INT_MIN, y1 = INT_MIN;
+	for (const Object &object : found) {
+		if (object.pattern == nullptr) {
+			x0 = std::min(x0, object.x0);
+			y0 = std::min(y0, object.y0);
+			x1 = std::max(x1, object.x1);
+			y1 = std::max(y1, object.y1);
+		}
+	}
+	if (x0 > x1) {
+		return found;
+	}
+
+	// Label only the unknown objects again, one cell of gap wider
+	Grid unknown(x1 - x0, y1 - y0);
+	for (const Object &object : found) {
+		if (object.pattern == nullptr) {
+			unknown.merge(object.cells, object.x0 - x0, object.y0 - y0, Blend::OR);
+		}
+	}
+	std::vector<Object> merged = label(unknown, gap + 1, threads);
+
+	// Each part lies wholly in one merge, found from the first cell of its top row.
+	// A merge in the catalogue takes the place of its first part, so the objects stay in scan order
+	std::vector<Object> result;
+	std::vector<bool> placed(merged.size(), false);
+	for (Object &object : found) {
+		if (object.pattern != nullptr) {
+			result.push_back(std::move(object));
+			continue;
+		}
+
+		int first_x = 0;
+		while (object.cells(first_x, 0) != Cell::ALIVE) {
+			first_x++;
+		}
+		const int x = object.x0 + first_x - x0;
+		const int y = object.y0 - y0;
+		std::size_t m = 0;
+		while (!(x >= merged[m].x0 && x < merged[m].x1 && y >= merged[m].y0 && y < merged[m].y1 &&
+				 merged[m].cells(x - merged[m].x0, y - merged[m].y0) == Cell::ALIVE)) {
+			m++;
+		}
+
+		if (merged[m].pattern == nullptr) {
+			result.push_back(std::move(object));
+		} else if (!placed[m]) {
+			placed[m] = true;
+			Object whole = merged[m];
+			whole.x0 += x0;
+			whole.x1 += x0;
+			whole.y0 += y0;
+			whole.y1 += y0;
+			result.push_back(std::move(whole));
+		}
+	}
+
+	return result;
+}
+
+/**
+ * Census::take(grid, gap, threads)
+ *
+ * Count the objects in a grid by kind and by name.
+ * Objects which are not in the catalogue are counted as unknown.
+ *
+ * @example
+ *
+ *      // Let a soup settle then count what is left
+ *      World world(soup);
+ *      world.advance(1000);
+ *      std::cout << Census::take(world.get_state()) << std::endl;
+ *
+ * @param grid
+ *      The grid or view to take a census of.
+ *
+ * @param gap
+ *      Optional parameter. The number of dead cells allowed between two alive cells of the same object.
+ *      Defaults to 0.
+ *
+ * @param threads
+ *      Optional parameter. The number of threads to label with. Defaults to 0, using every core.
+ *
+ * @return
+ *      The counts of objects in the grid.
+ */
+Census::Result Census::take(const GridView &grid, const int gap, const unsigned int threads) {
+	Result result;
+
+	for (const Object &object : objects(grid, gap, threads)) {
+		result.objects++;
+		if (object.pattern == nullptr) {
+			result.unknown++;
+			result.counts["unknown"]++;
+			continue;
+		}
+
+		result.counts[object.pattern->name]++;
+		switch (object.pattern->kind) {
+			case Catalogue::Kind::STILL_LIFE:
+				result.still_lifes++;
+				break;
+			case Catalogue::Kind::OSCILLATOR:
+				result.oscillators++;
+				break;
+			case Catalogue::Kind::SPACESHIP:
+				result.spaceships++;
+				break;
+			case Catalogue::Kind::METHUSELAH:
+				result.methuselahs++;
+				break;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * operator<<(output_stream, result)
+ *
+ * Print a census as a summary line followed by one line per named object.
+ *
+ * @param output_stream - An ascii mode output stream such as std::cout.
+ * @param result - The census to print.
+ * @return Returns a reference to the output stream to enable operator chaining.
+ */
+std::ostream &operator<<(std::ostream &output_stream, const Census::Result &result) {
+	output_stream << "Objects " << result.objects <<
+		" | Still lifes " << result.still_lifes <<
+		" | Oscillators " << result.oscillators <<
+		" | Spaceships " << result.spaceships <<
+		" | Methuselahs " << result.methuselahs <<
+		" | Unknown " << result.unknown << std::endl;
+
+	for (const auto &count : result.counts) {
+		output_stream << "  " << count.first << ": " << count.second << std::endl;
+	}
+
+	return output_stream;
+}
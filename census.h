@@ -0,0 +1,53 @@
+/**
+ * Declares a Census namespace for splitting a Grid into separate objects and counting what they are.
+ * Rich documentation for the api and behaviour the Census namespace can be found in census.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+#include "grid.h"
+#include "catalogue.h"
+
+/**
+ * Declare the interface of the Census namespace for labelling and classifying objects.
+ */
+namespace Census {
+
+	/**
+	 * A connected group of alive cells.
+	 * The object spans the range [x0, x1) by [y0, y1) in the grid it was found in.
+	 * The pattern is nullptr if the object is not in the catalogue.
+	 */
+	struct Object {
+		int x0;
+		int y0;
+		int x1;
+		int y1;
+		unsigned int population;
+		const Catalogue::Pattern *pattern;
+		Grid cells;
+	};
+
+	/**
+	 * The counts of each kind and name of object found in a grid.
+	 */
+	struct Result {
+		unsigned int objects = 0;
+		unsigned int still_lifes = 0;
+		unsigned int oscillators = 0;
+		unsigned int spaceships = 0;
+		unsigned int methuselahs = 0;
+		unsigned int unknown = 0;
+		std::map<std::string, unsigned int> counts;
+	};
+
+	std::vector<Object> objects(const GridView &grid, int gap = 0, unsigned int threads = 0);
+	Result take(const GridView &grid, int gap = 0, unsigned int threads = 0);
+};
+
+std::ostream &operator<<(std::ostream &output_stream, const Census::Result &result);
@@ -0,0 +1,368 @@
+/**
+ * Implements a Changes namespace for recording which cells a step of a World changed.
+ *      - Renderers, recorders and census tools which only care about what a step changed would otherwise have to
+ *        compare every cell of the grid after every step. A step already reads the old and writes the new state
+ *        of every row, so it can note what changed as it goes, 64 cells at a time.
+ *
+ *      - A Set holds the changes of one step, at three levels of detail.
+ *          - A dirty flag per tile of tile_size x tile_size cells, for consumers which redraw or rescan by tile.
+ *          - The runs of rows which changed, for consumers which work a row at a time.
+ *          - The cells which were born and which died, in row order. Listing them can be turned off, since a
+ *            soup changes a large share of its cells every step.
+ *
+ *      - A World given a Set with World::set_changes fills it in on every step, and the step kernels fill in
+ *        one passed to them. Without one nothing is recorded, so the only cost is a null check per row.
+ *          - Threaded kernels record each band into a Set of its own and merge it into the step's when done.
+ *
+ *      - Coordinates are those of the grid or view which was stepped.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "changes.h"
+#include "grid.h"
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * Changes::Set::Set(tile_size, list_cells)
+ *
+ * Construct an empty change set for a 0x0 grid. The step it is given to sizes it with Changes::Set::reset.
+ *
+ * @example
+ *
+ *      // Find the 32x32 tiles each step of a world changes, without listing every cell
+ *      Changes::Set changes(32, false);
+ *      world.set_changes(&changes);
+ *
+ * @param tile_size
+ *      Optional parameter. The width and height in cells of each tile of the dirty bitmap. Defaults to 64.
+ *
+ * @param list_cells
+ *      Optional parameter. If false the born and died cells are not listed. Defaults to true.
+ *
+ * @throws
+ *      Throws std::runtime_error if the tile size is not positive.
+ */
+Changes::Set::Set(const int tile_size, const bool list_cells)
+		: tile_size(tile_size), listing(list_cells), width(0), height(0), tiles_across(0), tiles_down(0) {
+	if (tile_size <= 0) {
+		throw std::runtime_error(tile_size_not_positive_error + std::to_string(tile_size));
+	}
+}
+
+/**
+ * Changes::Set::reset(width, height)
+ *
+ * Forget every change and size the set for a step of a grid of the given size, with no tiles dirty.
+ * The buffers are kept, so resetting a set of the same size every step does not allocate.
+ *
+ * @param width
+ *      The width of the grid being stepped.
+ *
+ * @param height
+ *      The height of the grid being stepped.
+ */
+void Changes::Set::reset(const int width, const int height) {
+	this->width = std::max(0, width);
+	this->height = std::max(0, height);
+	this->tiles_across = (this->width + this->tile_size - 1) / this->tile_size;
+	this->tiles_down = (this->height + this->tile_size - 1) / this->tile_size;
+	this->dirty.assign(static_cast<std::size_t>(this->tiles_across) * this->tiles_down, 0);
+	this->rows.clear();
+	this->born.clear();
+	this->died.clear();
+}
+
+/**
+ * Append the cells of one word which are set in a mask to a list.
+ * @param x - The x coordinate of the first cell of the word.
+ * @param y - The row of the word.
+ * @param mask - Bit i is set if cell x + i is to be listed.
+ * @param cells - The list to append to.
+ */
+static void list_cells(const int x, const int y, std::uint64_t mask, std::vector<Changes::Point> &cells) {
+	while (mask) {
+		Changes::Point point;
+		point.x = x + __builtin_ctzll(mask);
+		point.y = y;
+		cells.push_back(point);
+		mask &= mask - 1;
+	}
+}
+
+/**
+ * Changes::Set::record_row(y, before, after)
+ *
+ * Record the changes to one row of a step, comparing its cells before and after 64 at a time.
+ * Rows must be recorded in increasing order, each at most once, within the size the set was reset to.
+ * This is called by the step as it goes, so a consumer only needs it to record a step of its own.
+ *
+ * @example
+ *
+ *      // Record the changes between two equally sized grids
+ *      changes.reset(before.get_width(), before.get_height());
+ *      for (int y = 0; y < before.get_height(); y++) {
+ *          changes.record_row<BitCells>(y, before.row(y), after.row(y));
+ *      }
+ *
+ * @param y
+ *      The row.
+ *
+ * @param before
+ *      The cells of the row before the step, in the storage of the grid.
+ *
+ * @param after
+ *      The cells of the row after the step.
+ */
+template <typename Storage>
+void Changes::Set::record_row(const int y, const typename Storage::Word *before, const typename Storage::Word *after) {
+	unsigned char *dirty_tiles = this->dirty.data() + static_cast<std::size_t>(y / this->tile_size) * this->tiles_across;
+	bool row_changed = false;
+
+	for (int x = 0; x < this->width; x += 64) {
+		const int count = std::min(64, this->width - x);
+		const std::uint64_t was_alive = Storage::load(before, x, count);
+		const std::uint64_t now_alive = Storage::load(after, x, count);
+		std::uint64_t changed = was_alive ^ now_alive;
+		if (changed == 0) {
+			continue;
+		}
+		row_changed = true;
+
+		if (this->listing) {
+			list_cells(x, y, now_alive & ~was_alive, this->born);
+			list_cells(x, y, was_alive & ~now_alive, this->died);
+		}
+
+		// Mark the tile of the first changed cell, then skip the rest of that tile
+		while (changed) {
+			const int tile = (x + __builtin_ctzll(changed)) / this->tile_size;
+			dirty_tiles[tile] = 1;
+			const int next_tile = (tile + 1) * this->tile_size - x;
+			changed = next_tile >= 64 ? 0 : changed & (~std::uint64_t(0) << next_tile);
+		}
+	}
+
+	if (row_changed) {
+		if (!this->rows.empty() && this->rows.back().end == y) {
+			this->rows.back().end = y + 1;
+		} else {
+			Rows run;
+			run.first = y;
+			run.end = y + 1;
+			this->rows.push_back(run);
+		}
+	}
+}
+
+/**
+ * Insert the cells of a band into a list in row order, where the band's rows are not in the list yet.
+ * @param cells - The list, sorted by row then column.
+ * @param band - The cells of the band, sorted the same way.
+ */
+static void insert_cells(std::vector<Changes::Point> &cells, const std::vector<Changes::Point> &band) {
+	if (band.empty()) {
+		return;
+	}
+	const auto position = std::lower_bound(cells.begin(), cells.end(), band.front(),
+			[](const Changes::Point &a, const Changes::Point &b) {
+		return a.y != b.y ? a.y < b.y : a.x < b.x;
+	});
+	cells.insert(position, band.begin(), band.end());
+}
+
+/**
+ * Changes::Set::merge(band)
+ *
+ * Add the changes a band of rows recorded into a set of its own to this set.
+ * The rows of the band must not have been recorded in this set already, but bands can be merged in any order.
+ * Runs of rows which meet across the edge of the band are joined.
+ *
+ * @param band
+ *      The changes of the band, reset to the same size and with the same tile size as this set.
+ *
+ * @throws
+ *      Throws std::runtime_error if the band is a different size or has different tiles.
+ */
+void Changes::Set::merge(const Set &band) {
+	if (band.width != this->width || band.height != this->height || band.tile_size != this->tile_size) {
+		throw std::runtime_error(merged_size_mismatch_error + std::to_string(band.width) + "x"
+								 + std::to_string(band.height) + " in tiles of " + std::to_string(band.tile_size));
+	}
+
+	for (std::size_t i = 0; i < this->dirty.size(); i++) {
+		this->dirty[i] |= band.dirty[i];
+	}
+
+	if (!band.rows.empty()) {
+		const auto position = std::lower_bound(this->rows.begin(), this->rows.end(), band.rows.front(),
+				[](const Rows &a, const Rows &b) {
+			return a.first < b.first;
+		});
+		this->rows.insert(position, band.rows.begin(), band.rows.end());
+
+		std::size_t kept = 0;
+		for (std::size_t i = 1; i < this->rows.size(); i++) {
+			if (this->rows[i].first <= this->rows[kept].end) {
+				this->rows[kept].end = std::max(this->rows[kept].end, this->rows[i].end);
+			} else {
+				this->rows[++kept] = this->rows[i];
+			}
+		}
+		this->rows.resize(kept + 1);
+	}
+
+	insert_cells(this->born, band.born);
+	insert_cells(this->died, band.died);
+}
+
+/**
+ * Changes::Set::get_width()
+ *
+ * @return
+ *      The width of the grid the set was last reset for.
+ */
+int Changes::Set::get_width() const {
+	return this->width;
+}
+
+/**
+ * Changes::Set::get_height()
+ *
+ * @return
+ *      The height of the grid the set was last reset for.
+ */
+int Changes::Set::get_height() const {
+	return this->height;
+}
+
+/**
+ * Changes::Set::get_tile_size()
+ *
+ * @return
+ *      The width and height in cells of each tile of the dirty bitmap.
+ */
+int Changes::Set::get_tile_size() const {
+	return this->tile_size;
+}
+
+/**
+ * Changes::Set::get_tiles_across()
+ *
+ * @return
+ *      The number of tiles across the grid, the last may be narrower than the tile size.
+ */
+int Changes::Set::get_tiles_across() const {
+	return this->tiles_across;
+}
+
+/**
+ * Changes::Set::get_tiles_down()
+ *
+ * @return
+ *      The number of tiles down the grid, the last may be shorter than the tile size.
+ */
+int Changes::Set::get_tiles_down() const {
+	return this->tiles_down;
+}
+
+/**
+ * Changes::Set::is_listing_cells()
+ *
+ * @return
+ *      True if the born and died cells are listed.
+ */
+bool Changes::Set::is_listing_cells() const {
+	return this->listing;
+}
+
+/**
+ * Changes::Set::empty()
+ *
+ * @return
+ *      True if the step changed no cells.
+ */
+bool Changes::Set::empty() const {
+	return this->rows.empty();
+}
+
+/**
+ * Changes::Set::is_dirty(tile_x, tile_y)
+ *
+ * @example
+ *
+ *      // Redraw only the tiles the last step changed
+ *      for (int ty = 0; ty < changes.get_tiles_down(); ty++) {
+ *          for (int tx = 0; tx < changes.get_tiles_across(); tx++) {
+ *              if (changes.is_dirty(tx, ty)) {
+ *                  redraw(tx * changes.get_tile_size(), ty * changes.get_tile_size());
+ *              }
+ *          }
+ *      }
+ *
+ * @param tile_x
+ *      The column of the tile.
+ *
+ * @param tile_y
+ *      The row of the tile.
+ *
+ * @return
+ *      True if any cell of the tile changed.
+ *
+ * @throws
+ *      Throws std::out_of_range if the tile is not within the tiles of the grid.
+ */
+bool Changes::Set::is_dirty(const int tile_x, const int tile_y) const {
+	if (tile_x < 0 || tile_x >= this->tiles_across || tile_y < 0 || tile_y >= this->tiles_down) {
+		throw std::out_of_range("(" + std::to_string(tile_x) + ", " + std::to_string(tile_y)
+								+ ") is not a valid tile within the change set");
+	}
+	return this->dirty[static_cast<std::size_t>(tile_y) * this->tiles_across + tile_x] != 0;
+}
+
+/**
+ * Changes::Set::count_dirty()
+ *
+ * @return
+ *      The number of tiles in which any cell changed.
+ */
+std::size_t Changes::Set::count_dirty() const {
+	return static_cast<std::size_t>(std::count(this->dirty.begin(), this->dirty.end(), 1));
+}
+
+/**
+ * Changes::Set::get_rows()
+ *
+ * @return
+ *      The runs of rows in which any cell changed, sorted, with a gap of at least one unchanged row between runs.
+ */
+const std::vector<Changes::Rows> & Changes::Set::get_rows() const {
+	return this->rows;
+}
+
+/**
+ * Changes::Set::get_born()
+ *
+ * @return
+ *      The cells which became alive, sorted by row then column. Empty if cells are not listed.
+ */
+const std::vector<Changes::Point> & Changes::Set::get_born() const {
+	return this->born;
+}
+
+/**
+ * Changes::Set::get_died()
+ *
+ * @return
+ *      The cells which became dead, sorted by row then column. Empty if cells are not listed.
+ */
+const std::vector<Changes::Point> & Changes::Set::get_died() const {
+	return this->died;
+}
+
+// Compile row recording for both layouts
+template void Changes::Set::record_row<ByteCells>(int y, const ByteCells::Word *before, const ByteCells::Word *after);
+template void Changes::Set::record_row<BitCells>(int y, const BitCells::Word *before, const BitCells::Word *after);
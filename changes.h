@@ -0,0 +1,80 @@
+/**
+ * Declares a Changes namespace for recording which cells a step of a World changed.
+ * Rich documentation for the api and behaviour the Changes namespace can be found in changes.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Declare the interface of the Changes namespace for the cells, rows and tiles a step changed.
+ */
+namespace Changes {
+
+	// Errors
+	const std::string tile_size_not_positive_error = "The tile size must be a positive integer: ";
+	const std::string merged_size_mismatch_error = "A change set can only merge a band of the same size and tiles: ";
+
+	/**
+	 * A cell which was born or died.
+	 */
+	struct Point {
+		int x = 0;
+		int y = 0;
+	};
+
+	/**
+	 * A run of rows which each changed, from first to one past the last.
+	 */
+	struct Rows {
+		int first = 0;
+		int end = 0;
+	};
+
+	/**
+	 * The changes of one step.
+	 *      - A dirty bitmap with one flag per tile of tile_size x tile_size cells.
+	 *      - The rows which changed, as sorted runs which neither overlap nor touch.
+	 *      - The cells which were born and which died, in row order, unless listing cells is turned off.
+	 */
+	class Set {
+	private:
+		int tile_size;
+		bool listing;
+		int width;
+		int height;
+		int tiles_across;
+		int tiles_down;
+		std::vector<unsigned char> dirty;
+		std::vector<Rows> rows;
+		std::vector<Point> born;
+		std::vector<Point> died;
+
+	public:
+		explicit Set(int tile_size = 64, bool list_cells = true);
+
+		void reset(int width, int height);
+		template <typename Storage>
+		void record_row(int y, const typename Storage::Word *before, const typename Storage::Word *after);
+		void merge(const Set &band);
+
+		int get_width() const;
+		int get_height() const;
+		int get_tile_size() const;
+		int get_tiles_across() const;
+		int get_tiles_down() const;
+		bool is_listing_cells() const;
+
+		bool empty() const;
+		bool is_dirty(int tile_x, int tile_y) const;
+		std::size_t count_dirty() const;
+		const std::vector<Rows> & get_rows() const;
+		const std::vector<Point> & get_born() const;
+		const std::vector<Point> & get_died() const;
+	};
+};
@@ -0,0 +1,570 @@
+/**
+ * Implements a Distributed namespace for stepping one world split across several processes.
+ *      - A world too large for one memory controller to stream can be split so that each process only
+ *        ever touches its own rectangle, which it allocates itself, so its pages land near where it runs.
+ *
+ *      - The world is split into columns by rows of rectangular subdomains, one per forked process.
+ *          - Each process steps its subdomain with the bit-packed kernel as a bounded grid of its own,
+ *            which is right everywhere except its outermost ring of cells.
+ *          - The ring is then stepped again from small strips padded with a one cell halo,
+ *            the neighbouring processes' edge rows, columns and corners.
+ *          - With toroidal set the subdomains on one edge of the world neighbour those on the opposite edge,
+ *            so the wrap spans processes exactly as a single toroidal step does.
+ *
+ *      - Halos are exchanged through an anonymous shared memory mapping made before the processes are forked.
+ *          - Each process writes its four edges into a buffer of its own, bit-packed, then bumps a published
+ *            generation counter. Neighbours wait for the counter to reach the generation they need.
+ *          - A process publishes its edges before stepping its interior, and only waits for its neighbours'
+ *            edges after, so the exchange overlaps the bulk of the work.
+ *          - Edge buffers alternate between two per process by generation. A process can only come back to a
+ *            buffer once every neighbour has published the generation after it, so has finished reading it.
+ *
+ *      - When every generation is done each process copies its subdomain into the mapping, and the calling
+ *        process, which only waits, assembles the result.
+ *          - A process which throws records its message and a failure flag. Its neighbours see the flag while
+ *            waiting and stop, and the call throws. A process killed outright is noticed when it is reaped.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "distributed.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "world.h"
+
+// The space for the message of a failed process
+static const std::size_t message_size = 256;
+
+/**
+ * The start of the shared mapping, followed by one Counter per process, then the edge buffers and results.
+ */
+struct Control {
+	std::atomic<int> failed;
+	char message[message_size];
+};
+
+/**
+ * The number of generations a process has published its edges for, on a cache line of its own.
+ */
+struct alignas(64) Counter {
+	std::atomic<std::uint64_t> published;
+};
+
+/**
+ * The cells a process owns, [x0, x0 + width) by [y0, y0 + height).
+ */
+struct Subdomain {
+	int x0;
+	int y0;
+	int width;
+	int height;
+};
+
+/**
+ * Where everything is in the shared mapping. Every process's buffers are sized for the largest subdomain.
+ */
+struct Segment {
+	unsigned char *base = nullptr;
+	std::size_t bytes = 0;
+	std::size_t row_words = 0;
+	std::size_t column_words = 0;
+	std::size_t edge_words = 0;
+	std::size_t result_words = 0;
+	std::size_t counters_offset = 0;
+	std::size_t edges_offset = 0;
+	std::size_t results_offset = 0;
+
+	Control & control() const {
+		return *reinterpret_cast<Control *>(base);
+	}
+
+	Counter & counter(const int rank) const {
+		return reinterpret_cast<Counter *>(base + counters_offset)[rank];
+	}
+
+	// The top row, bottom row, left column and right column of a process, for generations of one parity
+	BitCells::Word * edges(const int rank, const std::uint64_t generation) const {
+		auto *words = reinterpret_cast<BitCells::Word *>(base + edges_offset);
+		return words + (static_cast<std::size_t>(rank) * 2 + generation % 2) * edge_words;
+	}
+
+	BitCells::Word * result(const int rank) const {
+		return reinterpret_cast<BitCells::Word *>(base + results_offset) + rank * result_words;
+	}
+};
+
+/**
+ * The halo around a subdomain. north and south include the corners, so are width + 2 cells from x = -1.
+ */
+struct Halo {
+	std::vector<unsigned char> north;
+	std::vector<unsigned char> south;
+	std::vector<unsigned char> west;
+	std::vector<unsigned char> east;
+};
+
+/**
+ * Read one cell of a bit-packed run.
+ * @param words - The run.
+ * @param i - The cell.
+ * @return 1 if the cell is alive, 0 otherwise.
+ */
+static unsigned char bit(const BitCells::Word *words, const int i) {
+	return static_cast<unsigned char>((words[i >> 6] >> (i & 63)) & 1);
+}
+
+/**
+ * The subdomain of a process.
+ * @param layout - The split of the world.
+ * @param width - The width of the world.
+ * @param height - The height of the world.
+ * @param rank - The process, numbered along rows of subdomains.
+ * @return The cells the process owns.
+ */
+static Subdomain subdomain(const Distributed::Layout &layout, const int width, const int height, const int rank) {
+	const long long column = rank % layout.columns;
+	const long long row = rank / layout.columns;
+	Subdomain owned;
+	owned.x0 = static_cast<int>(width * column / layout.columns);
+	owned.y0 = static_cast<int>(height * row / layout.rows);
+	owned.width = static_cast<int>(width * (column + 1) / layout.columns) - owned.x0;
+	owned.height = static_cast<int>(height * (row + 1) / layout.rows) - owned.y0;
+	return owned;
+}
+
+/**
+ * The process owning the subdomain offset from another by one step in each direction.
+ * @param layout - The split of the world.
+ * @param rank - The process.
+ * @param dx - -1, 0 or 1 subdomains across.
+ * @param dy - -1, 0 or 1 subdomains down.
+ * @param toroidal - Whether subdomains on opposite edges of the world neighbour each other.
+ * @return The neighbouring process, or -1 beyond the edge of a bounded world.
+ */
+static int neighbour(const Distributed::Layout &layout, const int rank, const int dx, const int dy, const bool toroidal) {
+	const int columns = static_cast<int>(layout.columns);
+	const int rows = static_cast<int>(layout.rows);
+	int column = rank % columns + dx;
+	int row = rank / columns + dy;
+	if (!toroidal && (column < 0 || column >= columns || row < 0 || row >= rows)) {
+		return -1;
+	}
+	column = (column + columns) % columns;
+	row = (row + rows) % rows;
+	return row * columns + column;
+}
+
+/**
+ * Wait for a neighbour to publish its edges for a generation, spinning politely.
+ * @param segment - The shared mapping.
+ * @param rank - The neighbour.
+ * @param generations - The number of generations it must have published.
+ *
+ * @throws - std::runtime_error if any process fails while waiting.
+ */
+static void wait_for(const Segment &segment, const int rank, const std::uint64_t generations) {
+	while (segment.counter(rank).published.load(std::memory_order_acquire) < generations) {
+		if (segment.control().failed.load(std::memory_order_relaxed)) {
+			throw std::runtime_error(Distributed::process_failed_error + "a neighbour stopped");
+		}
+		sched_yield();
+	}
+}
+
+/**
+ * Write the four edges of a subdomain, bit-packed, into its buffer.
+ * @param grid - The subdomain.
+ * @param segment - The shared mapping.
+ * @param edges - The buffer.
+ */
+static void write_edges(const BitGrid &grid, const Segment &segment, BitCells::Word *edges) {
+	const int width = grid.get_width();
+	const int height = grid.get_height();
+	BitCells::Word *top = edges;
+	BitCells::Word *bottom = top + segment.row_words;
+	BitCells::Word *left = bottom + segment.row_words;
+	BitCells::Word *right = left + segment.column_words;
+
+	for (int x = 0; x < width; x += 64) {
+		const int count = std::min(64, width - x);
+		top[x / 64] = BitCells::load(grid.row(0), x, count);
+		bottom[x / 64] = BitCells::load(grid.row(height - 1), x, count);
+	}
+	std::fill(left, left + segment.column_words, 0);
+	std::fill(right, right + segment.column_words, 0);
+	for (int y = 0; y < height; y++) {
+		left[y >> 6] |= BitCells::load(grid.row(y), 0, 1) << (y & 63);
+		right[y >> 6] |= BitCells::load(grid.row(y), width - 1, 1) << (y & 63);
+	}
+}
+
+/**
+ * Gather the halo of a subdomain from its neighbours' edge buffers. Missing neighbours leave it dead.
+ * @param segment - The shared mapping.
+ * @param layout - The split of the world.
+ * @param width - The width of the world.
+ * @param height - The height of the world.
+ * @param rank - The process whose halo it is.
+ * @param generation - The generation the edges were published for.
+ * @param toroidal - Whether the world wraps.
+ * @param halo - The halo, sized for the subdomain.
+ */
+static void gather_halo(const Segment &segment, const Distributed::Layout &layout, const int width, const int height,
+						const int rank, const std::uint64_t generation, const bool toroidal, Halo &halo) {
+	const Subdomain owned = subdomain(layout, width, height, rank);
+	std::fill(halo.north.begin(), halo.north.end(), 0);
+	std::fill(halo.south.begin(), halo.south.end(), 0);
+	std::fill(halo.west.begin(), halo.west.end(), 0);
+	std::fill(halo.east.begin(), halo.east.end(), 0);
+
+	for (int dy = -1; dy <= 1; dy++) {
+		for (int dx = -1; dx <= 1; dx++) {
+			const int other = (dx != 0 || dy != 0) ? neighbour(layout, rank, dx, dy, toroidal) : -1;
+			if (other < 0) {
+				continue;
+			}
+
+			const Subdomain theirs = subdomain(layout, width, height, other);
+			const BitCells::Word *top = segment.edges(other, generation);
+			const BitCells::Word *bottom = top + segment.row_words;
+			const BitCells::Word *left = bottom + segment.row_words;
+			const BitCells::Word *right = left + segment.column_words;
+
+			// Above takes their bottom row, below their top row, and either side their facing column
+			const BitCells::Word *row = dy < 0 ? bottom : top;
+			std::vector<unsigned char> &target = dy < 0 ? halo.north : halo.south;
+			if (dy != 0 && dx == 0) {
+				for (int x = 0; x < owned.width; x++) {
+					target[x + 1] = bit(row, x);
+				}
+			} else if (dy != 0) {
+				target[dx < 0 ? 0 : owned.width + 1] = bit(row, dx < 0 ? theirs.width - 1 : 0);
+			} else {
+				const BitCells::Word *column = dx < 0 ? right : left;
+				std::vector<unsigned char> &side = dx < 0 ? halo.west : halo.east;
+				for (int y = 0; y < owned.height; y++) {
+					side[y] = bit(column, y);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Step the outermost ring of a subdomain again, now its halo is known, from strips one cell wider than the ring.
+ * @param current - The subdomain before the step.
+ * @param halo - The halo around it.
+ * @param strips - Buffers for the padded strips and their steps, reused between generations.
+ * @param next - The subdomain after the step, whose ring is overwritten.
+ */
+static void step_ring(const BitGrid &current, const Halo &halo, BitGrid (&strips)[2], BitGrid &next) {
+	const int width = current.get_width();
+	const int height = current.get_height();
+
+	// Any cell from (-1, -1) to (width, height)
+	auto cell = [&](const int x, const int y) -> unsigned char {
+		if (y < 0) {
+			return halo.north[x + 1];
+		}
+		if (y >= height) {
+			return halo.south[x + 1];
+		}
+		if (x < 0) {
+			return halo.west[y];
+		}
+		if (x >= width) {
+			return halo.east[y];
+		}
+		return static_cast<unsigned char>(BitCells::load(current.row(y), x, 1));
+	};
+
+	// The top and bottom rows from strips of three padded rows
+	for (const int y : {0, height - 1}) {
+		BitGrid &strip = strips[0];
+		if (strip.get_width() != width + 2 || strip.get_height() != 3) {
+			strip = BitGrid(width + 2, 3);
+		}
+		for (int dy = 0; dy < 3; dy++) {
+			for (int x = -1; x <= width; x++) {
+				BitCells::store(strip.row(dy), x + 1, 1, cell(x, y + dy - 1));
+			}
+		}
+		BitWorld::step(strip, strips[1]);
+		for (int x = 0; x < width; x += 64) {
+			BitCells::store(next.row(y), x, std::min(64, width - x), BitCells::load(strips[1].row(1), x + 1, std::min(64, width - x)));
+		}
+	}
+
+	// The left and right columns from strips of three padded columns
+	for (const int x : {0, width - 1}) {
+		BitGrid &strip = strips[0];
+		if (strip.get_width() != 3 || strip.get_height() != height + 2) {
+			strip = BitGrid(3, height + 2);
+		}
+		for (int y = -1; y <= height; y++) {
+			for (int dx = 0; dx < 3; dx++) {
+				BitCells::store(strip.row(y + 1), dx, 1, cell(x + dx - 1, y));
+			}
+		}
+		BitWorld::step(strip, strips[1]);
+		for (int y = 0; y < height; y++) {
+			BitCells::store(next.row(y), x, 1, BitCells::load(strips[1].row(y + 1), 1, 1));
+		}
+	}
+}
+
+/**
+ * Step the subdomain of one process, exchanging halos with its neighbours, and leave it in the shared mapping.
+ * @param segment - The shared mapping.
+ * @param initial - The whole world.
+ * @param layout - The split of the world.
+ * @param rank - The process.
+ * @param steps - The number of generations.
+ * @param options - The threads and wrapping.
+ */
+static void step_subdomain(const Segment &segment, const BitGridView &initial, const Distributed::Layout &layout,
+						   const int rank, const int steps, const Distributed::Options &options) {
+	const int width = initial.get_width();
+	const int height = initial.get_height();
+	const Subdomain owned = subdomain(layout, width, height, rank);
+
+	// Allocated here, after the fork, so the subdomain is only ever in this process's memory
+	BitGrid current = initial.crop(owned.x0, owned.y0, owned.x0 + owned.width, owned.y0 + owned.height).materialize();
+	BitGrid next(owned.width, owned.height);
+	BitGrid strips[2];
+	Halo halo;
+	halo.north.resize(owned.width + 2);
+	halo.south.resize(owned.width + 2);
+	halo.west.resize(owned.height);
+	halo.east.resize(owned.height);
+
+	for (std::uint64_t generation = 0; generation < static_cast<std::uint64_t>(steps); generation++) {
+		write_edges(current, segment, segment.edges(rank, generation));
+		segment.counter(rank).published.store(generation + 1, std::memory_order_release);
+
+		// The interior does not need the halo, so it is stepped while the neighbours publish theirs
+		BitWorld::step(current, next, false, options.threads);
+
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				const int other = (dx != 0 || dy != 0) ? neighbour(layout, rank, dx, dy, options.toroidal) : -1;
+				if (other >= 0) {
+					wait_for(segment, other, generation + 1);
+				}
+			}
+		}
+		gather_halo(segment, layout, width, height, rank, generation, options.toroidal, halo);
+		step_ring(current, halo, strips, next);
+		std::swap(current, next);
+	}
+
+	BitCells::Word *result = segment.result(rank);
+	for (int y = 0; y < owned.height; y++) {
+		std::copy(current.row(y), current.row(y) + (owned.width + 63) / 64, result + y * segment.row_words);
+	}
+}
+
+/**
+ * Distributed::layout(options, width, height)
+ *
+ * Choose how to split a world between processes.
+ * Unless columns and rows are both given, the factorisation of processes into columns by rows which cuts
+ * the world along the fewest cells is chosen, so the least halo is exchanged.
+ *
+ * @example
+ *
+ *      // 4 processes on a wide world split it into 4 columns
+ *      Distributed::Options options;
+ *      options.processes = 4;
+ *      Distributed::Layout split = Distributed::layout(options, 4096, 256);
+ *
+ * @param options
+ *      The number of processes, or the columns and rows to use.
+ *
+ * @param width
+ *      The width of the world.
+ *
+ * @param height
+ *      The height of the world.
+ *
+ * @return
+ *      The columns and rows of subdomains.
+ *
+ * @throws
+ *      std::runtime_error if some subdomain would have no cells.
+ */
+Distributed::Layout Distributed::layout(const Options &options, const int width, const int height) {
+	Layout split;
+	if (options.columns > 0 && options.rows > 0) {
+		split.columns = options.columns;
+		split.rows = options.rows;
+	} else {
+		const unsigned int processes = std::max(options.processes, 1u);
+		std::uint64_t best = UINT64_MAX;
+		for (unsigned int columns = 1; columns <= processes; columns++) {
+			if (processes % columns != 0) {
+				continue;
+			}
+			const unsigned int rows = processes / columns;
+			const std::uint64_t cut = static_cast<std::uint64_t>(columns - 1) * height + static_cast<std::uint64_t>(rows - 1) * width;
+			if (columns <= static_cast<unsigned int>(std::max(width, 0)) && rows <= static_cast<unsigned int>(std::max(height, 0)) && cut < best) {
+				best = cut;
+				split.columns = columns;
+				split.rows = rows;
+			}
+		}
+	}
+
+	if (split.columns > static_cast<unsigned int>(std::max(width, 0)) || split.rows > static_cast<unsigned int>(std::max(height, 0))) {
+		throw std::runtime_error(too_many_processes_error + std::to_string(split.columns) + " x " +
+								 std::to_string(split.rows) + " for " + std::to_string(width) + " x " + std::to_string(height));
+	}
+	return split;
+}
+
+/**
+ * Distributed::run(initial, steps, options)
+ *
+ * Step a world a number of generations split across forked processes, as BitWorld::step would in one.
+ * The calling process only forks, waits and assembles the result, so it should not hold locks other
+ * threads need while the processes run.
+ *
+ * @example
+ *
+ *      // Step a large soup for 1000 generations on a torus, split across 4 processes
+ *      Distributed::Options options;
+ *      options.processes = 4;
+ *      options.toroidal = true;
+ *      BitGrid result = Distributed::run(BitGrid(Zoo::load_ascii("path/to/file.gol")), 1000, options);
+ *
+ * @param initial
+ *      The world to step.
+ *
+ * @param steps
+ *      The number of generations.
+ *
+ * @param options
+ *      How to split and step the world.
+ *
+ * @return
+ *      The world after the given number of generations.
+ *
+ * @throws
+ *      std::runtime_error if some subdomain would have no cells, if the processes cannot be started,
+ *      or if any of them fails.
+ */
+BitGrid Distributed::run(const BitGridView &initial, const int steps, const Options &options) {
+	const int width = initial.get_width();
+	const int height = initial.get_height();
+	const Layout split = layout(options, width, height);
+	const int processes = static_cast<int>(split.columns * split.rows);
+
+	// Every buffer is sized for the largest subdomain, which is the first on each axis to be rounded up
+	const Subdomain largest = subdomain(split, width, height, 0);
+	const int largest_width = std::max(largest.width, (width + static_cast<int>(split.columns) - 1) / static_cast<int>(split.columns));
+	const int largest_height = std::max(largest.height, (height + static_cast<int>(split.rows) - 1) / static_cast<int>(split.rows));
+
+	Segment segment;
+	segment.row_words = (static_cast<std::size_t>(largest_width) + 63) / 64;
+	segment.column_words = (static_cast<std::size_t>(largest_height) + 63) / 64;
+	segment.edge_words = 2 * segment.row_words + 2 * segment.column_words;
+	segment.result_words = segment.row_words * largest_height;
+	segment.counters_offset = (sizeof(Control) + 63) / 64 * 64;
+	segment.edges_offset = segment.counters_offset + processes * sizeof(Counter);
+	segment.results_offset = segment.edges_offset + processes * 2 * segment.edge_words * sizeof(BitCells::Word);
+	segment.bytes = segment.results_offset + processes * segment.result_words * sizeof(BitCells::Word);
+
+	void *memory = mmap(nullptr, segment.bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (memory == MAP_FAILED) {
+		throw std::runtime_error(process_error + "mmap: " + std::strerror(errno));
+	}
+	segment.base = static_cast<unsigned char *>(memory);
+	new (&segment.control()) Control();
+	for (int rank = 0; rank < processes; rank++) {
+		new (&segment.counter(rank)) Counter();
+	}
+
+	// Children never return, so they do not flush the caller's buffers or run its destructors twice
+	std::vector<pid_t> children;
+	std::string failure;
+	for (int rank = 0; rank < processes; rank++) {
+		const pid_t child = fork();
+		if (child == 0) {
+			int status = 0;
+			try {
+				step_subdomain(segment, initial, split, rank, steps, options);
+			}
+			catch (const std::exception &ex) {
+				Control &control = segment.control();
+				if (control.failed.exchange(1) == 0) {
+					std::strncpy(control.message, ex.what(), message_size - 1);
+				}
+				status = 1;
+			}
+			_exit(status);
+		}
+		if (child < 0) {
+			failure = process_error + "fork: " + std::strerror(errno);
+			segment.control().failed.store(1);
+			break;
+		}
+		children.push_back(child);
+	}
+
+	// A child which dies without recording a failure must still stop its neighbours waiting, so each is polled
+	while (!children.empty()) {
+		bool reaped = false;
+		for (std::size_t i = 0; i < children.size(); i++) {
+			int status = 0;
+			const pid_t child = waitpid(children[i], &status, WNOHANG);
+			if (child == 0) {
+				continue;
+			}
+			if (child < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+				if (segment.control().failed.exchange(1) == 0) {
+					failure = process_failed_error + "process " + std::to_string(children[i]) + " was killed";
+				}
+			}
+			children.erase(children.begin() + i);
+			reaped = true;
+			break;
+		}
+		if (!reaped) {
+			usleep(1000);
+		}
+	}
+
+	if (segment.control().failed.load()) {
+		if (failure.empty()) {
+			failure = process_failed_error + segment.control().message;
+		}
+		munmap(memory, segment.bytes);
+		throw std::runtime_error(failure);
+	}
+
+	BitGrid result(width, height);
+	for (int rank = 0; rank < processes; rank++) {
+		const Subdomain owned = subdomain(split, width, height, rank);
+		const BitCells::Word *cells = segment.result(rank);
+		for (int y = 0; y < owned.height; y++) {
+			const BitCells::Word *row = cells + y * segment.row_words;
+			for (int x = 0; x < owned.width; x += 64) {
+				const int count = std::min(64, owned.width - x);
+				BitCells::store(result.row(owned.y0 + y), owned.x0 + x, count, BitCells::load(row, x, count));
+			}
+		}
+	}
+
+	munmap(memory, segment.bytes);
+	return result;
+}
@@ -0,0 +1,48 @@
+/**
+ * Declares a Distributed namespace for stepping one world split across several processes.
+ * Rich documentation for the api, decomposition and behaviour of the Distributed namespace can be found in distributed.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <string>
+#include "grid.h"
+
+/**
+ * Declare the interface of the Distributed namespace for domain decomposition with halo exchange.
+ */
+namespace Distributed {
+
+	// Errors
+	const std::string too_many_processes_error = "Every process needs at least one row and column of the world: ";
+	const std::string process_error = "Process error: ";
+	const std::string process_failed_error = "A subdomain process failed: ";
+
+	/**
+	 * How a world is split and stepped.
+	 *      - processes each own one rectangle of the world, columns by rows of them.
+	 *        If columns and rows are 0 they are chosen so the rectangles are as square as possible.
+	 *      - threads step each rectangle with the bit-packed kernel.
+	 */
+	struct Options {
+		unsigned int processes = 2;
+		unsigned int columns = 0;
+		unsigned int rows = 0;
+		unsigned int threads = 1;
+		bool toroidal = false;
+	};
+
+	/**
+	 * How a world of width by height cells is split into columns by rows of subdomains.
+	 */
+	struct Layout {
+		unsigned int columns = 1;
+		unsigned int rows = 1;
+	};
+
+	Layout layout(const Options &options, int width, int height);
+
+	BitGrid run(const BitGridView &initial, int steps, const Options &options = Options());
+};
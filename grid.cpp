@@ -1,11 +1,25 @@
 /**
  * Implements a class representing a 2d grid of cells.
  *      - New cells are initialized to Cell::DEAD.
+ *      - Cells are allocated by a Memory::Policy, the default policy unless one is given.
  *      - Grids can be resized while retaining their contents in the remaining area.
- *      - Grids can be rotated, cropped, and merged together.
+ *          - Resizing happens in place around a chosen anchor, reusing any capacity reserved in advance.
+ *      - Grids can be rotated, flipped, cropped, and merged together.
+ *          - Merges can overwrite or blend cells with OR, AND, XOR and AND NOT, a whole row at a time.
+ *          - All 8 rotations and reflections are done with row copies or cache blocked transposes.
  *      - Grids can return counts of the alive and dead cells.
  *      - Grids can be serialized directly to an ascii std::ostream.
  *
+ *      - GridViews are read-only windows onto the cells of a Grid.
+ *          - Views and sub-views are made without copying, rows are a stride apart.
+ *          - Views can be counted, hashed, printed, merged and materialized into a new Grid.
+ *
+ *      - Grid and GridView are the one byte per cell instances of the BasicGrid and BasicGridView templates.
+ *          - The template parameter is a storage policy which packs cells into words and supplies the kernels
+ *            for counting, merging, moving, transforming and printing runs of cells.
+ *          - BitGrid packs 64 cells into each word using the BitCells policy, with the same api.
+ *          - Both layouts are compiled here once, so hot loops call their own kernels directly.
+ *
  * You are encouraged to use STL container types as an underlying storage mechanism for the grid cells.
  *
  * @author **REMOVED**
@@ -15,10 +29,27 @@
 #include <sstream>
 #include <vector>
 #include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // Include the minimal number of headers needed to support your implementation.
 // #include ...
 
+/**
+ * The number of words a row of cells takes up.
+ * @param width - The number of cells in the row.
+ * @return The number of words, rounded up.
+ */
+template <typename Storage>
+static std::size_t words_per_row(const int width) {
+	return (static_cast<std::size_t>(width) + Storage::cells_per_word - 1) / Storage::cells_per_word;
+}
+
 /**
  * Grid::Grid()
  *
@@ -31,7 +62,8 @@
  *      Grid grid;
  *
  */
-Grid::Grid() : Grid(0) {
+template <typename Storage>
+BasicGrid<Storage>::BasicGrid() : BasicGrid(0) {
 }
 
 /**
@@ -57,7 +89,8 @@ Grid::Grid() : Grid(0) {
  * @param square_size
  *      The edge size to use for the width and height of the grid.
  */
-Grid::Grid(const int gridSize) : Grid(gridSize, gridSize) {
+template <typename Storage>
+BasicGrid<Storage>::BasicGrid(const int gridSize) : BasicGrid(gridSize, gridSize) {
 }
 
 /**
@@ -76,10 +109,107 @@ Grid::Grid(const int gridSize) : Grid(gridSize, gridSize) {
  * @param height
  *      The height of the grid.
  */
-Grid::Grid(int width, int height) : grid_height(height), grid_width(width) {
+template <typename Storage>
+BasicGrid<Storage>::BasicGrid(const int width, const int height)
+	: BasicGrid(width, height, Memory::get_default_policy()) {
+}
+
+/**
+ * Grid::Grid(width, height, policy)
+ *
+ * Construct a grid with the desired size filled with dead cells, with its cells allocated by a chosen policy
+ * instead of the default policy. Copies of the grid use the same policy.
+ *
+ * @example
+ *
+ *      // Make a 16384x16384 grid backed by transparent huge pages
+ *      Grid grid(16384, 16384, Memory::Policy::HUGE_PAGES);
+ *
+ * @param width
+ *      The width of the grid.
+ *
+ * @param height
+ *      The height of the grid.
+ *
+ * @param policy
+ *      Where to allocate the cells from.
+ */
+template <typename Storage>
+BasicGrid<Storage>::BasicGrid(int width, int height, const Memory::Policy policy) {
 	zero_values_if_negative(width, height);
-    std::vector<Cell> temp_grid(width * height, Cell::DEAD);
+	const std::size_t words = static_cast<std::size_t>(height) * words_per_row<Storage>(width);
+    std::vector<Word, Memory::Allocator<Word>> temp_grid(words, Storage::dead_word, Memory::Allocator<Word>(policy));
     this->grid.swap(temp_grid);
+    this->grid_height = height;
+    this->grid_width = width;
+}
+
+/**
+ * Grid::Grid(other)
+ *
+ * Construct a grid holding the same cells as a grid with a different storage layout,
+ * converting 64 cells at a time. The new grid uses the same allocation policy.
+ *
+ * @example
+ *
+ *      // Pack a grid 64 cells to a word, then unpack it again
+ *      Grid grid = Zoo::glider();
+ *      BitGrid packed(grid);
+ *      Grid unpacked(packed);
+ *
+ * @param other
+ *      The grid to convert.
+ */
+template <typename Storage>
+template <typename Other>
+BasicGrid<Storage>::BasicGrid(const BasicGrid<Other> &other)
+	: BasicGrid(other.get_width(), other.get_height(), other.get_policy()) {
+	for (int y = 0; y < this->grid_height; y++) {
+		for (int x = 0; x < this->grid_width; x += 64) {
+			const int count = std::min(64, this->grid_width - x);
+			Storage::store(row(y), x, count, Other::load(other.row(y), x, count));
+		}
+	}
+}
+
+/**
+ * Grid::Grid(other), Grid::operator=(other)
+ *
+ * Move a grid, taking its cells without copying them.
+ * The moved from grid is left as an empty 0x0 grid, since the cell count comes from its width and height
+ * rather than the size of its buffer.
+ *
+ * @example
+ *
+ *      // Hand a grid to a world without copying its cells
+ *      Grid grid(300, 300);
+ *      World world(std::move(grid));
+ *
+ *      // Prints 0
+ *      std::cout << grid.get_total_cells() << std::endl;
+ *
+ * @param other
+ *      The grid to move from.
+ */
+template <typename Storage>
+BasicGrid<Storage>::BasicGrid(BasicGrid &&other) noexcept
+	: grid(std::move(other.grid)), grid_height(other.grid_height), grid_width(other.grid_width) {
+	other.grid.clear();
+	other.grid_height = 0;
+	other.grid_width = 0;
+}
+
+template <typename Storage>
+BasicGrid<Storage>& BasicGrid<Storage>::operator=(BasicGrid &&other) noexcept {
+	if (this != &other) {
+		this->grid = std::move(other.grid);
+		this->grid_height = other.grid_height;
+		this->grid_width = other.grid_width;
+		other.grid.clear();
+		other.grid_height = 0;
+		other.grid_width = 0;
+	}
+	return *this;
 }
 
 /**
@@ -105,7 +235,8 @@ Grid::Grid(int width, int height) : grid_height(height), grid_width(width) {
  * @return
  *      The width of the grid.
  */
-int Grid::get_width() const {
+template <typename Storage>
+int BasicGrid<Storage>::get_width() const {
     return this->grid_width;
 }
 
@@ -132,7 +263,8 @@ int Grid::get_width() const {
  * @return
  *      The height of the grid.
  */
-int Grid::get_height() const {
+template <typename Storage>
+int BasicGrid<Storage>::get_height() const {
     return this->grid_height;
 }
 
@@ -159,8 +291,9 @@ int Grid::get_height() const {
  * @return
  *      The number of total cells.
  */
-unsigned int Grid::get_total_cells() const {
-    return this->grid.size();
+template <typename Storage>
+unsigned int BasicGrid<Storage>::get_total_cells() const {
+    return this->grid_width * this->grid_height;
 }
 
 /**
@@ -186,14 +319,29 @@ unsigned int Grid::get_total_cells() const {
  * @return
  *      The number of alive cells.
  */
-unsigned int Grid::get_alive_cells() const {
-	unsigned int total = 0;
-    for (char i : this->grid) {
-        if (i == Cell::ALIVE) {
-            total += 1;
-        }
-    }
-    return total;
+template <typename Storage>
+unsigned int BasicGrid<Storage>::get_alive_cells() const {
+	return view().get_alive_cells();
+}
+
+/**
+ * Grid::hash()
+ *
+ * Hash the size and cells of the grid, see GridView::hash().
+ *
+ * @example
+ *
+ *      // Two engines agree if their states hash the same
+ *      if (world.get_state().hash() != bit_grid.hash()) {
+ *          std::cout << "Diverged" << std::endl;
+ *      }
+ *
+ * @return
+ *      The 64 bit hash of the grid.
+ */
+template <typename Storage>
+std::uint64_t BasicGrid<Storage>::hash() const {
+	return view().hash();
 }
 
 /**
@@ -219,10 +367,25 @@ unsigned int Grid::get_alive_cells() const {
  * @return
  *      The number of dead cells.
  */
-unsigned int Grid::get_dead_cells() const {
+template <typename Storage>
+unsigned int BasicGrid<Storage>::get_dead_cells() const {
     return this->get_total_cells() - this->get_alive_cells();
 }
 
+/**
+ * Grid::get_policy()
+ *
+ * Gets the allocation policy the cells of the grid were allocated by.
+ * The function should be callable from a constant context.
+ *
+ * @return
+ *      The allocation policy of the grid.
+ */
+template <typename Storage>
+Memory::Policy BasicGrid<Storage>::get_policy() const {
+	return this->grid.get_allocator().policy();
+}
+
 /**
  * Grid::resize(square_size)
  *
@@ -240,7 +403,8 @@ unsigned int Grid::get_dead_cells() const {
  * @param square_size
  *      The new edge size for both the width and height of the grid.
  */
-void Grid::resize(const int square_size) {
+template <typename Storage>
+void BasicGrid<Storage>::resize(const int square_size) {
     resize(square_size, square_size);
 }
 
@@ -258,68 +422,242 @@ void Grid::resize(const int square_size) {
  *      // Resize the grid to be 2x8
  *      grid.resize(2, 8);
  *
+ * The content stays anchored to the top left corner, see Grid::resize(width, height, anchor).
+ *
+ * @param new_width
+ *      The new width for the grid.
+ *
+ * @param new_height
+ *      The new height for the grid.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::resize(const int width, const int height) {
+	resize(width, height, 0, 0);
+}
+
+/**
+ * Grid::resize(width, height, anchor)
+ *
+ * Resize the current grid to a new width and height, keeping the content pinned to a chosen anchor.
+ * Growing around Anchor::CENTRE pads every side equally, shrinking around it trims every side equally.
+ * Any odd cell goes to the right or bottom edge.
+ *
+ * @example
+ *
+ *      // Make a grid
+ *      Grid grid(4, 4);
+ *
+ *      // Grow the grid to 8x8 with the original 4x4 in the middle
+ *      grid.resize(8, 8, Anchor::CENTRE);
+ *
+ * @param new_width
+ *      The new width for the grid.
+ *
+ * @param new_height
+ *      The new height for the grid.
+ *
+ * @param anchor
+ *      The point of the grid which stays fixed.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::resize(int width, int height, const Anchor anchor) {
+	zero_values_if_negative(width, height);
+
+	int x_offset = 0;
+	int y_offset = 0;
+
+	// Horizontal part of the anchor
+	if (anchor == Anchor::TOP || anchor == Anchor::CENTRE || anchor == Anchor::BOTTOM) {
+		x_offset = (width - this->get_width()) / 2;
+	} else if (anchor == Anchor::TOP_RIGHT || anchor == Anchor::RIGHT || anchor == Anchor::BOTTOM_RIGHT) {
+		x_offset = width - this->get_width();
+	}
+
+	// Vertical part of the anchor
+	if (anchor == Anchor::LEFT || anchor == Anchor::CENTRE || anchor == Anchor::RIGHT) {
+		y_offset = (height - this->get_height()) / 2;
+	} else if (anchor == Anchor::BOTTOM_LEFT || anchor == Anchor::BOTTOM || anchor == Anchor::BOTTOM_RIGHT) {
+		y_offset = height - this->get_height();
+	}
+
+	resize(width, height, x_offset, y_offset);
+}
+
+/**
+ * Grid::resize(width, height, x_offset, y_offset)
+ *
+ * Resize the current grid to a new width and height, moving the old content so its top left corner
+ * lands on x_offset, y_offset in the resized grid. Offsets may be negative to trim the top or left.
+ * Content that lands outside the new size is dropped and uncovered cells are padded with Cell::DEAD.
+ *
+ * The grid is resized in place. Rows are moved with memmove in an order that never overwrites a row
+ * before it has been moved, so no second buffer is needed. If the grid has already reserved enough
+ * capacity with Grid::reserve(cells) no allocation happens at all, otherwise the capacity grows by at least
+ * half again so a run of small grow operations is amortized.
+ *
+ * @example
+ *
+ *      // Make a grid
+ *      Grid grid(4, 4);
+ *
+ *      // Grow the grid by 2 cells on the left and 1 on top
+ *      grid.resize(6, 5, 2, 1);
+ *
  * @param new_width
  *      The new width for the grid.
  *
  * @param new_height
  *      The new height for the grid.
+ *
+ * @param x_offset
+ *      Where the old left edge lands in the resized grid.
+ *
+ * @param y_offset
+ *      Where the old top edge lands in the resized grid.
  */
-void Grid::resize(int width, int height) {
+template <typename Storage>
+void BasicGrid<Storage>::resize(int width, int height, const int x_offset, const int y_offset) {
 
 	// Zeroing negative values as resizing a grid with negative values will just destroy it.
 	zero_values_if_negative(width, height);
 
-	// Create new grid to copy old grid in to
-	const unsigned int new_grid_size = width * height;
-    std::vector<Cell > new_grid;
-    new_grid.assign(new_grid_size, Cell::DEAD);
-
-    int new_grid_width;
-    int new_grid_height;
-
-    // Set variables depending if grid is being made smaller or bigger
-    if (this->get_width() < width) {	// Making bigger than original
-        new_grid_width = this->get_width();
-		new_grid_height = this->get_height();
-    } else {						// Making grid smaller
-        new_grid_height = height;
-		new_grid_width = width;
-    }
-
-    // Loop over new grid and copy elements from old grid to new grid
-    // First check if grid is size 0
-    if (this->get_width() != 0 && this->get_height() != 0) {
-        for (int y = 0; y < new_grid_height; y++) {
-        	for (int x = 0; x < new_grid_width; x++) {
-				new_grid[y * width + x] = this->get(x, y);
+	const int old_width = this->get_width();
+	const int old_height = this->get_height();
+	const std::size_t old_stride = this->get_stride();
+	const std::size_t new_stride = words_per_row<Storage>(width);
+	const std::size_t old_size = this->grid.size();
+	const std::size_t new_size = new_stride * height;
+
+	// Grow geometrically when out of room, so repeated grow operations only occasionally reallocate
+	if (new_size > this->grid.capacity()) {
+		this->grid.reserve(std::max(new_size, this->grid.capacity() + this->grid.capacity() / 2));
+	}
+	if (new_size > old_size) {
+		this->grid.resize(new_size, Storage::dead_word);
+	}
+
+	// The part of each old row which is kept, and the old rows which are kept
+	const int first_x = std::max(0, -x_offset);
+	const int end_x = std::min(old_width, width - x_offset);
+	const int first_y = std::max(0, -y_offset);
+	const int end_y = std::min(old_height, height - y_offset);
+	const int kept_width = std::max(0, end_x - first_x);
+
+	// Positions are counted in cells from the start of the buffer
+	Word *cells = this->grid.data();
+	const std::ptrdiff_t cells_per_word = Storage::cells_per_word;
+	auto source = [&](const int y) {
+		return static_cast<std::ptrdiff_t>(y) * old_stride * cells_per_word + first_x;
+	};
+	auto destination = [&](const int y) {
+		return static_cast<std::ptrdiff_t>(y + y_offset) * new_stride * cells_per_word + first_x + x_offset;
+	};
+	auto move_row = [&](const int y) {
+		Storage::move(cells + (y + y_offset) * new_stride, first_x + x_offset, cells + y * old_stride, first_x, kept_width);
+	};
+
+	if (kept_width > 0) {
+		// Rows moving towards the start are moved first to last, then rows moving towards the end last to first
+		for (int y = first_y; y < end_y; y++) {
+			if (destination(y) < source(y)) {
+				move_row(y);
+			}
+		}
+		for (int y = end_y - 1; y >= first_y; y--) {
+			if (destination(y) > source(y)) {
+				move_row(y);
 			}
-        }
-    }
+		}
+	}
 
-    // Assign grid and update height and width
-    this->grid.swap(new_grid);
-    this->grid_height = height;
-    this->grid_width = width;
+	// Pad everything that was not moved into with dead cells
+	for (int y = 0; y < height; y++) {
+		Word *row = cells + y * new_stride;
+		const int old_y = y - y_offset;
+		if (kept_width == 0 || old_y < first_y || old_y >= end_y) {
+			Storage::fill(row, 0, width, Cell::DEAD);
+		} else {
+			Storage::fill(row, 0, first_x + x_offset, Cell::DEAD);
+			Storage::fill(row, end_x + x_offset, width - (end_x + x_offset), Cell::DEAD);
+		}
+	}
+
+	// Shrinking keeps the capacity for the next grow
+	this->grid.resize(new_size);
+	this->grid_height = height;
+	this->grid_width = width;
+	clear_padding();
 }
 
 /**
- * Grid::get_index(x, y)
+ * Grid::reserve(cells)
  *
- * Private helper function to determine the 1d index of a 2d coordinate.
- * Should not be visible from outside the Grid class.
+ * Reserve storage for at least the given number of cells, so the grid can later be resized up to that many
+ * cells without allocating. Never shrinks the storage or changes the contents of the grid.
+ *
+ * @example
+ *
+ *      // Make a grid that is expected to grow to 1024x1024
+ *      Grid grid(64, 64);
+ *      grid.reserve(1024 * 1024);
+ *
+ *      // Does not allocate
+ *      grid.resize(512, 512, Anchor::CENTRE);
+ *
+ * @param cells
+ *      The number of cells to make room for.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::reserve(const std::size_t cells) {
+	this->grid.reserve((cells + Storage::cells_per_word - 1) / Storage::cells_per_word);
+}
+
+/**
+ * Grid::get_capacity()
+ *
+ * Gets the number of cells the grid can hold without allocating.
+ * Bit-packed rows are padded to whole words, so a bit-packed grid may fit slightly fewer cells than this.
  * The function should be callable from a constant context.
  *
- * @param x
- *      The x coordinate of the cell.
+ * @return
+ *      The capacity of the grid in cells.
+ */
+template <typename Storage>
+std::size_t BasicGrid<Storage>::get_capacity() const {
+	return this->grid.capacity() * Storage::cells_per_word;
+}
+
+/**
+ * Grid::get_stride()
+ *
+ * Gets the number of words from the start of one row to the start of the next.
+ * This is the width for one byte per cell grids, and the width rounded up to whole 64 bit words for bit-packed grids.
+ * The function should be callable from a constant context.
+ *
+ * @return
+ *      The row stride in words.
+ */
+template <typename Storage>
+int BasicGrid<Storage>::get_stride() const {
+	return static_cast<int>(words_per_row<Storage>(this->grid_width));
+}
+
+/**
+ * Grid::get_index(y)
+ *
+ * Private helper function to determine the 1d index of the first word of a row.
+ * Should not be visible from outside the Grid class.
+ * The function should be callable from a constant context.
  *
  * @param y
- *      The y coordinate of the cell.
+ *      The y coordinate of the row.
  *
  * @return
- *      The 1d offset from the start of the data array where the desired cell is located.
+ *      The 1d offset from the start of the data array where the row starts.
  */
-unsigned int Grid::get_index(int x, int y) const {
-    return (y * this->get_width()) + x;
+template <typename Storage>
+std::size_t BasicGrid<Storage>::get_index(int y) const {
+    return static_cast<std::size_t>(y) * this->get_stride();
 }
 
 /**
@@ -350,7 +688,8 @@ unsigned int Grid::get_index(int x, int y) const {
  * @throws
  *      std::exception or sub-class if x,y is not a valid coordinate within the grid.
  */
-Cell Grid::get(const int x, const int y) const {
+template <typename Storage>
+Cell BasicGrid<Storage>::get(const int x, const int y) const {
 	check_if_in_bounds(x, y);
     return (*this)(x, y);
 }
@@ -381,16 +720,18 @@ Cell Grid::get(const int x, const int y) const {
  * @throws
  *      std::exception or sub-class if x,y is not a valid coordinate within the grid.
  */
-void Grid::set(const int x, const int y, Cell value) {
+template <typename Storage>
+void BasicGrid<Storage>::set(const int x, const int y, Cell value) {
 	check_if_in_bounds(x, y);
-	Grid::operator()(x, y) = value;
+	(*this)(x, y) = value;
 }
 
 /**
  * Grid::operator()(x, y)
  *
  * Gets a modifiable reference to the value at the desired coordinate.
- * Should be implemented by invoking Grid::get_index(x, y).
+ * Bit-packed grids return a BitReference which reads and assigns like a Cell &.
+ * Should be implemented by invoking Grid::get_index(y).
  *
  * @example
  *
@@ -421,17 +762,19 @@ void Grid::set(const int x, const int y, Cell value) {
  * @throws
  *      std::runtime_error or sub-class if x,y is not a valid coordinate within the grid.
  */
-Cell & Grid::operator()(const int x, const int y) {
+template <typename Storage>
+typename BasicGrid<Storage>::Reference BasicGrid<Storage>::operator()(const int x, const int y) {
 	check_if_in_bounds(x, y);
-	return this->grid[Grid::get_index(x, y)];
+	return Storage::at(this->grid.data() + get_index(y), x);
 }
 
 /**
  * Grid::operator()(x, y)
  *
  * Gets a read-only reference to the value at the desired coordinate.
+ * Bit-packed grids return the Cell value.
  * The operator should be callable from a constant context.
- * Should be implemented by invoking Grid::get_index(x, y).
+ * Should be implemented by invoking Grid::get_index(y).
  *
  * @example
  *
@@ -456,9 +799,122 @@ Cell & Grid::operator()(const int x, const int y) {
  * @throws
  *      std::exception or sub-class if x,y is not a valid coordinate within the grid.
  */
-const Cell & Grid::operator()(const int x, const int y) const {
+template <typename Storage>
+typename BasicGrid<Storage>::ConstReference BasicGrid<Storage>::operator()(const int x, const int y) const {
 	check_if_in_bounds(x, y);
-	return this->grid[Grid::get_index(x, y)];
+	return Storage::at(this->grid.data() + get_index(y), x);
+}
+
+/**
+ * Grid::row(y)
+ *
+ * Gets a pointer to the first word of a row, the rest of the row follows it contiguously.
+ * For one byte per cell grids each word is a cell. Bit-packed rows hold 64 cells per word, starting at the lowest bit.
+ * Used by hot loops which walk whole rows instead of indexing every cell.
+ *
+ * @example
+ *
+ *      // Make a grid
+ *      Grid grid(4, 4);
+ *
+ *      // Kill the whole second row
+ *      std::fill(grid.row(1), grid.row(1) + grid.get_width(), Cell::DEAD);
+ *
+ * @param y
+ *      The y coordinate of the row.
+ *
+ * @return
+ *      A pointer to the cell at 0, y.
+ *
+ * @throws
+ *      std::exception or sub-class if y is not a valid row within the grid.
+ */
+template <typename Storage>
+typename BasicGrid<Storage>::Word * BasicGrid<Storage>::row(const int y) {
+	check_if_row_in_bounds(y);
+	return this->grid.data() + get_index(y);
+}
+
+/**
+ * Grid::row(y)
+ *
+ * Gets a read-only pointer to the first cell of a row.
+ * The function should be callable from a constant context.
+ *
+ * @param y
+ *      The y coordinate of the row.
+ *
+ * @return
+ *      A read-only pointer to the cell at 0, y.
+ *
+ * @throws
+ *      std::exception or sub-class if y is not a valid row within the grid.
+ */
+template <typename Storage>
+const typename BasicGrid<Storage>::Word * BasicGrid<Storage>::row(const int y) const {
+	check_if_row_in_bounds(y);
+	return this->grid.data() + get_index(y);
+}
+
+/**
+ * Grid::view()
+ *
+ * Gets a read-only view of the whole grid without copying it.
+ * The view is invalidated if the grid is resized or destroyed.
+ *
+ * @example
+ *
+ *      // Make a grid
+ *      Grid grid(4, 4);
+ *
+ *      // Print it through a view
+ *      std::cout << grid.view() << std::endl;
+ *
+ * @return
+ *      A view of every cell in the grid.
+ */
+template <typename Storage>
+BasicGridView<Storage> BasicGrid<Storage>::view() const {
+	return BasicGridView<Storage>(this->grid.data(), this->get_width(), this->get_height(), this->get_stride());
+}
+
+/**
+ * Grid::crop_view(x0, y0, x1, y1)
+ *
+ * Gets a read-only view of a sub-grid without copying it.
+ * The view spans the range [x0, x1) by [y0, y1) in the original grid, exactly like Grid::crop(x0, y0, x1, y1).
+ * The view is invalidated if the grid is resized or destroyed.
+ *
+ * @example
+ *
+ *      // Make a grid
+ *      Grid y(4, 4);
+ *
+ *      // View the centre 2x2 in y and count its alive cells
+ *      unsigned int alive = y.crop_view(1, 1, 3, 3).get_alive_cells();
+ *
+ * @param x0
+ *      Left coordinate of the crop window on x-axis.
+ *
+ * @param y0
+ *      Top coordinate of the crop window on y-axis.
+ *
+ * @param x1
+ *      Right coordinate of the crop window on x-axis (1 greater than the largest index).
+ *
+ * @param y1
+ *      Bottom coordinate of the crop window on y-axis (1 greater than the largest index).
+ *
+ * @return
+ *      A view of the crop window.
+ *
+ * @throws
+ *      std::exception or sub-class if x0,y0 or x1,y1 are not valid coordinates within the grid
+ *      or if the crop window has a negative size.
+ */
+template <typename Storage>
+BasicGridView<Storage> BasicGrid<Storage>::crop_view(const int x0, const int y0, const int x1, const int y1) const {
+	return view().crop(x0, y0, x1, y1);
 }
 
 /**
@@ -495,38 +951,9 @@ const Cell & Grid::operator()(const int x, const int y) const {
  *      std::exception or sub-class if x0,y0 or x1,y1 are not valid coordinates within the grid
  *      or if the crop window has a negative size.
  */
-Grid Grid::crop(const int x0, const int y0, const int x1, const int y1) const {
-
-	check_if_in_bounds(x0, y0);
-	check_if_in_bounds(x1, y1);
-
-	if (y0 > y1 || x0 > x1) {
-		std::stringstream ss;
-		ss << "Crop window has a negative size:"<<
-		" x0 = "<< x0 <<
-		" y0 = " << y0 <<
-		" x1 = " << x1 <<
-		" y1 = " << y1;
-		throw std::invalid_argument(ss.str());
-	}
-
-	// Figure out if 0's are passed and where to start the grid
-	unsigned int old_grid_index = get_index(x0, y0);
-
-	const int new_grid_width = x1 - x0;
-	const int new_grid_height = y1 - y0;
-	Grid temp = Grid(new_grid_width, new_grid_height);
-
-	// Loop over selected portion of grid and copy from old to new Grid.
-	for (int y = 0; y < new_grid_height; y++) {
-		for (int x = 0; x < new_grid_width; x++) {
-			temp(x, y) = this->grid[old_grid_index];
-			old_grid_index++;
-		}
-		old_grid_index += this->get_width() - new_grid_width;
-	}
-
-	return temp;
+template <typename Storage>
+BasicGrid<Storage> BasicGrid<Storage>::crop(const int x0, const int y0, const int x1, const int y1) const {
+	return crop_view(x0, y0, x1, y1).materialize();
 }
 
 /**
@@ -566,38 +993,153 @@ Grid Grid::crop(const int x0, const int y0, const int x1, const int y1) const {
  * @throws
  *      std::exception or sub-class if the other grid being placed does not fit within the bounds of the current grid.
  */
-void Grid::merge(const Grid& other, const int x0, const int y0, const bool alive_only) {
+template <typename Storage>
+void BasicGrid<Storage>::merge(const BasicGridView<Storage>& other, const int x0, const int y0, const bool alive_only) {
+	merge(other, x0, y0, alive_only ? Blend::OR : Blend::OVERWRITE);
+}
 
-	check_if_in_bounds(x0, y0);
+/**
+ * Blend a run of source cells into a run of destination cells, 8 cells per 64 bit word.
+ *
+ * Cell::DEAD is 0x20 and Cell::ALIVE is 0x23, so bitwise OR and AND of two cells is already the OR and AND
+ * of their states. XOR and AND NOT only need the shared 0x20 bit patched back in.
+ *
+ * @param destination - The destination row.
+ * @param destination_x - The first destination cell.
+ * @param source - The source row, which must not overlap the destination cells.
+ * @param source_x - The first source cell.
+ * @param count - The number of cells to blend.
+ * @param blend - How to combine each destination cell with its source cell.
+ */
+void ByteCells::blend(Word *destination, const int destination_x, const Word *source, const int source_x,
+					  const int count, const Blend blend) {
+	const std::uint64_t dead_bits = 0x2020202020202020ULL;
+	destination += destination_x;
+	source += source_x;
 
-	const int other_grid_width = other.get_width();
-	const int other_grid_height = other.get_height();
+	auto blend_words = [=](auto op) {
+		std::size_t i = 0;
+		for (; i + 8 <= static_cast<std::size_t>(count); i += 8) {
+			std::uint64_t d, s;
+			std::memcpy(&d, destination + i, 8);
+			std::memcpy(&s, source + i, 8);
+			d = op(d, s);
+			std::memcpy(destination + i, &d, 8);
+		}
+		// Left over cells go through the same op one byte at a time
+		for (; i < static_cast<std::size_t>(count); i++) {
+			destination[i] = static_cast<Cell>(op(std::uint64_t(destination[i]), std::uint64_t(source[i])) & 0xff);
+		}
+	};
 
-	if (other_grid_width + x0 > this->get_width() || other_grid_height + y0 > this->get_height()) {
-		std::stringstream ss;
-		ss << "Grid being placed does not fit within the bounds of the current grid:"<<
-		   " x0 = "<< x0 <<
-		   " y0 = " << y0;
-		throw std::invalid_argument(ss.str());
+	switch (blend) {
+		case Blend::OVERWRITE:
+			std::memcpy(destination, source, count);
+			break;
+		case Blend::OR:
+			blend_words([](std::uint64_t d, std::uint64_t s) { return d | s; });
+			break;
+		case Blend::AND:
+			blend_words([](std::uint64_t d, std::uint64_t s) { return d & s; });
+			break;
+		case Blend::XOR:
+			blend_words([=](std::uint64_t d, std::uint64_t s) { return d ^ s ^ dead_bits; });
+			break;
+		case Blend::AND_NOT:
+			blend_words([=](std::uint64_t d, std::uint64_t s) { return d & (~s | dead_bits); });
+			break;
 	}
+}
 
-	// Figure out if 0's are passed and where to start the grid
-	unsigned int current_grid_index = get_index(x0, y0);
+/**
+ * Grid::merge(other, x0, y0, blend, clip = false)
+ *
+ * Merge two grids together by overlaying the other on the current grid at the desired location,
+ * combining each pair of overlapping cells with a boolean operation. Cells are considered true if alive.
+ *      - Blend::OVERWRITE copies the other cell.
+ *      - Blend::OR keeps a cell alive if either cell is alive, the same as alive_only = true.
+ *      - Blend::AND keeps a cell alive only if both cells are alive.
+ *      - Blend::XOR keeps a cell alive if exactly one cell is alive.
+ *      - Blend::AND_NOT kills a cell wherever the other cell is alive.
+ *
+ * Rows are blended whole, 8 cells at a time for one byte per cell grids and 64 cells at a time for bit-packed grids.
+ *
+ * If clip = true the other grid may be placed anywhere, including negative coordinates,
+ * and only the part that overlaps the current grid is merged.
+ *
+ * @example
+ *
+ *      // Make two grids
+ *      Grid x(2, 2), y(4, 4);
+ *
+ *      // Toggle the upper left 2x2 in y wherever x is alive
+ *      y.merge(x, 0, 0, Blend::XOR);
+ *
+ *      // Stamp x hanging off the top left corner of y, keeping only its bottom right cell
+ *      y.merge(x, -1, -1, Blend::OR, true);
+ *
+ *      // Clear the area under a window of x without copying it first
+ *      y.merge(x.crop_view(1, 0, 2, 2), 3, 0, Blend::AND_NOT);
+ *
+ * @param other
+ *      The other grid or view to merge into the current grid.
+ *
+ * @param x0
+ *      The x coordinate of where to place the top left corner of the other grid.
+ *
+ * @param y0
+ *      The y coordinate of where to place the top left corner of the other grid.
+ *
+ * @param blend
+ *      How to combine each cell of the current grid with the cell of the other grid above it.
+ *
+ * @param clip
+ *      Optional parameter. If true then parts of the other grid outside the current grid are ignored
+ *      instead of throwing. Defaults to false.
+ *
+ * @throws
+ *      std::exception or sub-class if clip = false and the other grid being placed does not fit
+ *      within the bounds of the current grid.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::merge(const BasicGridView<Storage>& other, const int x0, const int y0,
+							   const Blend blend, const bool clip) {
 
-	// Loop over selected portion of grid and copy from other grid to current.
-	for (int y = 0; y < other_grid_height; y++) {
-		for (int x = 0; x < other_grid_width; x++) {
-			if (alive_only) {
-				Cell &cell = this->grid[current_grid_index];
-				if (cell == Cell::DEAD) {
-					cell = other(x, y);
-				}
-			} else {
-				this->grid[current_grid_index] = other(x, y);
-			}
-			current_grid_index++;
+	if (!clip) {
+		check_if_corner_in_bounds(x0, y0);
+
+		if (other.get_width() + x0 > this->get_width() || other.get_height() + y0 > this->get_height()) {
+			std::stringstream ss;
+			ss << "Grid being placed does not fit within the bounds of the current grid:"<<
+			   " x0 = "<< x0 <<
+			   " y0 = " << y0;
+			throw std::invalid_argument(ss.str());
 		}
-		current_grid_index += this->get_width() - other_grid_width;
+	}
+
+	// Work out the overlapping window in both grids
+	const int source_x = std::max(0, -x0);
+	const int source_y = std::max(0, -y0);
+	const int target_x = std::max(0, x0);
+	const int target_y = std::max(0, y0);
+	const int width = std::min(other.get_width() - source_x, this->get_width() - target_x);
+	const int height = std::min(other.get_height() - source_y, this->get_height() - target_y);
+
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+
+	// A view into this grid could be overwritten while it is read, so take a copy first
+	const Word *other_start = other.row(source_y);
+	if (!this->grid.empty() && other_start >= this->grid.data() && other_start < this->grid.data() + this->grid.size()) {
+		merge(other.materialize(), x0, y0, blend, clip);
+		return;
+	}
+
+	for (int y = 0; y < height; y++) {
+		Storage::blend(this->grid.data() + get_index(target_y + y), target_x,
+					   other.row(source_y + y), other.get_offset() + source_x,
+					   width, blend);
 	}
 }
 
@@ -624,83 +1166,317 @@ void Grid::merge(const Grid& other, const int x0, const int y0, const bool alive
  * @return
  *      Returns a copy of the grid that has been rotated.
  */
-Grid Grid::rotate(const int rotation) const {
-
-	Grid g = (*this);
-
-	unsigned int rotation_direction = abs(rotation % 4 + 4) % 4;
-
-	if (rotation_direction == 0) {
-		//Grid doesn't change
-	} else if (rotation_direction == 3) {
-		// Original top of grid facing to the left
-		// Reading from top left corner
-		//      +-----------+
-		// -->  | 3 | 6 | 9 |  Read last index of each row, then second index of each row, then third etc.
-		//    T |---|---|---|
-		//    O | 2 | 5 | 8 |
-		//    P |---|---|---|
-		//      | 1 | 4 | 7 |
-		//      +-----------+
-		//
-		unsigned int offset = 1;
-		unsigned int new_grid_index = 0;
-		for (int current_row = 1; current_row <= this->get_height(); current_row++) {
-			g.grid[new_grid_index] = this->grid[(this->grid_width * current_row) - offset];
-			new_grid_index++;
-			if(new_grid_index != this->get_total_cells() && current_row == get_height()) {
-				current_row = 0;
-				offset++;
+template <typename Storage>
+BasicGrid<Storage> BasicGrid<Storage>::rotate(const int rotation) const {
+	static const Symmetry rotations[4] = {
+		Symmetry::IDENTITY, Symmetry::ROTATE_90, Symmetry::ROTATE_180, Symmetry::ROTATE_270
+	};
+	return transform(rotations[((rotation % 4) + 4) % 4]);
+}
+
+/**
+ * Grid::flip()
+ *
+ * Create a copy of the grid mirrored across its vertical axis, so the left edge becomes the right edge.
+ * Combined with Grid::rotate(rotation) this reaches all 8 rotations and reflections of a grid.
+ * The function should be callable from a constant context.
+ *
+ * @example
+ *
+ *      // Make a glider and mirror it
+ *      Grid x = Zoo::glider();
+ *
+ *      // y is a glider travelling down and to the left
+ *      Grid y = x.flip();
+ *
+ *      +---+      +---+
+ *      | # |      | # |
+ *      |  #|  ->  |#  |
+ *      |###|      |###|
+ *      +---+      +---+
+ *
+ * @return
+ *      Returns a copy of the grid that has been mirrored.
+ */
+template <typename Storage>
+BasicGrid<Storage> BasicGrid<Storage>::flip() const {
+	return transform(Symmetry::FLIP_LEFT_RIGHT);
+}
+
+/**
+ * Grid::transform(symmetry)
+ *
+ * Create a copy of the grid with one of the 8 rotations or reflections applied.
+ * The function should be callable from a constant context.
+ *
+ * @example
+ *
+ *      // Make a 1x3 grid
+ *      Grid x(1, 3);
+ *
+ *      // y is size 3x1, with the top left cell of x at the top left of y
+ *      Grid y = x.transform(Symmetry::TRANSPOSE);
+ *
+ * @param symmetry
+ *      The rotation or reflection to apply.
+ *
+ * @return
+ *      Returns a transformed copy of the grid.
+ */
+template <typename Storage>
+BasicGrid<Storage> BasicGrid<Storage>::transform(const Symmetry symmetry) const {
+	BasicGrid g;
+	transform_into(g, symmetry);
+	return g;
+}
+
+/**
+ * Reverse the order of the 8 bytes in a word.
+ * @param word - The word to reverse.
+ * @return The reversed word.
+ */
+static std::uint64_t reverse_bytes(std::uint64_t word) {
+	word = ((word & 0x00ff00ff00ff00ffULL) << 8) | ((word >> 8) & 0x00ff00ff00ff00ffULL);
+	word = ((word & 0x0000ffff0000ffffULL) << 16) | ((word >> 16) & 0x0000ffff0000ffffULL);
+	return (word << 32) | (word >> 32);
+}
+
+/**
+ * Copy rows from a source to a destination buffer, optionally reversing the order of the rows
+ * and the order of the cells within each row.
+ * @param source - The first cell of the source.
+ * @param source_stride - The number of cells between source rows.
+ * @param destination - The first cell of the destination, the same size as the source.
+ * @param destination_stride - The number of cells between destination rows.
+ * @param width - The width of both buffers.
+ * @param height - The height of both buffers.
+ * @param reverse_rows - True to write the first source row to the last destination row.
+ * @param reverse_cells - True to write each row back to front.
+ */
+static void copy_rows(const Cell *source, const std::size_t source_stride, Cell *destination,
+					  const std::size_t destination_stride, const int width, const int height,
+					  const bool reverse_rows, const bool reverse_cells) {
+	for (int y = 0; y < height; y++) {
+		const Cell *from = source + y * source_stride;
+		Cell *to = destination + (reverse_rows ? height - 1 - y : y) * destination_stride;
+		if (reverse_cells) {
+			// Reverse 8 cells at a time from the end of the source row
+			int x = 0;
+			for (; x + 8 <= width; x += 8) {
+				std::uint64_t word;
+				std::memcpy(&word, from + width - 8 - x, 8);
+				word = reverse_bytes(word);
+				std::memcpy(to + x, &word, 8);
 			}
+			for (; x < width; x++) {
+				to[x] = from[width - 1 - x];
+			}
+		} else {
+			std::memcpy(to, from, width);
 		}
-		// Re-assign width's and heights
-		const int temp = g.get_width();
-		g.grid_width = g.get_height();
-		g.grid_height = temp;
-
-	} else if (rotation_direction == 2) {
-		// Original top of grid facing down
-		// Reading from top left corner
-		//      +-----------+
-		// -->  | 9 | 8 | 7 |  Read grid upside down.
-		//      |---|---|---|
-		//      | 6 | 5 | 4 |
-		//      |---|---|---|
-		//      | 3 | 2 | 1 |
-		//      +-----------+
-		// 			T O P
-		unsigned int j = 0;
-		for (auto i = this->grid.crbegin(); i != this->grid.crend(); ++i) {
-			g.grid[j] = *i;
-			j++;
+	}
+}
+
+/**
+ * Transpose an 8x8 block of cells, leaving one 8 byte word per column of the source.
+ * Byte k of columns[i] is the cell in column i of source row k.
+ * @param source - The top left cell of the block.
+ * @param stride - The width of the source buffer.
+ * @param columns - The 8 transposed rows.
+ */
+static void transpose_block(const Cell *source, const std::size_t stride, std::uint64_t columns[8]) {
+#if defined(__SSE2__)
+	const __m128i r0 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source));
+	const __m128i r1 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + stride));
+	const __m128i r2 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + 2 * stride));
+	const __m128i r3 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + 3 * stride));
+	const __m128i r4 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + 4 * stride));
+	const __m128i r5 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + 5 * stride));
+	const __m128i r6 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + 6 * stride));
+	const __m128i r7 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(source + 7 * stride));
+
+	// Interleave bytes, then pairs, then quads, so each 8 byte half holds one column
+	const __m128i t0 = _mm_unpacklo_epi8(r0, r1);
+	const __m128i t1 = _mm_unpacklo_epi8(r2, r3);
+	const __m128i t2 = _mm_unpacklo_epi8(r4, r5);
+	const __m128i t3 = _mm_unpacklo_epi8(r6, r7);
+	const __m128i u0 = _mm_unpacklo_epi16(t0, t1);
+	const __m128i u1 = _mm_unpackhi_epi16(t0, t1);
+	const __m128i u2 = _mm_unpacklo_epi16(t2, t3);
+	const __m128i u3 = _mm_unpackhi_epi16(t2, t3);
+	const __m128i v[4] = {
+		_mm_unpacklo_epi32(u0, u2), _mm_unpackhi_epi32(u0, u2),
+		_mm_unpacklo_epi32(u1, u3), _mm_unpackhi_epi32(u1, u3)
+	};
+
+	for (int i = 0; i < 4; i++) {
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(&columns[2 * i]), v[i]);
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(&columns[2 * i + 1]), _mm_unpackhi_epi64(v[i], v[i]));
+	}
+#else
+	unsigned char bytes[8][8];
+	for (int k = 0; k < 8; k++) {
+		for (int i = 0; i < 8; i++) {
+			bytes[i][k] = source[k * stride + i];
 		}
-	} else {
-		// Original top of grid facing to the right
-		// Reading from top left corner
-		//      +-----------+
-		// -->  | 7 | 4 | 1 |  Read (starting from last row) first index of each row, then second index of each row etc.
-		//      |---|---|---| T
-		//      | 8 | 5 | 2 | O
-		//      |---|---|---| P
-		//      | 9 | 6 | 3 |
-		//      +-----------+
-		//
-		unsigned int offset = this->get_width() * - 1;
-		unsigned int new_grind_index = 0;
-		for (unsigned int current_row = this->get_height(); current_row >= 1 ; current_row--) {
-			g.grid[new_grind_index] = this->grid[(this->grid_width * current_row) + offset];
-			new_grind_index++;
-			if(new_grind_index != this->get_total_cells() && current_row == 1) {
-				current_row = this->get_height() + 1;
-				offset++;
+	}
+	std::memcpy(columns, bytes, sizeof(bytes));
+#endif
+}
+
+/**
+ * Write the transpose of a source buffer to a destination buffer, optionally reversing the order of the
+ * destination rows and the order of the cells within each destination row.
+ *
+ * The buffers are walked in 64x64 tiles so that both the source and destination tile stay in cache,
+ * and each tile is transposed in 8x8 blocks. Cells left over at the right and bottom edges are copied one at a time.
+ *
+ * @param source - The first cell of the source.
+ * @param source_stride - The number of cells between source rows.
+ * @param destination - The first cell of the destination, sized height by width.
+ * @param destination_stride - The number of cells between destination rows.
+ * @param width - The width of the source.
+ * @param height - The height of the source.
+ * @param reverse_rows - True to write the first source column to the last destination row.
+ * @param reverse_cells - True to write the first source row to the last destination column.
+ */
+static void transpose_rows(const Cell *source, const std::size_t source_stride, Cell *destination,
+						   const std::size_t destination_stride, const int width, const int height,
+						   const bool reverse_rows, const bool reverse_cells) {
+	const int tile = 64;
+	const int block_width = width - width % 8;
+	const int block_height = height - height % 8;
+
+	auto destination_index = [=](const int x, const int y) {
+		const std::size_t row = reverse_rows ? width - 1 - x : x;
+		const std::size_t column = reverse_cells ? height - 1 - y : y;
+		return row * destination_stride + column;
+	};
+
+	for (int tile_y = 0; tile_y < block_height; tile_y += tile) {
+		for (int tile_x = 0; tile_x < block_width; tile_x += tile) {
+			const int end_y = std::min(tile_y + tile, block_height);
+			const int end_x = std::min(tile_x + tile, block_width);
+			for (int y = tile_y; y < end_y; y += 8) {
+				for (int x = tile_x; x < end_x; x += 8) {
+					std::uint64_t columns[8];
+					transpose_block(source + y * source_stride + x, source_stride, columns);
+					// The destination word starts at the lowest column the block covers
+					const std::size_t column = reverse_cells ? height - 8 - y : y;
+					for (int i = 0; i < 8; i++) {
+						const std::size_t row = reverse_rows ? width - 1 - (x + i) : x + i;
+						const std::uint64_t word = reverse_cells ? reverse_bytes(columns[i]) : columns[i];
+						std::memcpy(destination + row * destination_stride + column, &word, 8);
+					}
+				}
 			}
 		}
-		const int temp = g.get_width();
-		g.grid_width = g.get_height();
-		g.grid_height = temp;
 	}
 
-	return g;
+	// Right edge columns, then the bottom edge rows
+	for (int y = 0; y < block_height; y++) {
+		for (int x = block_width; x < width; x++) {
+			destination[destination_index(x, y)] = source[y * source_stride + x];
+		}
+	}
+	for (int y = block_height; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			destination[destination_index(x, y)] = source[y * source_stride + x];
+		}
+	}
+}
+
+/**
+ * Write a source buffer with one of the 8 rotations or reflections applied to a destination buffer,
+ * using whole row copies or tiled transposes.
+ * @param source - The first cell of the source.
+ * @param source_stride - The number of cells between source rows.
+ * @param width - The width of the source.
+ * @param height - The height of the source.
+ * @param destination - The first cell of the destination, sized to fit the transformed source.
+ * @param destination_stride - The number of cells between destination rows.
+ * @param symmetry - The rotation or reflection to apply.
+ */
+void ByteCells::transform(const Word *source, const std::size_t source_stride, const int width, const int height,
+						  Word *destination, const std::size_t destination_stride, const Symmetry symmetry) {
+	switch (symmetry) {
+		case Symmetry::IDENTITY:
+			copy_rows(source, source_stride, destination, destination_stride, width, height, false, false);
+			break;
+		case Symmetry::FLIP_LEFT_RIGHT:
+			copy_rows(source, source_stride, destination, destination_stride, width, height, false, true);
+			break;
+		case Symmetry::FLIP_TOP_BOTTOM:
+			copy_rows(source, source_stride, destination, destination_stride, width, height, true, false);
+			break;
+		case Symmetry::ROTATE_180:
+			copy_rows(source, source_stride, destination, destination_stride, width, height, true, true);
+			break;
+		case Symmetry::TRANSPOSE:
+			transpose_rows(source, source_stride, destination, destination_stride, width, height, false, false);
+			break;
+		case Symmetry::ROTATE_90:
+			transpose_rows(source, source_stride, destination, destination_stride, width, height, false, true);
+			break;
+		case Symmetry::ROTATE_270:
+			transpose_rows(source, source_stride, destination, destination_stride, width, height, true, false);
+			break;
+		case Symmetry::ANTI_TRANSPOSE:
+			transpose_rows(source, source_stride, destination, destination_stride, width, height, true, true);
+			break;
+	}
+}
+
+/**
+ * Grid::transform_into(destination, symmetry)
+ *
+ * Write the grid with one of the 8 rotations or reflections applied into another grid.
+ * The destination is resized to fit, reusing its storage where it can, and its previous contents are replaced.
+ * Unlike Grid::transform(symmetry) this avoids allocating when the destination is reused.
+ *
+ * Reflections that keep rows as rows are done with whole row copies.
+ * Transposing symmetries are done in cache sized tiles, of 8x8 blocks using SSE2 byte shuffles where available
+ * for one byte per cell grids, and of 64x64 bit matrices for bit-packed grids.
+ *
+ * @example
+ *
+ *      // Make a grid and a buffer to rotate it into
+ *      Grid x(1024, 768), y;
+ *
+ *      // y is size 768x1024
+ *      x.transform_into(y, Symmetry::ROTATE_90);
+ *
+ * @param destination
+ *      The grid to write the transformed grid to. May be the same grid.
+ *
+ * @param symmetry
+ *      The rotation or reflection to apply.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::transform_into(BasicGrid& destination, const Symmetry symmetry) const {
+
+	// Transforming in place needs a second buffer
+	if (&destination == this) {
+		BasicGrid g;
+		transform_into(g, symmetry);
+		std::swap(destination, g);
+		return;
+	}
+
+	const bool transposes = symmetry == Symmetry::ROTATE_90 || symmetry == Symmetry::ROTATE_270 ||
+							symmetry == Symmetry::TRANSPOSE || symmetry == Symmetry::ANTI_TRANSPOSE;
+
+	destination.grid_width = transposes ? this->get_height() : this->get_width();
+	destination.grid_height = transposes ? this->get_width() : this->get_height();
+	destination.grid.resize(static_cast<std::size_t>(destination.grid_height) * destination.get_stride());
+
+	if (this->grid.empty()) {
+		return;
+	}
+
+	Storage::transform(this->grid.data(), this->get_stride(), this->get_width(), this->get_height(),
+					   destination.grid.data(), destination.get_stride(), symmetry);
+	destination.clear_padding();
 }
 
 /**
@@ -738,30 +1514,49 @@ Grid Grid::rotate(const int rotation) const {
  * @return
  *      Returns a reference to the output stream to enable operator chaining.
  */
-std::ostream & operator<<(std::ostream & output_stream, const Grid& grid) {
-	std::string padding = "+" + std::string(grid.get_width(), '-') + "+";
-	output_stream << padding << std::endl; 	// Top row
+template <typename Storage>
+std::ostream & operator<<(std::ostream & output_stream, const BasicGrid<Storage>& grid) {
+	return output_stream << grid.view();
+}
 
-	for (int y = 0; y < grid.get_height(); y++) {
-		output_stream << "|"; 				// Start of row
-		for (int x = 0; x < grid.get_width(); x++) {
-			output_stream << (char) grid.get(x, y);
-		}
-		output_stream << "|" << std::endl; 	// End of row
+/**
+ * Check whether passed coordinates are of a cell in grid.
+ * @param x - The x coordinate.
+ * @param y - The y coordinate.
+ *
+ * @throws 	- out_of_range exception if point (x,y) not in grid.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::check_if_in_bounds(const int x, const int y) const {
+	if (x >= this->get_width() || y >= this->get_height() || x < 0 || y < 0) {
+		std::stringstream ss;
+		ss << x  << ", " << y << " is not a valid coordinate within the grid";
+		throw std::out_of_range(ss.str());
 	}
-	output_stream << padding << std::endl; 	// Bottom row
+}
 
-	return output_stream;
+/**
+ * Check whether a row is in grid, whatever its width.
+ * @param y - The y coordinate.
+ *
+ * @throws 	- out_of_range exception if row y not in grid.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::check_if_row_in_bounds(const int y) const {
+	if (y >= this->get_height() || y < 0) {
+		throw std::out_of_range(std::to_string(y) + " is not a valid row within the grid");
+	}
 }
 
 /**
- * Check whether passed coordinates are in grid.
+ * Check whether passed coordinates are a corner of a window of grid, which may be on its right or bottom edge.
  * @param x - The x coordinate.
  * @param y - The y coordinate.
  *
- * @throws 	- out_of_range exception if point (x,y) not in grid.
+ * @throws 	- out_of_range exception if point (x,y) is not in grid or on its right or bottom edge.
  */
-void Grid::check_if_in_bounds(const int x, const int y) const {
+template <typename Storage>
+void BasicGrid<Storage>::check_if_corner_in_bounds(const int x, const int y) const {
 	if (x > this->get_width() || y > this->get_height() || x < 0 || y < 0) {
 		std::stringstream ss;
 		ss << x  << ", " << y << " is not a valid coordinate within the grid";
@@ -774,11 +1569,784 @@ void Grid::check_if_in_bounds(const int x, const int y) const {
  * @param x - The x value.
  * @param y - The y value.
  */
-void Grid::zero_values_if_negative(int & x, int & y) const {
+template <typename Storage>
+void BasicGrid<Storage>::zero_values_if_negative(int & x, int & y) const {
 	if (x < 0) {
 		x = 0;
 	}
 	if (y < 0) {
-		x = 0;
+		y = 0;
+	}
+}
+
+/**
+ * Kill the unused cells at the end of every row, which only bit-packed rows have.
+ * Kernels rely on them being dead so whole words can be counted and stepped.
+ */
+template <typename Storage>
+void BasicGrid<Storage>::clear_padding() {
+	const int padding = this->get_stride() * Storage::cells_per_word - this->grid_width;
+	if (padding == 0) {
+		return;
+	}
+	for (int y = 0; y < this->grid_height; y++) {
+		Storage::fill(this->grid.data() + get_index(y), this->grid_width, padding, Cell::DEAD);
+	}
+}
+
+/**
+ * Count the alive cells in a run of cells, 8 cells per 64 bit word.
+ * Cell::ALIVE has its lowest bit set and Cell::DEAD does not, so the count is the sum of the lowest bits.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells.
+ * @return The number of alive cells.
+ */
+unsigned int ByteCells::count_alive(const Word *row, const int x, const int count) {
+	const std::uint64_t low_bits = 0x0101010101010101ULL;
+	const Cell *cells = row + x;
+	unsigned int total = 0;
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, cells + i, 8);
+		// Multiplying sums the 8 low bits into the top byte
+		total += static_cast<unsigned int>(((word & low_bits) * low_bits) >> 56);
+	}
+	for (; i < count; i++) {
+		total += cells[i] & 1;
+	}
+	return total;
+}
+
+/**
+ * GridView::GridView()
+ *
+ * Construct an empty view of size 0x0.
+ */
+template <typename Storage>
+BasicGridView<Storage>::BasicGridView() : BasicGridView(nullptr, 0, 0, 0) {
+}
+
+/**
+ * GridView::GridView(cells, width, height, stride, offset = 0)
+ *
+ * Construct a view onto cells owned by something else.
+ *
+ * @example
+ *
+ *      // View every other row of a grid
+ *      Grid grid(8, 8);
+ *      GridView even_rows(grid.row(0), 8, 4, 16);
+ *
+ * @param cells
+ *      The first word of the top row of the view.
+ *
+ * @param width
+ *      The width of the view.
+ *
+ * @param height
+ *      The height of the view.
+ *
+ * @param stride
+ *      The number of words from the start of one row to the start of the next.
+ *
+ * @param offset
+ *      Optional parameter. The number of cells to skip at the start of each row, for views which start
+ *      part way through a bit-packed word. Defaults to 0.
+ */
+template <typename Storage>
+BasicGridView<Storage>::BasicGridView(const Word *cells, const int width, const int height, const int stride,
+									  const int offset)
+		: cells(cells + offset / Storage::cells_per_word), view_width(width), view_height(height), view_stride(stride),
+		  view_offset(offset % Storage::cells_per_word) {
+}
+
+/**
+ * GridView::GridView(grid)
+ *
+ * Construct a view of a whole grid.
+ * Deliberately not explicit so a Grid can be passed anywhere a GridView is expected.
+ *
+ * @param grid
+ *      The grid to view.
+ */
+template <typename Storage>
+BasicGridView<Storage>::BasicGridView(const BasicGrid<Storage> &grid) : BasicGridView(grid.view()) {
+}
+
+/**
+ * GridView::get_width()
+ *
+ * @return The width of the view.
+ */
+template <typename Storage>
+int BasicGridView<Storage>::get_width() const {
+	return this->view_width;
+}
+
+/**
+ * GridView::get_height()
+ *
+ * @return The height of the view.
+ */
+template <typename Storage>
+int BasicGridView<Storage>::get_height() const {
+	return this->view_height;
+}
+
+/**
+ * GridView::get_stride()
+ *
+ * @return The number of words from the start of one row to the start of the next.
+ */
+template <typename Storage>
+int BasicGridView<Storage>::get_stride() const {
+	return this->view_stride;
+}
+
+/**
+ * GridView::get_offset()
+ *
+ * @return The number of cells each row starts into its first word, always 0 for one byte per cell views.
+ */
+template <typename Storage>
+int BasicGridView<Storage>::get_offset() const {
+	return this->view_offset;
+}
+
+/**
+ * GridView::get_total_cells()
+ *
+ * @return The number of cells in the view.
+ */
+template <typename Storage>
+unsigned int BasicGridView<Storage>::get_total_cells() const {
+	return this->view_width * this->view_height;
+}
+
+/**
+ * GridView::get_alive_cells()
+ *
+ * Counts how many cells in the view are alive, a whole row at a time.
+ *
+ * @return The number of alive cells.
+ */
+template <typename Storage>
+unsigned int BasicGridView<Storage>::get_alive_cells() const {
+	unsigned int total = 0;
+	for (int y = 0; y < this->view_height; y++) {
+		total += Storage::count_alive(row(y), this->view_offset, this->view_width);
+	}
+	return total;
+}
+
+/**
+ * GridView::get_dead_cells()
+ *
+ * @return The number of dead cells.
+ */
+template <typename Storage>
+unsigned int BasicGridView<Storage>::get_dead_cells() const {
+	return this->get_total_cells() - this->get_alive_cells();
+}
+
+/**
+ * GridView::hash()
+ *
+ * Hash the size and cells of the view, 64 cells at a time through the layout's load kernel.
+ * The hash depends only on the cells, so a Grid, a BitGrid and a StaticGrid holding the same pattern
+ * hash to the same value, and two states can be compared without walking them cell by cell.
+ *
+ * @return The 64 bit hash of the view.
+ */
+template <typename Storage>
+std::uint64_t BasicGridView<Storage>::hash() const {
+	CellHash hash(this->view_width, this->view_height);
+	for (int y = 0; y < this->view_height; y++) {
+		// Every whole word of 64 cells, then the remainder which is mixed even when empty
+		int x = 0;
+		for (; x + 64 <= this->view_width; x += 64) {
+			hash.mix(Storage::load(row(y), this->view_offset + x, 64));
+		}
+		hash.mix(Storage::load(row(y), this->view_offset + x, this->view_width - x));
+	}
+	return hash.finish();
+}
+
+/**
+ * GridView::get(x, y)
+ *
+ * Returns the value of the cell at the desired coordinate.
+ *
+ * @param x - The x coordinate of the cell.
+ * @param y - The y coordinate of the cell.
+ * @return The value of the desired cell.
+ *
+ * @throws - std::exception or sub-class if x,y is not a valid coordinate within the view.
+ */
+template <typename Storage>
+Cell BasicGridView<Storage>::get(const int x, const int y) const {
+	return (*this)(x, y);
+}
+
+/**
+ * GridView::operator()(x, y)
+ *
+ * Gets a read-only reference to the value at the desired coordinate, or the value itself for bit-packed views.
+ *
+ * @param x - The x coordinate of the cell.
+ * @param y - The y coordinate of the cell.
+ * @return A read-only reference to the desired cell.
+ *
+ * @throws - std::exception or sub-class if x,y is not a valid coordinate within the view.
+ */
+template <typename Storage>
+typename BasicGridView<Storage>::ConstReference BasicGridView<Storage>::operator()(const int x, const int y) const {
+	check_if_in_bounds(x, y);
+	return Storage::at(row(y), this->view_offset + x);
+}
+
+/**
+ * GridView::row(y)
+ *
+ * Gets a read-only pointer to the first word of a row of the view.
+ * The row is contiguous for get_width() cells starting get_offset() cells into the word,
+ * rows are get_stride() words apart.
+ *
+ * @param y - The y coordinate of the row.
+ * @return A read-only pointer to the word holding the cell at 0, y.
+ */
+template <typename Storage>
+const typename BasicGridView<Storage>::Word * BasicGridView<Storage>::row(const int y) const {
+	return this->cells + static_cast<std::size_t>(y) * this->view_stride;
+}
+
+/**
+ * GridView::crop(x0, y0, x1, y1)
+ *
+ * Gets a view of a sub-region of this view without copying.
+ * The view spans the range [x0, x1) by [y0, y1) in this view.
+ *
+ * @param x0 - Left coordinate of the crop window on x-axis.
+ * @param y0 - Top coordinate of the crop window on y-axis.
+ * @param x1 - Right coordinate of the crop window on x-axis (1 greater than the largest index).
+ * @param y1 - Bottom coordinate of the crop window on y-axis (1 greater than the largest index).
+ * @return A view of the crop window.
+ *
+ * @throws
+ *      std::exception or sub-class if x0,y0 or x1,y1 are not valid coordinates within the view
+ *      or if the crop window has a negative size.
+ */
+template <typename Storage>
+BasicGridView<Storage> BasicGridView<Storage>::crop(const int x0, const int y0, const int x1, const int y1) const {
+
+	check_if_corner_in_bounds(x0, y0);
+	check_if_corner_in_bounds(x1, y1);
+
+	if (y0 > y1 || x0 > x1) {
+		std::stringstream ss;
+		ss << "Crop window has a negative size:"<<
+		" x0 = "<< x0 <<
+		" y0 = " << y0 <<
+		" x1 = " << x1 <<
+		" y1 = " << y1;
+		throw std::invalid_argument(ss.str());
+	}
+
+	return BasicGridView(row(y0), x1 - x0, y1 - y0, this->view_stride, this->view_offset + x0);
+}
+
+/**
+ * GridView::materialize()
+ *
+ * Copy the cells of the view into a new owning Grid, one row at a time.
+ * Bit-packed views which start part way through a word are shifted back to the start of each row.
+ *
+ * @example
+ *
+ *      // Keep the centre of a grid after the grid is gone
+ *      Grid centre = grid.crop_view(1, 1, 3, 3).materialize();
+ *
+ * @return A new grid the size of the view containing its cells.
+ */
+template <typename Storage>
+BasicGrid<Storage> BasicGridView<Storage>::materialize() const {
+	BasicGrid<Storage> grid(this->view_width, this->view_height);
+	for (int y = 0; y < this->view_height; y++) {
+		Storage::move(grid.row(y), 0, row(y), this->view_offset, this->view_width);
+	}
+	return grid;
+}
+
+/**
+ * operator<<(output_stream, view)
+ *
+ * Serializes a view to an ascii output stream in the same bordered format as a Grid.
+ *
+ * @param output_stream - An ascii mode output stream such as std::cout.
+ * @param view - A view of the cells to be printed.
+ * @return Returns a reference to the output stream to enable operator chaining.
+ */
+template <typename Storage>
+std::ostream & operator<<(std::ostream & output_stream, const BasicGridView<Storage>& view) {
+	std::string padding = "+" + std::string(view.get_width(), '-') + "+";
+	output_stream << padding << std::endl; 	// Top row
+
+	for (int y = 0; y < view.get_height(); y++) {
+		output_stream << "|"; 				// Start of row
+		Storage::write_row(output_stream, view.row(y), view.get_offset(), view.get_width());
+		output_stream << "|" << std::endl; 	// End of row
+	}
+	output_stream << padding << std::endl; 	// Bottom row
+
+	return output_stream;
+}
+
+/**
+ * Check whether passed coordinates are of a cell in the view.
+ * @param x - The x coordinate.
+ * @param y - The y coordinate.
+ *
+ * @throws 	- out_of_range exception if point (x,y) not in the view.
+ */
+template <typename Storage>
+void BasicGridView<Storage>::check_if_in_bounds(const int x, const int y) const {
+	if (x >= this->view_width || y >= this->view_height || x < 0 || y < 0) {
+		std::stringstream ss;
+		ss << x  << ", " << y << " is not a valid coordinate within the view";
+		throw std::out_of_range(ss.str());
+	}
+}
+
+/**
+ * Check whether passed coordinates are a corner of a window of the view, which may be on its right or bottom edge.
+ * @param x - The x coordinate.
+ * @param y - The y coordinate.
+ *
+ * @throws 	- out_of_range exception if point (x,y) is not in the view or on its right or bottom edge.
+ */
+template <typename Storage>
+void BasicGridView<Storage>::check_if_corner_in_bounds(const int x, const int y) const {
+	if (x > this->view_width || y > this->view_height || x < 0 || y < 0) {
+		std::stringstream ss;
+		ss << x  << ", " << y << " is not a valid coordinate within the view";
+		throw std::out_of_range(ss.str());
+	}
+}
+
+/**
+ * ByteCells::at(row, x)
+ *
+ * @param row - The row.
+ * @param x - The cell.
+ * @return A reference to the cell.
+ */
+ByteCells::Reference ByteCells::at(Word *row, const int x) {
+	return row[x];
+}
+
+/**
+ * ByteCells::at(row, x)
+ *
+ * @param row - The row.
+ * @param x - The cell.
+ * @return A read-only reference to the cell.
+ */
+ByteCells::ConstReference ByteCells::at(const Word *row, const int x) {
+	return row[x];
+}
+
+/**
+ * Gather up to 64 cells into a word with bit i set if cell x + i is alive, 8 cells at a time.
+ * Masking leaves each alive cell as a 1 in its byte, and the multiply sums the 8 bytes into the top byte
+ * shifted so byte i lands on bit i.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells, at most 64.
+ * @return The alive bits.
+ */
+std::uint64_t ByteCells::load(const Word *row, const int x, const int count) {
+	const std::uint64_t low_bits = 0x0101010101010101ULL;
+	const Cell *cells = row + x;
+	std::uint64_t alive = 0;
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, cells + i, 8);
+		alive |= (((word & low_bits) * 0x0102040810204080ULL) >> 56) << i;
+	}
+	for (; i < count; i++) {
+		alive |= std::uint64_t(cells[i] & 1) << i;
 	}
+	return alive;
 }
+
+/**
+ * Scatter up to 64 cells from a word with bit i set if cell x + i is alive, 8 cells at a time.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells, at most 64.
+ * @param alive - The alive bits.
+ */
+void ByteCells::store(Word *row, const int x, const int count, const std::uint64_t alive) {
+	const std::uint64_t dead_bits = 0x2020202020202020ULL;
+	Cell *cells = row + x;
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		// Copy the 8 bits to every byte, keep bit i in byte i, then turn each non zero byte into 0x03
+		const std::uint64_t spread = (((alive >> i) & 0xff) * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+		const std::uint64_t ones = (((spread + 0x7f7f7f7f7f7f7f7fULL) & 0x8080808080808080ULL) >> 7);
+		const std::uint64_t word = dead_bits | (ones * 3);
+		std::memcpy(cells + i, &word, 8);
+	}
+	for (; i < count; i++) {
+		cells[i] = ((alive >> i) & 1) ? Cell::ALIVE : Cell::DEAD;
+	}
+}
+
+/**
+ * Set a run of cells to the same value.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells.
+ * @param value - The value to set.
+ */
+void ByteCells::fill(Word *row, const int x, const int count, const Cell value) {
+	if (count > 0) {
+		std::memset(row + x, value, count);
+	}
+}
+
+/**
+ * Copy a run of cells, which may overlap, like std::memmove.
+ * @param destination - The destination row.
+ * @param destination_x - The first destination cell.
+ * @param source - The source row.
+ * @param source_x - The first source cell.
+ * @param count - The number of cells.
+ */
+void ByteCells::move(Word *destination, const int destination_x, const Word *source, const int source_x,
+					 const int count) {
+	if (count > 0) {
+		std::memmove(destination + destination_x, source + source_x, count);
+	}
+}
+
+/**
+ * Write a run of cells to an ascii stream, which is the cells themselves.
+ * @param output_stream - The stream.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells.
+ */
+void ByteCells::write_row(std::ostream & output_stream, const Word *row, const int x, const int count) {
+	output_stream.write(reinterpret_cast<const char *>(row + x), count);
+}
+
+/**
+ * Count the set bits in a word.
+ * @param word - The word.
+ * @return The number of set bits.
+ */
+static unsigned int count_bits(std::uint64_t word) {
+#if defined(__GNUC__)
+	return __builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return static_cast<unsigned int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * A word with the lowest count bits set.
+ * @param count - The number of bits, 0 to 64.
+ * @return The mask.
+ */
+static std::uint64_t low_mask(const int count) {
+	return count >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+}
+
+/**
+ * Reverse the order of the 64 bits in a word.
+ * @param word - The word to reverse.
+ * @return The reversed word.
+ */
+static std::uint64_t reverse_bits(std::uint64_t word) {
+	word = ((word >> 1) & 0x5555555555555555ULL) | ((word & 0x5555555555555555ULL) << 1);
+	word = ((word >> 2) & 0x3333333333333333ULL) | ((word & 0x3333333333333333ULL) << 2);
+	word = ((word >> 4) & 0x0f0f0f0f0f0f0f0fULL) | ((word & 0x0f0f0f0f0f0f0f0fULL) << 4);
+	return reverse_bytes(word);
+}
+
+/**
+ * Transpose a 64x64 bit matrix in place, so bit k of rows[i] becomes bit i of rows[k].
+ * Swaps ever smaller off diagonal blocks, from 32x32 down to 1x1.
+ * @param rows - The 64 rows of the matrix.
+ */
+static void transpose_bits(std::uint64_t rows[64]) {
+	std::uint64_t mask = 0x00000000ffffffffULL;
+	for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+		for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			const std::uint64_t t = ((rows[k] >> j) ^ rows[k | j]) & mask;
+			rows[k] ^= t << j;
+			rows[k | j] ^= t;
+		}
+	}
+}
+
+/**
+ * BitCells::at(row, x)
+ *
+ * @param row - The row.
+ * @param x - The cell.
+ * @return A reference to the bit of the cell.
+ */
+BitCells::Reference BitCells::at(Word *row, const int x) {
+	return BitReference(row + (x >> 6), x & 63);
+}
+
+/**
+ * BitCells::at(row, x)
+ *
+ * @param row - The row.
+ * @param x - The cell.
+ * @return The value of the cell.
+ */
+BitCells::ConstReference BitCells::at(const Word *row, const int x) {
+	return ((row[x >> 6] >> (x & 63)) & 1) ? Cell::ALIVE : Cell::DEAD;
+}
+
+/**
+ * Read up to 64 cells starting anywhere in a row, from at most two words.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells, at most 64.
+ * @return The alive bits, cell x in bit 0.
+ */
+std::uint64_t BitCells::load(const Word *row, const int x, const int count) {
+	if (count <= 0) {
+		return 0;
+	}
+	row += x >> 6;
+	const int shift = x & 63;
+	std::uint64_t alive = row[0] >> shift;
+	if (shift != 0 && shift + count > 64) {
+		alive |= row[1] << (64 - shift);
+	}
+	return alive & low_mask(count);
+}
+
+/**
+ * Write up to 64 cells starting anywhere in a row, leaving the other bits of the words untouched.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells, at most 64.
+ * @param alive - The alive bits, cell x in bit 0.
+ */
+void BitCells::store(Word *row, const int x, const int count, std::uint64_t alive) {
+	if (count <= 0) {
+		return;
+	}
+	row += x >> 6;
+	const int shift = x & 63;
+	const std::uint64_t mask = low_mask(count);
+	alive &= mask;
+	row[0] = (row[0] & ~(mask << shift)) | (alive << shift);
+	if (shift != 0 && shift + count > 64) {
+		row[1] = (row[1] & ~(mask >> (64 - shift))) | (alive >> (64 - shift));
+	}
+}
+
+/**
+ * Count the alive cells in a run of cells, a word at a time.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells.
+ * @return The number of alive cells.
+ */
+unsigned int BitCells::count_alive(const Word *row, const int x, const int count) {
+	unsigned int total = 0;
+	for (int i = 0; i < count; i += 64) {
+		total += count_bits(load(row, x + i, std::min(64, count - i)));
+	}
+	return total;
+}
+
+/**
+ * Set a run of cells to the same value.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells.
+ * @param value - The value to set.
+ */
+void BitCells::fill(Word *row, const int x, const int count, const Cell value) {
+	const std::uint64_t alive = value == Cell::ALIVE ? ~std::uint64_t(0) : 0;
+	for (int i = 0; i < count; i += 64) {
+		store(row, x + i, std::min(64, count - i), alive);
+	}
+}
+
+/**
+ * Copy a run of cells, which may overlap, like std::memmove.
+ * Each 64 cell chunk is read before it is written, and the chunks are copied in the direction
+ * that never writes over a chunk which has not been read yet.
+ * @param destination - The destination row.
+ * @param destination_x - The first destination cell.
+ * @param source - The source row.
+ * @param source_x - The first source cell.
+ * @param count - The number of cells.
+ */
+void BitCells::move(Word *destination, int destination_x, const Word *source, int source_x, const int count) {
+	if (count <= 0) {
+		return;
+	}
+	destination += destination_x >> 6;
+	destination_x &= 63;
+	source += source_x >> 6;
+	source_x &= 63;
+
+	if (destination < source || (destination == source && destination_x <= source_x)) {
+		for (int i = 0; i < count; i += 64) {
+			const int chunk = std::min(64, count - i);
+			store(destination, destination_x + i, chunk, load(source, source_x + i, chunk));
+		}
+	} else {
+		for (int i = ((count - 1) / 64) * 64; i >= 0; i -= 64) {
+			const int chunk = std::min(64, count - i);
+			store(destination, destination_x + i, chunk, load(source, source_x + i, chunk));
+		}
+	}
+}
+
+/**
+ * Blend a run of source cells into a run of destination cells, 64 cells at a time.
+ * @param destination - The destination row.
+ * @param destination_x - The first destination cell.
+ * @param source - The source row, which must not overlap the destination cells.
+ * @param source_x - The first source cell.
+ * @param count - The number of cells to blend.
+ * @param blend - How to combine each destination cell with its source cell.
+ */
+void BitCells::blend(Word *destination, const int destination_x, const Word *source, const int source_x,
+					 const int count, const Blend blend) {
+	auto blend_words = [=](auto op) {
+		for (int i = 0; i < count; i += 64) {
+			const int chunk = std::min(64, count - i);
+			const std::uint64_t d = load(destination, destination_x + i, chunk);
+			const std::uint64_t s = load(source, source_x + i, chunk);
+			store(destination, destination_x + i, chunk, op(d, s));
+		}
+	};
+
+	switch (blend) {
+		case Blend::OVERWRITE:
+			move(destination, destination_x, source, source_x, count);
+			break;
+		case Blend::OR:
+			blend_words([](std::uint64_t d, std::uint64_t s) { return d | s; });
+			break;
+		case Blend::AND:
+			blend_words([](std::uint64_t d, std::uint64_t s) { return d & s; });
+			break;
+		case Blend::XOR:
+			blend_words([](std::uint64_t d, std::uint64_t s) { return d ^ s; });
+			break;
+		case Blend::AND_NOT:
+			blend_words([](std::uint64_t d, std::uint64_t s) { return d & ~s; });
+			break;
+	}
+}
+
+/**
+ * Write a bit-packed buffer with one of the 8 rotations or reflections applied to another bit-packed buffer.
+ * Reflections that keep rows as rows copy 64 cells at a time, reversing the bits of each word to mirror a row.
+ * Transposing symmetries load 64x64 blocks of cells into 64 words, transpose them as a bit matrix,
+ * and store each word as a run of a destination row.
+ * @param source - The first word of the source.
+ * @param source_stride - The number of words between source rows.
+ * @param width - The width of the source.
+ * @param height - The height of the source.
+ * @param destination - The first word of the destination, sized to fit the transformed source.
+ * @param destination_stride - The number of words between destination rows.
+ * @param symmetry - The rotation or reflection to apply.
+ */
+void BitCells::transform(const Word *source, const std::size_t source_stride, const int width, const int height,
+						 Word *destination, const std::size_t destination_stride, const Symmetry symmetry) {
+	const bool transposes = symmetry == Symmetry::ROTATE_90 || symmetry == Symmetry::ROTATE_270 ||
+							symmetry == Symmetry::TRANSPOSE || symmetry == Symmetry::ANTI_TRANSPOSE;
+	// The same flags as the one byte per cell transforms
+	const bool reverse_rows = symmetry == Symmetry::FLIP_TOP_BOTTOM || symmetry == Symmetry::ROTATE_180 ||
+							  symmetry == Symmetry::ROTATE_270 || symmetry == Symmetry::ANTI_TRANSPOSE;
+	const bool reverse_cells = symmetry == Symmetry::FLIP_LEFT_RIGHT || symmetry == Symmetry::ROTATE_180 ||
+							   symmetry == Symmetry::ROTATE_90 || symmetry == Symmetry::ANTI_TRANSPOSE;
+
+	if (!transposes) {
+		for (int y = 0; y < height; y++) {
+			const Word *from = source + y * source_stride;
+			Word *to = destination + (reverse_rows ? height - 1 - y : y) * destination_stride;
+			if (!reverse_cells) {
+				move(to, 0, from, 0, width);
+				continue;
+			}
+			for (int x = 0; x < width; x += 64) {
+				const int chunk = std::min(64, width - x);
+				store(to, x, chunk, reverse_bits(load(from, width - x - chunk, chunk)) >> (64 - chunk));
+			}
+		}
+		return;
+	}
+
+	std::uint64_t block[64];
+	for (int block_y = 0; block_y < height; block_y += 64) {
+		const int block_height = std::min(64, height - block_y);
+		for (int block_x = 0; block_x < width; block_x += 64) {
+			const int block_width = std::min(64, width - block_x);
+			for (int k = 0; k < 64; k++) {
+				block[k] = k < block_height ? load(source + (block_y + k) * source_stride, block_x, block_width) : 0;
+			}
+			transpose_bits(block);
+
+			// Word i now holds source column block_x + i, which becomes a run of one destination row
+			const int column = reverse_cells ? height - block_y - block_height : block_y;
+			for (int i = 0; i < block_width; i++) {
+				const int row = reverse_rows ? width - 1 - (block_x + i) : block_x + i;
+				const std::uint64_t run = reverse_cells ? reverse_bits(block[i]) >> (64 - block_height) : block[i];
+				store(destination + row * destination_stride, column, block_height, run);
+			}
+		}
+	}
+}
+
+/**
+ * Write a run of cells to an ascii stream, expanding 64 cells at a time.
+ * @param output_stream - The stream.
+ * @param row - The row.
+ * @param x - The first cell.
+ * @param count - The number of cells.
+ */
+void BitCells::write_row(std::ostream & output_stream, const Word *row, const int x, const int count) {
+	char text[64];
+	for (int i = 0; i < count; i += 64) {
+		const int chunk = std::min(64, count - i);
+		const std::uint64_t alive = load(row, x + i, chunk);
+		for (int k = 0; k < chunk; k++) {
+			text[k] = ((alive >> k) & 1) ? Cell::ALIVE : Cell::DEAD;
+		}
+		output_stream.write(text, chunk);
+	}
+}
+
+// Compile both layouts once, grid.h declares them extern so other files only link against them
+template class BasicGrid<ByteCells>;
+template class BasicGrid<BitCells>;
+template class BasicGridView<ByteCells>;
+template class BasicGridView<BitCells>;
+template BasicGrid<ByteCells>::BasicGrid(const BasicGrid<BitCells> &other);
+template BasicGrid<BitCells>::BasicGrid(const BasicGrid<ByteCells> &other);
+template std::ostream & operator<<(std::ostream & output_stream, const BasicGrid<ByteCells>& grid);
+template std::ostream & operator<<(std::ostream & output_stream, const BasicGrid<BitCells>& grid);
+template std::ostream & operator<<(std::ostream & output_stream, const BasicGridView<ByteCells>& view);
+template std::ostream & operator<<(std::ostream & output_stream, const BasicGridView<BitCells>& view);
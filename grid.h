@@ -10,8 +10,11 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <iostream>
+#include "allocator.h"
 
 // Add the minimal number of includes you need in order to declare the class.
 // #include ...
@@ -25,41 +28,300 @@ enum Cell : char {
 };
 
 /**
- * Declare the structure of the Grid class for representing a 2d grid of cells.
+ * The 8 rotations and reflections of a 2d grid.
+ * Rotations are clockwise, Symmetry::ROTATE_90 matches Grid::rotate(1).
  */
-class Grid {
+enum class Symmetry {
+	IDENTITY,
+	ROTATE_90,
+	ROTATE_180,
+	ROTATE_270,
+	FLIP_LEFT_RIGHT,
+	FLIP_TOP_BOTTOM,
+	TRANSPOSE,
+	ANTI_TRANSPOSE
+};
+
+/**
+ * Boolean operations for combining two grids in Grid::merge, treating alive cells as true.
+ */
+enum class Blend {
+	OVERWRITE,
+	OR,
+	AND,
+	XOR,
+	AND_NOT
+};
+
+/**
+ * The point of a grid which stays fixed when the grid is resized.
+ */
+enum class Anchor {
+	TOP_LEFT,
+	TOP,
+	TOP_RIGHT,
+	LEFT,
+	CENTRE,
+	RIGHT,
+	BOTTOM_LEFT,
+	BOTTOM,
+	BOTTOM_RIGHT
+};
+
+/**
+ * The hash of a pattern's size and cells, shared by GridView::hash, StaticGrid::hash and the Catalogue,
+ * so a pattern hashes to the same value whichever of them takes it.
+ * The width and height are mixed first, then each row as its whole words of 64 cells, lowest bit first,
+ * then the rest of the row as one more word, which is mixed even when empty.
+ * It is constexpr so a StaticGrid can be hashed while compiling.
+ */
+class CellHash {
+private:
+	std::uint64_t state;
+
+public:
+	constexpr CellHash(const int width, const int height) : state(14695981039346656037ULL) {
+		mix(static_cast<std::uint64_t>(width));
+		mix(static_cast<std::uint64_t>(height));
+	}
+
+	constexpr void mix(const std::uint64_t word) {
+		state ^= word;
+		state *= 1099511628211ULL;
+		state ^= state >> 29;
+	}
+
+	// Mix a row of cells one at a time, alive(x) tells whether cell x is alive
+	template <typename Alive>
+	constexpr void mix_row(const int width, const Alive &alive) {
+		std::uint64_t word = 0;
+		for (int x = 0; x < width; x++) {
+			if (alive(x)) {
+				word |= std::uint64_t(1) << (x % 64);
+			}
+			if (x % 64 == 63) {
+				mix(word);
+				word = 0;
+			}
+		}
+		mix(word);
+	}
+
+	// Final avalanche so that similar grids land far apart in a table
+	constexpr std::uint64_t finish() const {
+		std::uint64_t hash = state;
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		return hash;
+	}
+};
+
+/**
+ * A modifiable reference to one cell packed into a bit of a word, standing in for Cell & in bit-packed grids.
+ */
+class BitReference {
+private:
+	std::uint64_t *word;
+	std::uint64_t mask;
+
+public:
+	BitReference(std::uint64_t *word, int bit) : word(word), mask(std::uint64_t(1) << bit) {}
+
+	operator Cell() const {
+		return (*word & mask) ? Cell::ALIVE : Cell::DEAD;
+	}
+
+	BitReference & operator=(const Cell value) {
+		*word = (value == Cell::ALIVE) ? (*word | mask) : (*word & ~mask);
+		return *this;
+	}
+
+	BitReference & operator=(const BitReference &other) {
+		return *this = static_cast<Cell>(other);
+	}
+};
+
+/**
+ * Storage policies for the cells of a BasicGrid, chosen at compile time.
+ * A policy fixes how cells are packed into words, and supplies the kernels a grid runs over whole runs of cells.
+ * Runs start at cell x of a row and may cross word boundaries.
+ *      - ByteCells stores one Cell per byte, the layout Grid has always used.
+ *      - BitCells packs 64 cells per word, lowest bit first. Rows start on a word and their unused bits stay dead.
+ */
+struct ByteCells {
+	typedef Cell Word;
+	typedef Cell & Reference;
+	typedef const Cell & ConstReference;
+	static constexpr int cells_per_word = 1;
+	static constexpr Word dead_word = Cell::DEAD;
+
+	static Reference at(Word *row, int x);
+	static ConstReference at(const Word *row, int x);
+	static unsigned int count_alive(const Word *row, int x, int count);
+	static std::uint64_t load(const Word *row, int x, int count);
+	static void store(Word *row, int x, int count, std::uint64_t alive);
+	static void fill(Word *row, int x, int count, Cell value);
+	static void move(Word *destination, int destination_x, const Word *source, int source_x, int count);
+	static void blend(Word *destination, int destination_x, const Word *source, int source_x, int count, Blend blend);
+	static void transform(const Word *source, std::size_t source_stride, int width, int height,
+						  Word *destination, std::size_t destination_stride, Symmetry symmetry);
+	static void write_row(std::ostream & output_stream, const Word *row, int x, int count);
+};
+
+struct BitCells {
+	typedef std::uint64_t Word;
+	typedef BitReference Reference;
+	typedef Cell ConstReference;
+	static constexpr int cells_per_word = 64;
+	static constexpr Word dead_word = 0;
+
+	static Reference at(Word *row, int x);
+	static ConstReference at(const Word *row, int x);
+	static unsigned int count_alive(const Word *row, int x, int count);
+	static std::uint64_t load(const Word *row, int x, int count);
+	static void store(Word *row, int x, int count, std::uint64_t alive);
+	static void fill(Word *row, int x, int count, Cell value);
+	static void move(Word *destination, int destination_x, const Word *source, int source_x, int count);
+	static void blend(Word *destination, int destination_x, const Word *source, int source_x, int count, Blend blend);
+	static void transform(const Word *source, std::size_t source_stride, int width, int height,
+						  Word *destination, std::size_t destination_stride, Symmetry symmetry);
+	static void write_row(std::ostream & output_stream, const Word *row, int x, int count);
+};
+
+template <typename Storage> class BasicGridView;
+
+/**
+ * Declare the structure of the BasicGrid class for representing a 2d grid of cells stored with a Storage policy.
+ * Grid is the one byte per cell layout, BitGrid packs 64 cells into each word.
+ */
+template <typename Storage>
+class BasicGrid {
+public:
+	typedef typename Storage::Word Word;
+	typedef typename Storage::Reference Reference;
+	typedef typename Storage::ConstReference ConstReference;
+
 private:
-    std::vector<Cell> grid;
+    std::vector<Word, Memory::Allocator<Word>> grid;
     int grid_height;
     int grid_width;
 
-    unsigned int get_index(int x, int y) const;
+    std::size_t get_index(int y) const;
 	void check_if_in_bounds(int x, int y) const;
+	void check_if_row_in_bounds(int y) const;
+	void check_if_corner_in_bounds(int x, int y) const;
 	void zero_values_if_negative(int & x, int & y) const;
+	void clear_padding();
+
+	template <typename Other> friend class BasicGrid;
 
 public:
-    Grid();
-    explicit Grid(int gridSize);
-    explicit Grid(int width, int height);
+    BasicGrid();
+    explicit BasicGrid(int gridSize);
+    explicit BasicGrid(int width, int height);
+	BasicGrid(int width, int height, Memory::Policy policy);
+	template <typename Other> explicit BasicGrid(const BasicGrid<Other> &other);
+	BasicGrid(const BasicGrid &other) = default;
+	BasicGrid(BasicGrid &&other) noexcept;
+	BasicGrid& operator=(const BasicGrid &other) = default;
+	BasicGrid& operator=(BasicGrid &&other) noexcept;
 
     int get_width() const;
     int get_height() const;
+	int get_stride() const;
     unsigned int get_total_cells() const;
     unsigned int get_alive_cells() const;
     unsigned int get_dead_cells() const;
+    std::uint64_t hash() const;
+	Memory::Policy get_policy() const;
 
 	Cell get(int x, int y) const;
 	void set(int x, int y, Cell value);
 
 	void resize(int square_size);
     void resize(int width, int height);
+	void resize(int width, int height, Anchor anchor);
+	void resize(int width, int height, int x_offset, int y_offset);
+	void reserve(std::size_t cells);
+	std::size_t get_capacity() const;
+
+    Reference operator()(int x, int y);
+    ConstReference operator()(int x, int y) const;
+
+	Word * row(int y);
+	const Word * row(int y) const;
+
+	BasicGridView<Storage> view() const;
+	BasicGridView<Storage> crop_view(int x0, int y0, int x1, int y1) const;
+
+	BasicGrid crop(int x0, int y0, int x1, int y1) const;
+	void merge(const BasicGridView<Storage>& other, int x0, int y0, bool alive_only = false);
+	void merge(const BasicGridView<Storage>& other, int x0, int y0, Blend blend, bool clip = false);
+	BasicGrid rotate(int rotation) const;
+	BasicGrid flip() const;
+	BasicGrid transform(Symmetry symmetry) const;
+	void transform_into(BasicGrid& destination, Symmetry symmetry) const;
+};
+
+/**
+ * Declare the structure of the BasicGridView class for a read-only window onto the cells of a BasicGrid.
+ *
+ * A view does not own its cells, it points into a grid which must outlive it.
+ * Rows of the view are stride words apart, so a view can be a sub-region of a larger grid without copying.
+ * Each row starts offset cells into its first word, which is always 0 for one byte per cell views.
+ * Any function taking a const GridView& can be passed a Grid directly.
+ */
+template <typename Storage>
+class BasicGridView {
+public:
+	typedef typename Storage::Word Word;
+	typedef typename Storage::ConstReference ConstReference;
+
+private:
+	const Word *cells;
+	int view_width;
+	int view_height;
+	int view_stride;
+	int view_offset;
 
-    Cell & operator()(int x, int y);
-    const Cell & operator()(int x, int y) const;
+	void check_if_in_bounds(int x, int y) const;
+	void check_if_corner_in_bounds(int x, int y) const;
+
+public:
+	BasicGridView();
+	BasicGridView(const Word *cells, int width, int height, int stride, int offset = 0);
+	BasicGridView(const BasicGrid<Storage> &grid);
+
+	int get_width() const;
+	int get_height() const;
+	int get_stride() const;
+	int get_offset() const;
+	unsigned int get_total_cells() const;
+	unsigned int get_alive_cells() const;
+	unsigned int get_dead_cells() const;
+	std::uint64_t hash() const;
 
-	Grid crop(int x0, int y0, int x1, int y1) const;
-	void merge(const Grid& other, int x0, int y0, bool alive_only = false);
-	Grid rotate(int rotation) const;
+	Cell get(int x, int y) const;
+	ConstReference operator()(int x, int y) const;
+	const Word * row(int y) const;
 
-	friend std::ostream & operator<<(std::ostream & output_stream, const Grid& grid);
+	BasicGridView crop(int x0, int y0, int x1, int y1) const;
+	BasicGrid<Storage> materialize() const;
 };
+
+template <typename Storage>
+std::ostream & operator<<(std::ostream & output_stream, const BasicGrid<Storage>& grid);
+template <typename Storage>
+std::ostream & operator<<(std::ostream & output_stream, const BasicGridView<Storage>& view);
+
+typedef BasicGrid<ByteCells> Grid;
+typedef BasicGridView<ByteCells> GridView;
+typedef BasicGrid<BitCells> BitGrid;
+typedef BasicGridView<BitCells> BitGridView;
+
+// Both layouts are compiled once in grid.cpp
+extern template class BasicGrid<ByteCells>;
+extern template class BasicGrid<BitCells>;
+extern template class BasicGridView<ByteCells>;
+extern template class BasicGridView<BitCells>;
@@ -0,0 +1,253 @@
+/**
+ * Implements a Profile namespace for measuring phases of the simulation with hardware performance counters.
+ *      - Phases are named regions of code wrapped in a Profile::Scope.
+ *          - World::step is split into its neighbour count, rule application and buffer swap phases.
+ *          - The step kernels and the Zoo loaders and savers are each one phase.
+ *          - Each run of a phase adds its wall time and counter deltas to the totals for its name.
+ *
+ *      - Profiling is off until Profile::enable() is called.
+ *          - While off a scope costs one relaxed atomic load, and World::step takes its usual single pass.
+ *
+ *      - On Linux the counters are opened with perf_event_open for the calling thread, user space only.
+ *          - Each thread opens its own counters the first time it reads them, and closes them when it exits.
+ *          - A phase only counts the thread it ran on, work handed to other threads is timed but not counted.
+ *          - Counters the kernel refuses, for example under a strict perf_event_paranoid or in a virtual machine,
+ *            read as 0 and are reported as unavailable. Timings are always kept.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "profile.h"
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Whether scopes measure anything
+static std::atomic<bool> profiling(false);
+
+// Totals for each phase in the order they were first seen, guarded by phase_lock
+static std::mutex phase_lock;
+static std::vector<Profile::Phase> phase_totals;
+
+// Which counters have opened on any thread, so the report can tell a 0 from a missing counter
+static std::atomic<bool> opened[Profile::COUNTERS];
+
+#if defined(__linux__)
+/**
+ * The counters of one thread, opened on first use and closed when the thread exits.
+ */
+struct ThreadCounters {
+	int files[Profile::COUNTERS];
+
+	ThreadCounters() {
+		const std::uint64_t events[Profile::COUNTERS] = {
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_MISSES,
+			PERF_COUNT_HW_BRANCH_MISSES
+		};
+
+		for (int i = 0; i < Profile::COUNTERS; i++) {
+			perf_event_attr attributes;
+			std::memset(&attributes, 0, sizeof(attributes));
+			attributes.size = sizeof(attributes);
+			attributes.type = PERF_TYPE_HARDWARE;
+			attributes.config = events[i];
+			attributes.exclude_kernel = 1;
+			attributes.exclude_hv = 1;
+
+			// This thread, any cpu, no group
+			this->files[i] = static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+			if (this->files[i] >= 0) {
+				opened[i] = true;
+			}
+		}
+	}
+
+	~ThreadCounters() {
+		for (const int file : this->files) {
+			if (file >= 0) {
+				close(file);
+			}
+		}
+	}
+};
+#endif
+
+/**
+ * Profile::enable(on)
+ *
+ * Turn profiling on or off for every thread.
+ *
+ * @example
+ *
+ *      Profile::enable();
+ *      world.advance(100);
+ *      Profile::report(std::cout);
+ *
+ * @param on
+ *      Optional parameter. True to start measuring scopes, false to stop. Defaults to true.
+ */
+void Profile::enable(const bool on) {
+	profiling.store(on, std::memory_order_relaxed);
+}
+
+/**
+ * Profile::enabled()
+ *
+ * @return
+ *      True if scopes are being measured.
+ */
+bool Profile::enabled() {
+	return profiling.load(std::memory_order_relaxed);
+}
+
+/**
+ * Profile::counter_available(counter)
+ *
+ * @return
+ *      True if the counter has been opened on at least one thread.
+ */
+bool Profile::counter_available(const Counter counter) {
+	return opened[counter];
+}
+
+/**
+ * Profile::read()
+ *
+ * Read the clock and the calling thread's counters, opening them if this is the thread's first read.
+ *
+ * @return
+ *      The reading, with 0 for any counter which could not be opened.
+ */
+Profile::Reading Profile::read() {
+	Reading reading;
+#if defined(__linux__)
+	thread_local ThreadCounters thread_counters;
+	for (int i = 0; i < COUNTERS; i++) {
+		std::uint64_t value = 0;
+		if (thread_counters.files[i] >= 0 && ::read(thread_counters.files[i], &value, sizeof(value)) == sizeof(value)) {
+			reading.counters[i] = value;
+		}
+	}
+#endif
+	reading.time = std::chrono::steady_clock::now();
+	return reading;
+}
+
+/**
+ * Profile::add(name, start, end)
+ *
+ * Add one run of a phase to its totals.
+ *
+ * @param name
+ *      The name of the phase.
+ *
+ * @param start
+ *      The reading taken when the phase started.
+ *
+ * @param end
+ *      The reading taken when the phase ended, on the same thread.
+ */
+void Profile::add(const char *name, const Reading &start, const Reading &end) {
+	std::lock_guard<std::mutex> guard(phase_lock);
+
+	auto phase = phase_totals.begin();
+	while (phase != phase_totals.end() && phase->name != name) {
+		++phase;
+	}
+	if (phase == phase_totals.end()) {
+		phase_totals.emplace_back();
+		phase_totals.back().name = name;
+		phase = phase_totals.end() - 1;
+	}
+
+	phase->calls++;
+	phase->seconds += std::chrono::duration<double>(end.time - start.time).count();
+	for (int i = 0; i < COUNTERS; i++) {
+		phase->counters[i] += end.counters[i] - start.counters[i];
+	}
+}
+
+/**
+ * Profile::phases()
+ *
+ * @return
+ *      A copy of the totals of every phase, in the order they were first run.
+ */
+std::vector<Profile::Phase> Profile::phases() {
+	std::lock_guard<std::mutex> guard(phase_lock);
+	return phase_totals;
+}
+
+/**
+ * Profile::reset()
+ *
+ * Forget the totals of every phase.
+ */
+void Profile::reset() {
+	std::lock_guard<std::mutex> guard(phase_lock);
+	phase_totals.clear();
+}
+
+/**
+ * Profile::report(output_stream)
+ *
+ * Print a table of every phase with its calls, time, instructions per cycle and counter totals.
+ *
+ * @example
+ *
+ *      phase                              calls     seconds        cycles  instructions   IPC  cache misses  branch misses
+ *      World::step neighbour count           10       0.812    2810243171    7391201877  2.63        151032        4012338
+ *
+ * @param output_stream
+ *      The stream to print to.
+ */
+void Profile::report(std::ostream &output_stream) {
+	const std::vector<Phase> totals = phases();
+
+	auto counter = [](const Phase &phase, const Counter counter) -> std::string {
+		return counter_available(counter) ? std::to_string(phase.counters[counter]) : "n/a";
+	};
+
+	output_stream << std::left << std::setw(34) << "phase" << std::right
+				  << std::setw(8) << "calls"
+				  << std::setw(12) << "seconds"
+				  << std::setw(14) << "cycles"
+				  << std::setw(14) << "instructions"
+				  << std::setw(6) << "IPC"
+				  << std::setw(14) << "cache misses"
+				  << std::setw(15) << "branch misses" << std::endl;
+
+	for (const Phase &phase : totals) {
+		std::string ipc = "n/a";
+		if (counter_available(CYCLES) && counter_available(INSTRUCTIONS) && phase.counters[CYCLES] > 0) {
+			std::ostringstream ss;
+			ss << std::fixed << std::setprecision(2)
+			   << static_cast<double>(phase.counters[INSTRUCTIONS]) / phase.counters[CYCLES];
+			ipc = ss.str();
+		}
+
+		output_stream << std::left << std::setw(34) << phase.name << std::right
+					  << std::setw(8) << phase.calls
+					  << std::setw(12) << std::fixed << std::setprecision(3) << phase.seconds
+					  << std::setw(14) << counter(phase, CYCLES)
+					  << std::setw(14) << counter(phase, INSTRUCTIONS)
+					  << std::setw(6) << ipc
+					  << std::setw(14) << counter(phase, CACHE_MISSES)
+					  << std::setw(15) << counter(phase, BRANCH_MISSES) << std::endl;
+	}
+
+	if (!counter_available(CYCLES)) {
+		output_stream << "Hardware counters are unavailable, check /proc/sys/kernel/perf_event_paranoid" << std::endl;
+	}
+}
@@ -0,0 +1,98 @@
+/**
+ * Declares a Profile namespace for measuring phases of the simulation with hardware performance counters.
+ * Rich documentation for the api and behaviour the Profile namespace can be found in profile.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Declare the interface of the Profile namespace for timing and counting named phases.
+ */
+namespace Profile {
+
+	/**
+	 * The hardware events counted for each phase.
+	 *      - CYCLES and INSTRUCTIONS give instructions per cycle.
+	 *      - CACHE_MISSES are last level cache misses, a sign of running out of memory bandwidth.
+	 *      - BRANCH_MISSES are mispredicted branches.
+	 */
+	enum Counter {
+		CYCLES,
+		INSTRUCTIONS,
+		CACHE_MISSES,
+		BRANCH_MISSES,
+		COUNTERS
+	};
+
+	/**
+	 * The totals of every run of one named phase.
+	 * A counter is 0 if it could not be opened on this machine.
+	 */
+	struct Phase {
+		std::string name;
+		std::uint64_t calls = 0;
+		double seconds = 0;
+		std::uint64_t counters[COUNTERS] = {};
+	};
+
+	/**
+	 * A reading of the counters and clock at one moment, on the calling thread.
+	 */
+	struct Reading {
+		std::chrono::steady_clock::time_point time;
+		std::uint64_t counters[COUNTERS] = {};
+	};
+
+	void enable(bool on = true);
+	bool enabled();
+	bool counter_available(Counter counter);
+
+	Reading read();
+	void add(const char *name, const Reading &start, const Reading &end);
+
+	std::vector<Phase> phases();
+	void reset();
+	void report(std::ostream &output_stream);
+
+	/**
+	 * Measure the lifetime of a scope as one run of a named phase, if profiling is enabled.
+	 * The name must outlive the profile, a string literal is expected.
+	 *
+	 * @example
+	 *
+	 *      {
+	 *          Profile::Scope scope("load soup");
+	 *          grid = Zoo::load_ascii("soup.gol");
+	 *      }
+	 */
+	class Scope {
+	private:
+		const char *name;
+		bool active;
+		Reading start;
+
+	public:
+		explicit Scope(const char *name) : name(name), active(enabled()) {
+			if (this->active) {
+				this->start = read();
+			}
+		}
+
+		~Scope() {
+			if (this->active) {
+				add(this->name, this->start, read());
+			}
+		}
+
+		Scope(const Scope &) = delete;
+		Scope & operator=(const Scope &) = delete;
+	};
+};
@@ -0,0 +1,907 @@
+/**
+ * Implements a Server namespace for a long running simulation daemon on a Unix domain socket, and a client for it.
+ *      - The daemon keeps worlds resident between requests, so a service can load a pattern once and advance it
+ *        many times without paying for a process, a parse or a file each time.
+ *          - Worlds are bit-packed and stepped with the bit-packed kernel, each with its own pair of buffers.
+ *          - Worlds are named by a 32 bit id chosen by the client.
+ *
+ *      - The protocol is a stream of binary frames in native byte order, as the .bgol format already is.
+ *          - A request is a 4 byte payload size, a 1 byte Opcode, a 4 byte world id, and the payload.
+ *          - A response is a 4 byte payload size, a 1 byte status, 0 for success and 1 for an error, and the payload.
+ *            The payload of an error is its message.
+ *
+ *      - The requests are:
+ *          - LOAD, payload a .bgol file. Replaces the world and resets its generation to 0.
+ *            A load which fails leaves the world as it was, or unmade if it was not loaded before.
+ *          - LOAD_RLE, payload the text of a run length encoded .rle file. Replaces the world as LOAD does.
+ *            The pattern may have at most 8 cells per byte of the largest message, as many as a LOAD could carry.
+ *          - LOAD_FILE, payload a path. Loads a .bgol file if the path ends in .bgol, an .rle file if it ends
+ *            in .rle, and an ascii .gol file otherwise.
+ *          - ADVANCE, payload a 4 byte number of generations and a 1 byte toroidal flag. Responds with INFO
+ *            once every generation has been stepped.
+ *          - QUERY, payload 4 byte x0, y0, x1, y1. Responds with the window [x0, x1) by [y0, y1) as a .bgol file.
+ *          - CENSUS, no payload. Responds with the census of the world as text.
+ *          - INFO, no payload. Responds with the 4 byte width and height, 8 byte generation and 4 byte population.
+ *          - DROP, no payload. Frees the world.
+ *          - SET_RULE, payload a rule such as B3/S23. The worlds only step Conway's rule, so any other is an error.
+ *          - SHUTDOWN, no payload. Responds, then closes every connection and stops the daemon.
+ *
+ *      - The daemon is a single thread polling every connection, so requests are handled one at a time
+ *        and worlds are never shared between threads.
+ *          - Connections are non-blocking, so a client slow to send or read never blocks another. Partial frames
+ *            are kept per connection until the rest arrives, and responses the socket will not take yet are
+ *            queued per connection and sent as poll reports it writable.
+ *          - A long ADVANCE is stepped in turns of about turn_cells cell generations, with the other connections
+ *            served between turns, so advancing one world a million generations does not stall the rest.
+ *            The connection's later requests wait until its ADVANCE is done, and its world can be queried,
+ *            loaded or dropped by others between turns. A dropped world ends the ADVANCE with an error.
+ *          - A connection with responses queued is not read from until they are sent, so a client which sends
+ *            requests but never reads the responses only stalls itself, and its queue stays bounded.
+ *          - On SHUTDOWN queued responses, including the one to SHUTDOWN, are given a second to drain.
+ *          - Input, output and stepping buffers are kept between requests, so once they have grown to fit the
+ *            largest world, loading, advancing, querying and reporting on it do not allocate.
+ *            A census builds its object list and text afresh, and a new world or connection allocates once.
+ *          - Stepping splits a world large enough into bands run on a Workers::Pool started once when the
+ *            daemon starts, so advancing a world starts no threads.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "server.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "census.h"
+#include "topology.h"
+#include "workers.h"
+#include "world.h"
+#include "zoo.h"
+
+// The sizes of the frame headers
+static const std::size_t request_header = 9;
+static const std::size_t response_header = 5;
+
+// Bytes read from a connection at a time
+static const std::size_t read_size = 1 << 16;
+
+// How long queued responses are given to drain when the daemon shuts down
+static const std::chrono::milliseconds drain_time(1000);
+
+// The cells stepped for one ADVANCE before the other connections are served, a few milliseconds of the bit kernel
+static const std::uint64_t turn_cells = std::uint64_t(1) << 24;
+
+/**
+ * A world resident in the daemon, with its own buffers.
+ */
+struct Resident {
+	BitGrid current;
+	BitGrid next;
+	std::uint64_t generation = 0;
+};
+
+/**
+ * An ADVANCE being stepped a turn at a time, with the generations it has left to step.
+ */
+struct Advance {
+	std::uint32_t world = 0;
+	std::uint32_t left = 0;
+	bool toroidal = false;
+};
+
+/**
+ * A client connection, the bytes it has sent which have not been handled yet,
+ * and the responses it has not been sent yet.
+ *      - closing is set once a response is the last the connection gets, it is closed when that has been sent.
+ *      - advance has generations left while an ADVANCE is being stepped, and no more requests are handled until then.
+ */
+struct Connection {
+	int socket;
+	std::vector<unsigned char> input;
+	std::size_t used = 0;
+	std::vector<unsigned char> output;
+	std::size_t sent = 0;
+	bool closing = false;
+	Advance advance;
+};
+
+/**
+ * Throw the last socket error.
+ * @param what - The call which failed.
+ *
+ * @throws - std::runtime_error with the error's description.
+ */
+static void throw_socket_error(const std::string &what) {
+	throw std::runtime_error(Server::socket_error + what + ": " + std::strerror(errno));
+}
+
+/**
+ * Make the address of a socket file.
+ * @param path - The path of the socket file.
+ * @return The address.
+ *
+ * @throws - std::runtime_error if the path is too long for a socket address.
+ */
+static sockaddr_un socket_address(const std::string &path) {
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(address.sun_path)) {
+		throw std::runtime_error(Server::socket_error + "path too long: " + path);
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size());
+	return address;
+}
+
+/**
+ * Send every byte on a blocking socket, waiting for it to drain if it has to. Only the client blocks.
+ * @param socket - The socket to write to.
+ * @param data - The bytes.
+ * @param size - The number of bytes.
+ * @return True if every byte was sent, false if the connection was closed.
+ */
+static bool send_all(const int socket, const unsigned char *data, std::size_t size) {
+	while (size > 0) {
+		const ssize_t sent = ::send(socket, data, size, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR) {
+			continue;
+		}
+		if (sent <= 0) {
+			return false;
+		}
+		data += sent;
+		size -= static_cast<std::size_t>(sent);
+	}
+	return true;
+}
+
+/**
+ * Make a socket's sends and receives return at once instead of waiting.
+ * @param socket - The socket.
+ * @return True if the socket is now non-blocking.
+ */
+static bool set_non_blocking(const int socket) {
+	const int flags = ::fcntl(socket, F_GETFL, 0);
+	return flags >= 0 && ::fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+/**
+ * Queue a response on a connection, after any it has not been sent yet.
+ * @param connection - The connection.
+ * @param status - 0 for success and 1 for an error.
+ * @param payload - The response payload.
+ * @param size - The size of the payload.
+ */
+static void queue_response(Connection &connection, const unsigned char status, const unsigned char *payload,
+						   const std::size_t size) {
+	std::vector<unsigned char> &output = connection.output;
+	const std::uint32_t length = static_cast<std::uint32_t>(size);
+	const std::size_t start = output.size();
+	output.resize(start + response_header + size);
+	std::memcpy(output.data() + start, &length, 4);
+	output[start + 4] = status;
+	if (size > 0) {
+		std::memcpy(output.data() + start + response_header, payload, size);
+	}
+}
+
+/**
+ * Send as much of a connection's queued output as its socket will take without waiting.
+ * The queue is emptied, keeping its capacity, once every byte has been sent.
+ * @param connection - The connection.
+ * @return False if the connection was closed or failed.
+ */
+static bool send_queued(Connection &connection) {
+	while (connection.sent < connection.output.size()) {
+		const ssize_t sent = ::send(connection.socket, connection.output.data() + connection.sent,
+									connection.output.size() - connection.sent, MSG_NOSIGNAL);
+		if (sent < 0 && errno == EINTR) {
+			continue;
+		}
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return true;
+		}
+		if (sent <= 0) {
+			return false;
+		}
+		connection.sent += static_cast<std::size_t>(sent);
+	}
+	connection.output.clear();
+	connection.sent = 0;
+	return true;
+}
+
+/**
+ * Close a connection, marking it to be removed.
+ * @param connection - The connection.
+ */
+static void close_connection(Connection &connection) {
+	::close(connection.socket);
+	connection.socket = -1;
+}
+
+/**
+ * Receive exactly size bytes, waiting for them to arrive.
+ * @param socket - The socket to read from.
+ * @param data - Where to put the bytes.
+ * @param size - The number of bytes.
+ * @return True if every byte arrived, false if the connection was closed first.
+ */
+static bool receive_all(const int socket, unsigned char *data, std::size_t size) {
+	while (size > 0) {
+		const ssize_t received = ::recv(socket, data, size, 0);
+		if (received < 0 && errno == EINTR) {
+			continue;
+		}
+		if (received <= 0) {
+			return false;
+		}
+		data += received;
+		size -= static_cast<std::size_t>(received);
+	}
+	return true;
+}
+
+/**
+ * Copy a value into a byte buffer at an offset, in native byte order.
+ */
+template <typename Value>
+static void put(std::vector<unsigned char> &bytes, const std::size_t offset, const Value value) {
+	std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+/**
+ * Copy a value out of a byte buffer at an offset, in native byte order.
+ */
+template <typename Value>
+static Value get(const unsigned char *bytes, const std::size_t offset) {
+	Value value;
+	std::memcpy(&value, bytes + offset, sizeof(value));
+	return value;
+}
+
+/**
+ * Decode the response to an INFO or ADVANCE request.
+ * @param bytes - The response payload.
+ * @return The size, generation and population it holds.
+ *
+ * @throws - std::runtime_error if the payload is too short.
+ */
+static Server::Info read_info(const std::vector<unsigned char> &bytes) {
+	if (bytes.size() < 20) {
+		throw std::runtime_error(Server::message_too_short_error);
+	}
+	Server::Info info;
+	info.width = get<std::int32_t>(bytes.data(), 0);
+	info.height = get<std::int32_t>(bytes.data(), 4);
+	info.generation = get<std::uint64_t>(bytes.data(), 8);
+	info.population = get<std::uint32_t>(bytes.data(), 16);
+	return info;
+}
+
+/**
+ * Write the response to an INFO or ADVANCE request.
+ * @param world - The world.
+ * @param output - Replaced with the response payload.
+ */
+static void write_info(const Resident &world, std::vector<unsigned char> &output) {
+	output.resize(20);
+	put<std::int32_t>(output, 0, world.current.get_width());
+	put<std::int32_t>(output, 4, world.current.get_height());
+	put<std::uint64_t>(output, 8, world.generation);
+	put<std::uint32_t>(output, 16, world.current.get_alive_cells());
+}
+
+/**
+ * Handle one request against the resident worlds, writing the response payload.
+ * An ADVANCE of any generations is only checked and started, its response is written as its last turn is stepped.
+ * @param worlds - The resident worlds.
+ * @param loading - The grid a pattern is decoded into, swapped into its world only once the whole pattern is read.
+ * @param options - The daemon's options.
+ * @param opcode - The request.
+ * @param id - The world the request names.
+ * @param payload - The request's payload.
+ * @param size - The size of the payload.
+ * @param output - Replaced with the response payload.
+ * @param advance - Set to the ADVANCE started, if the request starts one.
+ * @return True if the daemon should shut down.
+ *
+ * @throws - std::runtime_error or sub-class if the request cannot be carried out.
+ */
+static bool handle(std::unordered_map<std::uint32_t, Resident> &worlds, BitGrid &loading,
+				   const Server::Options &options, const unsigned char opcode, const std::uint32_t id,
+				   const unsigned char *payload, const std::size_t size, std::vector<unsigned char> &output,
+				   Advance &advance) {
+	output.clear();
+
+	auto find = [&worlds, id]() -> Resident & {
+		const auto found = worlds.find(id);
+		if (found == worlds.end()) {
+			throw std::runtime_error(Server::unknown_world_error + std::to_string(id));
+		}
+		return found->second;
+	};
+	// A world is only made or changed once its new cells have been read whole, so a bad load leaves it as it was.
+	// Its old cells are swapped out into the grid loaded from, to be reused by the next load
+	auto replace = [&worlds, id](BitGrid &grid) {
+		Resident &world = worlds[id];
+		std::swap(world.current, grid);
+		world.generation = 0;
+	};
+
+	switch (opcode) {
+		case Server::LOAD:
+			Zoo::decode_binary(payload, size, loading);
+			replace(loading);
+			return false;
+		case Server::LOAD_RLE:
+			Zoo::decode_rle(reinterpret_cast<const char *>(payload), size, loading,
+							static_cast<std::size_t>(options.max_message) * 8);
+			replace(loading);
+			return false;
+		case Server::LOAD_FILE: {
+			const std::string path(reinterpret_cast<const char *>(payload), size);
+			auto ends_with = [&path](const std::string &extension) {
+				return path.size() >= extension.size() &&
+					   path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+			};
+			BitGrid grid = ends_with(".bgol") ? Zoo::load_binary<BitCells>(path) :
+						   ends_with(".rle") ? Zoo::load_rle<BitCells>(path) : Zoo::load_ascii<BitCells>(path);
+			replace(grid);
+			return false;
+		}
+		case Server::ADVANCE: {
+			if (size < 5) {
+				throw std::runtime_error(Server::message_too_short_error);
+			}
+			const Resident &world = find();
+			advance.world = id;
+			advance.left = get<std::uint32_t>(payload, 0);
+			advance.toroidal = payload[4] != 0;
+			if (advance.left == 0) {
+				write_info(world, output);
+			}
+			return false;
+		}
+		case Server::QUERY: {
+			if (size < 16) {
+				throw std::runtime_error(Server::message_too_short_error);
+			}
+			const Resident &world = find();
+			const BitGridView window = world.current.crop_view(get<std::int32_t>(payload, 0), get<std::int32_t>(payload, 4),
+															   get<std::int32_t>(payload, 8), get<std::int32_t>(payload, 12));
+			Zoo::encode_binary(window, output);
+			return false;
+		}
+		case Server::CENSUS: {
+			std::ostringstream text;
+			text << Census::take(Grid(find().current), 0, options.threads);
+			const std::string census = text.str();
+			output.assign(census.begin(), census.end());
+			return false;
+		}
+		case Server::INFO:
+			write_info(find(), output);
+			return false;
+		case Server::DROP:
+			find();
+			worlds.erase(id);
+			return false;
+		case Server::SHUTDOWN:
+			return true;
+		case Server::SET_RULE:
+			find();
+			Zoo::check_rule(std::string(reinterpret_cast<const char *>(payload), size));
+			return false;
+		default:
+			throw std::runtime_error(Server::unknown_opcode_error + std::to_string(opcode));
+	}
+}
+
+/**
+ * Step a connection's ADVANCE for one turn, and queue its response once the last generation has been stepped.
+ * @param worlds - The resident worlds.
+ * @param options - The daemon's options.
+ * @param connection - The connection, with generations left to advance.
+ * @param output - Used for the response payload.
+ */
+static void advance_turn(std::unordered_map<std::uint32_t, Resident> &worlds, const Server::Options &options,
+						 Connection &connection, std::vector<unsigned char> &output) {
+	Advance &advance = connection.advance;
+	const auto found = worlds.find(advance.world);
+	if (found == worlds.end()) {
+		const std::string message = Server::unknown_world_error + std::to_string(advance.world);
+		queue_response(connection, 1, reinterpret_cast<const unsigned char *>(message.data()), message.size());
+		advance.left = 0;
+		return;
+	}
+
+	Resident &world = found->second;
+	const std::uint64_t cells = static_cast<std::uint64_t>(world.current.get_width()) * world.current.get_height();
+	const std::uint64_t per_turn = std::max<std::uint64_t>(1, turn_cells / std::max<std::uint64_t>(1, cells));
+	const std::uint32_t turn = advance.left < per_turn ? advance.left : static_cast<std::uint32_t>(per_turn);
+	for (std::uint32_t i = 0; i < turn; i++) {
+		BitWorld::step(world.current, world.next, advance.toroidal, options.threads);
+		std::swap(world.current, world.next);
+	}
+	world.generation += turn;
+	advance.left -= turn;
+
+	if (advance.left == 0) {
+		write_info(world, output);
+		queue_response(connection, 0, output.data(), output.size());
+	}
+}
+
+/**
+ * Handle every whole request a connection has sent, queueing each response, until one starts an ADVANCE.
+ * Any partial request, and any after the ADVANCE, is kept at the front of its input for later.
+ * @param worlds - The resident worlds.
+ * @param loading - The grid patterns are decoded into.
+ * @param options - The daemon's options.
+ * @param connection - The connection.
+ * @param output - Used for each response payload.
+ * @return True if the daemon should shut down.
+ */
+static bool handle_requests(std::unordered_map<std::uint32_t, Resident> &worlds, BitGrid &loading,
+							const Server::Options &options, Connection &connection, std::vector<unsigned char> &output) {
+	bool stopping = false;
+	std::size_t start = 0;
+	while (!connection.closing && !stopping && connection.advance.left == 0 && connection.used - start >= request_header) {
+		const unsigned char *frame = connection.input.data() + start;
+		const std::uint32_t size = get<std::uint32_t>(frame, 0);
+		if (size > options.max_message) {
+			const std::string message = Server::message_too_large_error + std::to_string(options.max_message);
+			queue_response(connection, 1, reinterpret_cast<const unsigned char *>(message.data()), message.size());
+			connection.closing = true;
+			break;
+		}
+		if (connection.used - start < request_header + size) {
+			break;
+		}
+
+		unsigned char status = 0;
+		try {
+			stopping = handle(worlds, loading, options, frame[4], get<std::uint32_t>(frame, 5), frame + request_header,
+							  size, output, connection.advance);
+		}
+		catch (const std::exception &ex) {
+			const std::string message = ex.what();
+			output.assign(message.begin(), message.end());
+			status = 1;
+		}
+		if (connection.advance.left == 0) {
+			queue_response(connection, status, output.data(), output.size());
+		}
+		start += request_header + size;
+	}
+
+	// Keep any partial frame at the front of the buffer for the next read
+	std::memmove(connection.input.data(), connection.input.data() + start, connection.used - start);
+	connection.used -= start;
+	return stopping;
+}
+
+/**
+ * Server::serve(path, options)
+ *
+ * Listen on a Unix domain socket and answer requests until a client sends SHUTDOWN.
+ * Any file already at the path is removed first, and the socket file is removed on shutdown.
+ *
+ * @example
+ *
+ *      // Serve on every core until told to stop
+ *      Server::Options options;
+ *      options.threads = 0;
+ *      Server::serve("/tmp/gol.sock", options);
+ *
+ * @param path
+ *      The path of the socket file.
+ *
+ * @param options
+ *      Optional parameter. The threads to step with and the largest request to accept.
+ *
+ * @throws
+ *      Throws std::runtime_error if the socket cannot be made, bound or listened on.
+ */
+void Server::serve(const std::string &path, const Options &options) {
+	const sockaddr_un address = socket_address(path);
+
+	const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listener < 0) {
+		throw_socket_error("socket");
+	}
+	::unlink(path.c_str());
+	if (::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0 ||
+		::listen(listener, 64) < 0) {
+		const int error = errno;
+		::close(listener);
+		errno = error;
+		throw_socket_error("bind " + path);
+	}
+
+	if (!set_non_blocking(listener)) {
+		const int error = errno;
+		::close(listener);
+		errno = error;
+		throw_socket_error("fcntl");
+	}
+
+	// Every world is stepped on the same workers, started now rather than on the first large step.
+	// Pinned steps run every band on a worker, otherwise the daemon's thread steps the first
+	const unsigned int threads = options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads;
+	Workers::Pool pool(Topology::enabled() ? threads : threads - 1);
+	Workers::Use use(pool);
+
+	std::unordered_map<std::uint32_t, Resident> worlds;
+	BitGrid loading;
+	std::vector<Connection> connections;
+	std::vector<pollfd> polls;
+	std::vector<unsigned char> output;
+	bool running = true;
+
+	while (running) {
+		// A connection with responses waiting is only polled to send them, and one closing or advancing is not read.
+		// While any connection is advancing, poll only looks at what is ready, so the next turn is not held up
+		polls.assign(1, pollfd{listener, POLLIN, 0});
+		bool advancing = false;
+		for (const Connection &connection : connections) {
+			const bool waiting = connection.closing || connection.advance.left > 0;
+			const short events = connection.sent < connection.output.size() ? POLLOUT : waiting ? 0 : POLLIN;
+			polls.push_back(pollfd{connection.socket, events, 0});
+			advancing = advancing || connection.advance.left > 0;
+		}
+		if (::poll(polls.data(), polls.size(), advancing ? 0 : -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			throw_socket_error("poll");
+		}
+
+		// Connections are dropped by marking their socket -1 and removed after every one has been served
+		for (std::size_t c = 0; c < connections.size() && running; c++) {
+			Connection &connection = connections[c];
+			const short events = polls[c + 1].revents;
+			if (connection.advance.left > 0) {
+				// Step a turn, and once the ADVANCE is done handle the requests which came after it
+				advance_turn(worlds, options, connection, output);
+				if (connection.advance.left == 0) {
+					running = !handle_requests(worlds, loading, options, connection, output);
+				}
+				if (!send_queued(connection)) {
+					close_connection(connection);
+				}
+				continue;
+			}
+			if (events & POLLOUT) {
+				if (!send_queued(connection) || (connection.closing && connection.output.empty())) {
+					close_connection(connection);
+				}
+				continue;
+			}
+			if (!(events & (POLLIN | POLLHUP | POLLERR))) {
+				continue;
+			}
+
+			// Read at least the rest of a large frame at once, once its header says how large it is
+			std::size_t wanted = read_size;
+			if (connection.used >= request_header) {
+				const std::uint32_t size = get<std::uint32_t>(connection.input.data(), 0);
+				if (size <= options.max_message) {
+					wanted = std::max(wanted, request_header + size - std::min<std::size_t>(connection.used, request_header + size));
+				}
+			}
+			if (connection.input.size() < connection.used + wanted) {
+				connection.input.resize(connection.used + wanted);
+			}
+			const ssize_t received = ::recv(connection.socket, connection.input.data() + connection.used, wanted, 0);
+			if (received <= 0) {
+				if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+					continue;
+				}
+				close_connection(connection);
+				continue;
+			}
+			connection.used += static_cast<std::size_t>(received);
+			running = !handle_requests(worlds, loading, options, connection, output);
+
+			// Most responses fit in the socket's buffer, so they are sent now rather than after another poll
+			if (!send_queued(connection) || (connection.closing && connection.output.empty())) {
+				close_connection(connection);
+			}
+		}
+
+		connections.erase(std::remove_if(connections.begin(), connections.end(), [](const Connection &connection) {
+			return connection.socket < 0;
+		}), connections.end());
+
+		if (running && (polls[0].revents & POLLIN)) {
+			const int accepted = ::accept(listener, nullptr, nullptr);
+			if (accepted >= 0) {
+				if (set_non_blocking(accepted)) {
+					connections.push_back(Connection{accepted, {}, 0, {}, 0, false, Advance()});
+				} else {
+					::close(accepted);
+				}
+			}
+		}
+	}
+
+	// Give the responses still queued, such as the one to SHUTDOWN, a moment to reach their clients
+	const auto deadline = std::chrono::steady_clock::now() + drain_time;
+	while (true) {
+		connections.erase(std::remove_if(connections.begin(), connections.end(), [](Connection &connection) {
+			if (connection.output.empty()) {
+				close_connection(connection);
+				return true;
+			}
+			return false;
+		}), connections.end());
+		const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+		if (connections.empty() || left.count() <= 0) {
+			break;
+		}
+
+		polls.clear();
+		for (const Connection &connection : connections) {
+			polls.push_back(pollfd{connection.socket, POLLOUT, 0});
+		}
+		if (::poll(polls.data(), polls.size(), static_cast<int>(left.count())) < 0 && errno != EINTR) {
+			break;
+		}
+		for (std::size_t c = 0; c < connections.size(); c++) {
+			if ((polls[c].revents & (POLLOUT | POLLHUP | POLLERR)) && !send_queued(connections[c])) {
+				connections[c].output.clear();
+			}
+		}
+	}
+
+	for (const Connection &connection : connections) {
+		::close(connection.socket);
+	}
+	::close(listener);
+	::unlink(path.c_str());
+}
+
+/**
+ * Server::Client::Client(path)
+ *
+ * Connect to a daemon.
+ *
+ * @param path
+ *      The path of the daemon's socket file.
+ *
+ * @throws
+ *      Throws std::runtime_error if the daemon cannot be connected to.
+ */
+Server::Client::Client(const std::string &path) : socket(-1) {
+	const sockaddr_un address = socket_address(path);
+	this->socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (this->socket < 0) {
+		throw_socket_error("socket");
+	}
+	if (::connect(this->socket, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) < 0) {
+		const int error = errno;
+		::close(this->socket);
+		errno = error;
+		throw_socket_error("connect " + path);
+	}
+}
+
+/**
+ * Server::Client::~Client()
+ *
+ * Close the connection.
+ */
+Server::Client::~Client() {
+	if (this->socket >= 0) {
+		::close(this->socket);
+	}
+}
+
+/**
+ * Send the payload as a request and wait for the response.
+ * @param opcode - The request.
+ * @param world - The world the request names.
+ * @return The response payload.
+ *
+ * @throws - std::runtime_error with the daemon's message if the request failed, or if the connection closed.
+ */
+const std::vector<unsigned char> & Server::Client::request(const Opcode opcode, const std::uint32_t world) {
+	unsigned char header[request_header];
+	const std::uint32_t size = static_cast<std::uint32_t>(this->payload.size());
+	std::memcpy(header, &size, 4);
+	header[4] = opcode;
+	std::memcpy(header + 5, &world, 4);
+	if (!send_all(this->socket, header, request_header) ||
+		!send_all(this->socket, this->payload.data(), this->payload.size())) {
+		throw std::runtime_error(connection_closed_error);
+	}
+
+	unsigned char reply[response_header];
+	if (!receive_all(this->socket, reply, response_header)) {
+		throw std::runtime_error(connection_closed_error);
+	}
+	this->response.resize(get<std::uint32_t>(reply, 0));
+	if (!receive_all(this->socket, this->response.data(), this->response.size())) {
+		throw std::runtime_error(connection_closed_error);
+	}
+	if (reply[4] != 0) {
+		throw std::runtime_error(std::string(this->response.begin(), this->response.end()));
+	}
+	return this->response;
+}
+
+/**
+ * Server::Client::load(world, grid)
+ *
+ * Make a world resident from a grid, replacing any world with the same id.
+ *
+ * @param world
+ *      The id of the world.
+ *
+ * @param grid
+ *      The starting cells.
+ */
+void Server::Client::load(const std::uint32_t world, const GridView &grid) {
+	Zoo::encode_binary(grid, this->payload);
+	request(LOAD, world);
+}
+
+/**
+ * Server::Client::load(world, grid)
+ *
+ * Make a world resident from a bit-packed grid, replacing any world with the same id.
+ */
+void Server::Client::load(const std::uint32_t world, const BitGridView &grid) {
+	Zoo::encode_binary(grid, this->payload);
+	request(LOAD, world);
+}
+
+/**
+ * Server::Client::load_rle(world, text)
+ *
+ * Make a world resident from a run length encoded pattern, replacing any world with the same id.
+ *
+ * @param world
+ *      The id of the world.
+ *
+ * @param text
+ *      The text of an .rle file, header included.
+ */
+void Server::Client::load_rle(const std::uint32_t world, const std::string &text) {
+	this->payload.assign(text.begin(), text.end());
+	request(LOAD_RLE, world);
+}
+
+/**
+ * Server::Client::load_file(world, path)
+ *
+ * Make a world resident from a file the daemon can read, .bgol binary, .rle run length encoded or .gol ascii.
+ *
+ * @param world
+ *      The id of the world.
+ *
+ * @param path
+ *      The path of the file, relative to the daemon's working directory.
+ */
+void Server::Client::load_file(const std::uint32_t world, const std::string &path) {
+	this->payload.assign(path.begin(), path.end());
+	request(LOAD_FILE, world);
+}
+
+/**
+ * Server::Client::set_rule(world, rule)
+ *
+ * Ask for a resident world to step by a rule. Only Conway's B3/S23 is supported, so this checks that a
+ * client expecting another rule finds out before it advances the world.
+ *
+ * @param world
+ *      The id of the world.
+ *
+ * @param rule
+ *      The rule, such as B3/S23.
+ *
+ * @throws
+ *      Throws std::runtime_error with the daemon's message if the rule is any other.
+ */
+void Server::Client::set_rule(const std::uint32_t world, const std::string &rule) {
+	this->payload.assign(rule.begin(), rule.end());
+	request(SET_RULE, world);
+}
+
+/**
+ * Server::Client::advance(world, generations, toroidal)
+ *
+ * Step a resident world forward.
+ *
+ * @param world
+ *      The id of the world.
+ *
+ * @param generations
+ *      The number of generations to step.
+ *
+ * @param toroidal
+ *      Optional parameter. If true the world wraps at its edges. Defaults to false.
+ *
+ * @return
+ *      The size, generation and population of the world afterwards.
+ */
+Server::Info Server::Client::advance(const std::uint32_t world, const std::uint32_t generations, const bool toroidal) {
+	this->payload.resize(5);
+	put<std::uint32_t>(this->payload, 0, generations);
+	this->payload[4] = toroidal;
+	return read_info(request(ADVANCE, world));
+}
+
+/**
+ * Server::Client::query(world, x0, y0, x1, y1, region)
+ *
+ * Fetch the window [x0, x1) by [y0, y1) of a resident world.
+ *
+ * @param region
+ *      The grid to decode the window into, only reallocated if its size changes.
+ */
+void Server::Client::query(const std::uint32_t world, const int x0, const int y0, const int x1, const int y1,
+						   BitGrid &region) {
+	this->payload.resize(16);
+	put<std::int32_t>(this->payload, 0, x0);
+	put<std::int32_t>(this->payload, 4, y0);
+	put<std::int32_t>(this->payload, 8, x1);
+	put<std::int32_t>(this->payload, 12, y1);
+	const std::vector<unsigned char> &bytes = request(QUERY, world);
+	Zoo::decode_binary(bytes.data(), bytes.size(), region);
+}
+
+/**
+ * Server::Client::census(world)
+ *
+ * @return
+ *      The census of a resident world, as printed by operator<< for a Census::Result.
+ */
+std::string Server::Client::census(const std::uint32_t world) {
+	this->payload.clear();
+	const std::vector<unsigned char> &bytes = request(CENSUS, world);
+	return std::string(bytes.begin(), bytes.end());
+}
+
+/**
+ * Server::Client::info(world)
+ *
+ * @return
+ *      The size, generation and population of a resident world.
+ */
+Server::Info Server::Client::info(const std::uint32_t world) {
+	this->payload.clear();
+	return read_info(request(INFO, world));
+}
+
+/**
+ * Server::Client::drop(world)
+ *
+ * Free a resident world.
+ */
+void Server::Client::drop(const std::uint32_t world) {
+	this->payload.clear();
+	request(DROP, world);
+}
+
+/**
+ * Server::Client::shutdown()
+ *
+ * Stop the daemon once it has answered.
+ */
+void Server::Client::shutdown() {
+	this->payload.clear();
+	request(SHUTDOWN, 0);
+}
@@ -0,0 +1,103 @@
+/**
+ * Declares a Server namespace for a long running simulation daemon on a Unix domain socket, and a client for it.
+ * Rich documentation for the api, protocol and behaviour of the Server namespace can be found in server.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "grid.h"
+
+/**
+ * Declare the interface of the Server namespace for serving and requesting steps of resident worlds.
+ */
+namespace Server {
+
+	// Errors
+	const std::string socket_error = "Socket error: ";
+	const std::string connection_closed_error = "The connection was closed";
+	const std::string unknown_world_error = "No world is loaded with id: ";
+	const std::string unknown_opcode_error = "Unknown request: ";
+	const std::string message_too_large_error = "The message is larger than the limit: ";
+	const std::string message_too_short_error = "The message is too short for its request";
+
+	/**
+	 * The requests a client can make. Every request names a world by a 32 bit id.
+	 */
+	enum Opcode : unsigned char {
+		LOAD = 1,
+		LOAD_FILE = 2,
+		ADVANCE = 3,
+		QUERY = 4,
+		CENSUS = 5,
+		INFO = 6,
+		DROP = 7,
+		SHUTDOWN = 8,
+		SET_RULE = 9,
+		LOAD_RLE = 10
+	};
+
+	/**
+	 * How the daemon runs.
+	 *      - threads step each world, 0 uses every core. Worlds smaller than a band of rows step on one thread.
+	 *      - max_message caps the size of a single request, so a bad client cannot make the daemon allocate wildly.
+	 */
+	struct Options {
+		unsigned int threads = 1;
+		std::uint32_t max_message = 1u << 28;
+	};
+
+	/**
+	 * The size, generation and population of a resident world.
+	 */
+	struct Info {
+		int width = 0;
+		int height = 0;
+		std::uint64_t generation = 0;
+		std::uint32_t population = 0;
+	};
+
+	void serve(const std::string &path, const Options &options = Options());
+
+	/**
+	 * A connection to a daemon, sending one request at a time and waiting for its response.
+	 * Requests and responses go through buffers which are reused, so repeated requests do not allocate.
+	 *
+	 * @example
+	 *
+	 *      Server::Client client("/tmp/gol.sock");
+	 *      client.load(1, Grid(Zoo::glider()));
+	 *      Server::Info info = client.advance(1, 100, true);
+	 */
+	class Client {
+	private:
+		int socket;
+		std::vector<unsigned char> payload;
+		std::vector<unsigned char> response;
+
+		const std::vector<unsigned char> & request(Opcode opcode, std::uint32_t world);
+
+	public:
+		explicit Client(const std::string &path);
+		~Client();
+
+		Client(const Client &) = delete;
+		Client & operator=(const Client &) = delete;
+
+		void load(std::uint32_t world, const GridView &grid);
+		void load(std::uint32_t world, const BitGridView &grid);
+		void load_rle(std::uint32_t world, const std::string &text);
+		void load_file(std::uint32_t world, const std::string &path);
+		void set_rule(std::uint32_t world, const std::string &rule);
+		Info advance(std::uint32_t world, std::uint32_t generations, bool toroidal = false);
+		void query(std::uint32_t world, int x0, int y0, int x1, int y1, BitGrid &region);
+		std::string census(std::uint32_t world);
+		Info info(std::uint32_t world);
+		void drop(std::uint32_t world);
+		void shutdown();
+	};
+};
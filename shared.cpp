@@ -0,0 +1,373 @@
+/**
+ * Implements a Shared namespace for publishing grids into POSIX shared memory for viewers in other processes.
+ *      - A viewer, recorder or analysis tool can watch a running simulation by mapping its segment,
+ *        without a socket, a file or a copy of the grid, and without ever making the simulation wait.
+ *
+ *      - A segment is a Header followed by two buffers, slots, each big enough for the grid it was made for.
+ *          - Cells are bit-packed whatever the layout of the published grid, 64 cells per word,
+ *            each row starting on a new word, as a BitGrid stores them. A reader sees a slot as a BitGridView.
+ *          - Each slot has its own width, height, stride and generation, so a smaller grid can be published
+ *            into the same segment, but never a larger one.
+ *          - Fields are in native byte order, as the .bgol format is, since readers are on the same machine.
+ *
+ *      - Publishing is double buffered with a seqlock on each slot.
+ *          - The publisher writes into the slot which is not latest, making its sequence odd while it writes
+ *            and even again once done, then makes that slot latest.
+ *          - A reader reads latest and its even sequence, reads the cells in place, then checks the sequence
+ *            has not changed. If it has, the publisher came round to the slot again, and the reader retries.
+ *          - So the publisher never waits, and a reader only retries if it takes longer than a whole step
+ *            to read a grid, since the publisher writes the other slot in between.
+ *
+ *      - Segment names follow shm_open, a '/' followed by a name without further slashes, and on Linux appear
+ *        under /dev/shm. The publisher removes its segment when destroyed, readers which still have it mapped
+ *        keep the last grid they saw.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "shared.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Readers and the publisher in different processes must agree on the atomics without a lock between them
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Shared memory needs lock free 64 bit atomics");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "Shared memory needs lock free 32 bit atomics");
+
+// "GOLSHM" and a format version, so a reader never mistakes another segment for a grid
+static const std::uint64_t segment_magic = 0x474F4C53484D0001ULL;
+
+// The cells start on a cache line of their own, after the header
+static const std::size_t cells_offset = (sizeof(Shared::Header) + 63) / 64 * 64;
+
+/**
+ * Throw the last shared memory error.
+ * @param what - The call which failed.
+ * @param name - The name of the segment.
+ *
+ * @throws - std::runtime_error with the error's description.
+ */
+static void throw_shared_memory_error(const std::string &what, const std::string &name) {
+	throw std::runtime_error(Shared::shared_memory_error + what + " " + name + ": " + std::strerror(errno));
+}
+
+/**
+ * The words of a slot.
+ * @param header - The start of the segment.
+ * @param slot - The slot, 0 or 1.
+ * @return - The first word of the slot's cells.
+ */
+static BitCells::Word * slot_cells(Shared::Header *header, const int slot) {
+	auto *cells = reinterpret_cast<BitCells::Word *>(reinterpret_cast<unsigned char *>(header) + cells_offset);
+	return cells + slot * header->capacity;
+}
+
+static const BitCells::Word * slot_cells(const Shared::Header *header, const int slot) {
+	return slot_cells(const_cast<Shared::Header *>(header), slot);
+}
+
+/**
+ * Shared::Publisher::Publisher(name, width, height)
+ *
+ * Create a segment for grids of up to width by height cells, replacing any segment of the same name.
+ * Until the first grid is published readers see a 0 by 0 grid.
+ *
+ * @example
+ *
+ *      // Publish a 1024 x 1024 grid as /dev/shm/gol
+ *      Shared::Publisher publisher("/gol", 1024, 1024);
+ *
+ * @param name
+ *      The name of the segment, a '/' followed by a name without further slashes.
+ *
+ * @param width
+ *      The widest grid that will be published.
+ *
+ * @param height
+ *      The tallest grid that will be published.
+ *
+ * @throws
+ *      std::runtime_error if the segment cannot be created, sized or mapped.
+ */
+Shared::Publisher::Publisher(const std::string &name, const int width, const int height)
+		: name(name), header(nullptr), bytes(0), published(0) {
+	const std::uint64_t stride = (static_cast<std::uint64_t>(std::max(width, 0)) + 63) / 64;
+	const std::uint64_t capacity = stride * static_cast<std::uint64_t>(std::max(height, 0));
+	this->bytes = cells_offset + 2 * capacity * sizeof(BitCells::Word);
+
+	const int descriptor = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+	if (descriptor < 0) {
+		throw_shared_memory_error("shm_open", name);
+	}
+
+	// Truncating to nothing first zeroes a segment left behind by a publisher which did not exit cleanly
+	if (ftruncate(descriptor, 0) < 0 || ftruncate(descriptor, static_cast<off_t>(this->bytes)) < 0) {
+		close(descriptor);
+		shm_unlink(name.c_str());
+		throw_shared_memory_error("ftruncate", name);
+	}
+
+	void *memory = mmap(nullptr, this->bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (memory == MAP_FAILED) {
+		shm_unlink(name.c_str());
+		throw_shared_memory_error("mmap", name);
+	}
+
+	this->header = new (memory) Header();
+	this->header->capacity = capacity;
+
+	// The magic goes last, so a reader which maps the segment early rejects it rather than reading half a header
+	std::atomic_thread_fence(std::memory_order_release);
+	this->header->magic = segment_magic;
+}
+
+/**
+ * Shared::Publisher::~Publisher()
+ *
+ * Unmap and remove the segment. Readers which have it mapped keep it until they unmap it.
+ */
+Shared::Publisher::~Publisher() {
+	munmap(this->header, this->bytes);
+	shm_unlink(this->name.c_str());
+}
+
+/**
+ * Shared::Publisher::get_name()
+ *
+ * @return
+ *      The name of the segment.
+ */
+const std::string & Shared::Publisher::get_name() const {
+	return this->name;
+}
+
+/**
+ * Shared::Publisher::get_published()
+ *
+ * @return
+ *      The number of grids published, which is also the generation the next grid will be published as.
+ */
+std::uint64_t Shared::Publisher::get_published() const {
+	return this->published;
+}
+
+/**
+ * Shared::Publisher::publish(grid)
+ *
+ * Copy a grid into the slot readers are not reading, then make it the latest.
+ * Grids are numbered as generations from 0 in the order they are published.
+ * The copy is the one cost to the simulation, a word written per 64 cells, and it never waits for a reader.
+ *
+ * @example
+ *
+ *      Shared::Publisher publisher("/gol", 64, 64);
+ *      BitGrid current(64), next(64);
+ *      for (int i = 0; i < 100; i++) {
+ *          BitWorld::step(current, next);
+ *          std::swap(current, next);
+ *          publisher.publish(BitGridView(current));
+ *      }
+ *
+ * @param grid
+ *      The grid to publish, of either layout.
+ *
+ * @throws
+ *      std::runtime_error if the grid has more rows or words per row than the segment was made for.
+ */
+template <typename Storage>
+void Shared::Publisher::publish(const BasicGridView<Storage> &grid) {
+	const int width = grid.get_width();
+	const int height = grid.get_height();
+	const int stride = (width + 63) / 64;
+	if (static_cast<std::uint64_t>(stride) * height > this->header->capacity) {
+		throw std::runtime_error(grid_exceeds_capacity_error + this->name);
+	}
+
+	const int slot = 1 - static_cast<int>(this->header->latest.load(std::memory_order_relaxed));
+	Slot &target = this->header->slots[slot];
+	BitCells::Word *cells = slot_cells(this->header, slot);
+
+	// Odd while writing, and the fence keeps the writes below from being seen before it
+	const std::uint64_t sequence = target.sequence.load(std::memory_order_relaxed);
+	target.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	target.generation.store(this->published, std::memory_order_relaxed);
+	target.width.store(width, std::memory_order_relaxed);
+	target.height.store(height, std::memory_order_relaxed);
+	target.stride.store(stride, std::memory_order_relaxed);
+
+	const int offset = grid.get_offset();
+	for (int y = 0; y < height; y++) {
+		const typename Storage::Word *row = grid.row(y);
+		BitCells::Word *destination = cells + static_cast<std::size_t>(y) * stride;
+		for (int x = 0; x < width; x += 64) {
+			destination[x / 64] = Storage::load(row, offset + x, std::min(64, width - x));
+		}
+	}
+
+	target.sequence.store(sequence + 2, std::memory_order_release);
+	this->header->latest.store(static_cast<std::uint32_t>(slot), std::memory_order_release);
+	this->published++;
+}
+
+/**
+ * Shared::Reader::Reader(name)
+ *
+ * Map a segment made by a Publisher, read only.
+ *
+ * @example
+ *
+ *      Shared::Reader reader("/gol");
+ *
+ * @param name
+ *      The name of the segment.
+ *
+ * @throws
+ *      std::runtime_error if the segment cannot be opened or mapped, or was not made by a Publisher.
+ */
+Shared::Reader::Reader(const std::string &name) : header(nullptr), bytes(0) {
+	const int descriptor = shm_open(name.c_str(), O_RDONLY, 0);
+	if (descriptor < 0) {
+		throw_shared_memory_error("shm_open", name);
+	}
+
+	struct stat status;
+	if (fstat(descriptor, &status) < 0) {
+		close(descriptor);
+		throw_shared_memory_error("fstat", name);
+	}
+	this->bytes = static_cast<std::size_t>(status.st_size);
+	if (this->bytes < cells_offset) {
+		close(descriptor);
+		throw std::runtime_error(not_a_segment_error + name);
+	}
+
+	void *memory = mmap(nullptr, this->bytes, PROT_READ, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (memory == MAP_FAILED) {
+		throw_shared_memory_error("mmap", name);
+	}
+
+	this->header = static_cast<const Header *>(memory);
+	const bool valid = this->header->magic == segment_magic &&
+			cells_offset + 2 * this->header->capacity * sizeof(BitCells::Word) <= this->bytes;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (!valid) {
+		munmap(memory, this->bytes);
+		throw std::runtime_error(not_a_segment_error + name);
+	}
+}
+
+/**
+ * Shared::Reader::~Reader()
+ *
+ * Unmap the segment. Views from snapshots of it must not be used afterwards.
+ */
+Shared::Reader::~Reader() {
+	munmap(const_cast<Header *>(this->header), this->bytes);
+}
+
+/**
+ * Shared::Reader::begin()
+ *
+ * Start reading the latest grid in place. Waits only while the publisher is part way through rewriting
+ * the latest slot, which happens when it has lapped this reader.
+ * The view is only known to be consistent if Shared::Reader::valid(snapshot) is true once it has been read,
+ * until then whatever is read from it must be treated as possibly torn, and not trusted to index memory.
+ *
+ * @example
+ *
+ *      Shared::Snapshot snapshot;
+ *      std::uint64_t hash;
+ *      do {
+ *          snapshot = reader.begin();
+ *          hash = snapshot.view.hash();
+ *      } while (!reader.valid(snapshot));
+ *
+ * @return
+ *      A view of the latest grid in shared memory, its generation, and its slot and sequence for checking.
+ */
+Shared::Snapshot Shared::Reader::begin() const {
+	Snapshot snapshot;
+	for (;;) {
+		snapshot.slot = static_cast<int>(this->header->latest.load(std::memory_order_acquire));
+		const Slot &source = this->header->slots[snapshot.slot];
+		snapshot.sequence = source.sequence.load(std::memory_order_acquire);
+		if (snapshot.sequence % 2 == 1) {
+			continue;
+		}
+
+		snapshot.generation = source.generation.load(std::memory_order_relaxed);
+		const int width = source.width.load(std::memory_order_relaxed);
+		const int height = source.height.load(std::memory_order_relaxed);
+		const int stride = source.stride.load(std::memory_order_relaxed);
+
+		// A size torn by a concurrent write could point past the slot, so it is checked before it is handed out
+		if (width < 0 || height < 0 || stride != (width + 63) / 64 ||
+			static_cast<std::uint64_t>(stride) * height > this->header->capacity) {
+			continue;
+		}
+
+		snapshot.view = BitGridView(slot_cells(this->header, snapshot.slot), width, height, stride);
+		return snapshot;
+	}
+}
+
+/**
+ * Shared::Reader::valid(snapshot)
+ *
+ * Check that a snapshot was not overwritten while it was read.
+ *
+ * @param snapshot
+ *      A snapshot from Shared::Reader::begin() which has been read.
+ *
+ * @return
+ *      True if everything read from the snapshot is a consistent grid, false if it must be read again.
+ */
+bool Shared::Reader::valid(const Snapshot &snapshot) const {
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return this->header->slots[snapshot.slot].sequence.load(std::memory_order_relaxed) == snapshot.sequence;
+}
+
+/**
+ * Shared::Reader::copy(generation)
+ *
+ * Copy the latest grid out of shared memory, retrying until the copy is consistent.
+ * For readers which keep a grid after the publisher has moved on, or which are slower than a step.
+ *
+ * @example
+ *
+ *      std::uint64_t generation;
+ *      BitGrid grid = reader.copy(&generation);
+ *
+ * @param generation
+ *      Optional parameter. If not nullptr the generation of the grid is written to it.
+ *
+ * @return
+ *      A copy of the latest grid.
+ */
+BitGrid Shared::Reader::copy(std::uint64_t *generation) const {
+	for (;;) {
+		const Snapshot snapshot = begin();
+		BitGrid grid = snapshot.view.materialize();
+		if (valid(snapshot)) {
+			if (generation != nullptr) {
+				*generation = snapshot.generation;
+			}
+			return grid;
+		}
+	}
+}
+
+// Both layouts can be published
+template void Shared::Publisher::publish(const BasicGridView<ByteCells> &grid);
+template void Shared::Publisher::publish(const BasicGridView<BitCells> &grid);
@@ -0,0 +1,124 @@
+/**
+ * Declares a Shared namespace for publishing grids into POSIX shared memory for viewers in other processes.
+ * Rich documentation for the api, layout and behaviour of the Shared namespace can be found in shared.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "grid.h"
+
+/**
+ * Declare the interface of the Shared namespace for a seqlocked, double buffered grid in shared memory.
+ */
+namespace Shared {
+
+	// Errors
+	const std::string shared_memory_error = "Shared memory error: ";
+	const std::string not_a_segment_error = "The shared memory segment was not made by a Shared::Publisher: ";
+	const std::string grid_exceeds_capacity_error = "The grid is larger than the shared memory segment: ";
+
+	/**
+	 * One of the two buffers of a segment.
+	 * The sequence is odd while the publisher is writing the buffer and even once it is consistent.
+	 * The other fields are atomics so that reading them while they are being written is well defined,
+	 * the sequence says whether what was read can be trusted.
+	 */
+	struct Slot {
+		std::atomic<std::uint64_t> sequence;
+		std::atomic<std::uint64_t> generation;
+		std::atomic<std::int32_t> width;
+		std::atomic<std::int32_t> height;
+		std::atomic<std::int32_t> stride;
+		std::int32_t padding;
+	};
+
+	/**
+	 * The start of a segment, followed by the cells of slot 0 and then slot 1, capacity words each.
+	 * latest is the slot holding the most recently published grid.
+	 */
+	struct Header {
+		std::uint64_t magic;
+		std::uint64_t capacity;
+		std::atomic<std::uint32_t> latest;
+		std::uint32_t padding;
+		Slot slots[2];
+	};
+
+	/**
+	 * A view of a published grid in place in shared memory, with what is needed to check it afterwards.
+	 * The view may be overwritten while it is being read, so it must be checked with Reader::valid once read.
+	 */
+	struct Snapshot {
+		BitGridView view;
+		std::uint64_t generation = 0;
+		int slot = 0;
+		std::uint64_t sequence = 0;
+	};
+
+	/**
+	 * Creates a named segment and publishes grids into it. Publishing never waits for readers.
+	 * The segment is removed when the publisher is destroyed.
+	 *
+	 * @example
+	 *
+	 *      Shared::Publisher publisher("/gol", 1024, 1024);
+	 *      World world(Zoo::load_ascii("path/to/file.gol"));
+	 *      world.set_publisher(&publisher);
+	 *      world.advance(1000);
+	 */
+	class Publisher {
+	private:
+		std::string name;
+		Header *header;
+		std::size_t bytes;
+		std::uint64_t published;
+
+	public:
+		Publisher(const std::string &name, int width, int height);
+		~Publisher();
+
+		Publisher(const Publisher &) = delete;
+		Publisher & operator=(const Publisher &) = delete;
+
+		const std::string & get_name() const;
+		std::uint64_t get_published() const;
+
+		template <typename Storage>
+		void publish(const BasicGridView<Storage> &grid);
+	};
+
+	/**
+	 * Maps a segment made by a Publisher, read only, and takes consistent snapshots of it.
+	 *
+	 * @example
+	 *
+	 *      Shared::Reader reader("/gol");
+	 *      Shared::Snapshot snapshot;
+	 *      unsigned int alive;
+	 *      do {
+	 *          snapshot = reader.begin();
+	 *          alive = snapshot.view.get_alive_cells();
+	 *      } while (!reader.valid(snapshot));
+	 */
+	class Reader {
+	private:
+		const Header *header;
+		std::size_t bytes;
+
+	public:
+		explicit Reader(const std::string &name);
+		~Reader();
+
+		Reader(const Reader &) = delete;
+		Reader & operator=(const Reader &) = delete;
+
+		Snapshot begin() const;
+		bool valid(const Snapshot &snapshot) const;
+		BitGrid copy(std::uint64_t *generation = nullptr) const;
+	};
+};
@@ -0,0 +1,479 @@
+/**
+ * Implements a Soup namespace for searching random soups in process, across every core.
+ *      - A soup is a square of random cells in the centre of an otherwise dead world.
+ *          - Cells come from a counter-based generator, so any soup can be rebuilt from its seed and number alone,
+ *            on any thread and in any order.
+ *          - Each random word fills 64 cells at once through the grid's store kernel.
+ *          - Densities are rounded to a multiple of 1/256 and built from up to 8 words, a density of 0.5 takes one.
+ *
+ *      - A soup is stepped with the bit-packed kernel until it settles.
+ *          - The hash of every generation is kept for the last max_period generations.
+ *          - When a hash repeats the soup has entered a cycle, its period is how far back the repeat was.
+ *          - The settled world is then censused into still lifes, oscillators, spaceships and unknown objects.
+ *
+ *      - A search runs a range of soups on a pool of worker threads.
+ *          - Workers take the next soup number from a shared atomic counter, so no soup waits on a slow neighbour.
+ *          - Each worker totals its own Summary, and the summaries are merged after the workers finish.
+ *          - Results are handed to the writer through a ring of slots, each marked ready with an atomic,
+ *            so they are streamed to the output in soup order without a lock.
+ *          - A worker more than a ring ahead of the writer waits for it, so memory stays bounded however many
+ *            soups are searched.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "soup.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "world.h"
+
+// The soups each worker may run ahead of the writer
+static const int slots_per_thread = 64;
+
+/**
+ * Mix the bits of a word so that nearby inputs give unrelated outputs, the SplitMix64 finaliser.
+ * @param value - The word to mix.
+ * @return The mixed word.
+ */
+static std::uint64_t mix(std::uint64_t value) {
+	value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+	return value ^ (value >> 31);
+}
+
+/**
+ * Check that the options describe a soup which can be run.
+ * @param options - The options to check.
+ *
+ * @throws - std::runtime_error if a size, density or limit is out of range.
+ */
+static void check_options(const Soup::Options &options) {
+	if (options.soup_size <= 0 || options.soup_size > options.world_size) {
+		throw std::runtime_error(Soup::soup_size_not_valid_error + std::to_string(options.soup_size) + " in " +
+								 std::to_string(options.world_size));
+	}
+	if (!(options.density >= 0 && options.density <= 1)) {
+		throw std::runtime_error(Soup::density_not_valid_error + std::to_string(options.density));
+	}
+	if (options.max_generations <= 0 || options.max_period <= 0) {
+		throw std::runtime_error(Soup::generations_not_valid_error + std::to_string(options.max_generations) + " " +
+								 std::to_string(options.max_period));
+	}
+}
+
+/**
+ * Soup::random(key, counter)
+ *
+ * Get a random word from a counter-based generator.
+ * There is no state to carry between calls, the same key and counter always give the same word.
+ *
+ * @example
+ *
+ *      // Two random words for soup 7 of seed 1
+ *      const std::uint64_t key = Soup::random(1, 7);
+ *      std::uint64_t a = Soup::random(key, 0);
+ *      std::uint64_t b = Soup::random(key, 1);
+ *
+ * @param key
+ *      The stream to draw from.
+ *
+ * @param counter
+ *      The position in the stream.
+ *
+ * @return
+ *      64 random bits.
+ */
+std::uint64_t Soup::random(const std::uint64_t key, const std::uint64_t counter) {
+	return mix(mix(key) + counter * 0x9e3779b97f4a7c15ULL);
+}
+
+/**
+ * Soup::fill(grid, x0, y0, width, height, seed, soup, density)
+ *
+ * Overwrite a region of a grid with the random cells of a soup, 64 cells at a time.
+ * Each cell is alive with a chance of density rounded to the nearest 1/256.
+ *
+ * @example
+ *
+ *      // Soup 42 in the top left of a bit-packed grid
+ *      BitGrid grid(128, 128);
+ *      Soup::fill(grid, 0, 0, 16, 16, 1, 42);
+ *
+ * @param grid
+ *      The grid to fill.
+ *
+ * @param x0
+ *      The left of the region.
+ *
+ * @param y0
+ *      The top of the region.
+ *
+ * @param width
+ *      The width of the region.
+ *
+ * @param height
+ *      The height of the region.
+ *
+ * @param seed
+ *      The seed of the search.
+ *
+ * @param soup
+ *      The number of the soup within the search.
+ *
+ * @param density
+ *      Optional parameter. The chance of each cell being alive. Defaults to 0.5.
+ *
+ * @throws
+ *      Throws std::out_of_range if the region does not fit inside the grid.
+ */
+template <typename Storage>
+void Soup::fill(BasicGrid<Storage> &grid, const int x0, const int y0, const int width, const int height,
+				const std::uint64_t seed, const std::uint64_t soup, const double density) {
+	if (x0 < 0 || y0 < 0 || width < 0 || height < 0 ||
+		x0 + width > grid.get_width() || y0 + height > grid.get_height()) {
+		throw std::out_of_range(region_out_of_bounds_error);
+	}
+
+	const std::uint64_t key = random(seed, soup);
+	const int threshold = static_cast<int>(std::lround(std::min(std::max(density, 0.0), 1.0) * 256));
+
+	// Build each word from the bits of the threshold, lowest first: a 1 bit ORs in a random word and a 0 bit
+	// ANDs one, which halves the chance towards 1 or 0, so after the top bit each cell is alive threshold/256
+	// of the time. The 0 bits below the lowest 1 would only AND into an empty word, so they are skipped.
+	int lowest = 0;
+	while (lowest < 8 && !(threshold & (1 << lowest))) {
+		lowest++;
+	}
+
+	std::uint64_t counter = 0;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x += 64) {
+			const int count = std::min(64, width - x);
+			std::uint64_t alive = threshold >= 256 ? ~std::uint64_t(0) : 0;
+			for (int bit = lowest; bit < 8 && threshold < 256; bit++) {
+				const std::uint64_t word = random(key, counter++);
+				alive = (threshold & (1 << bit)) ? (alive | word) : (alive & word);
+			}
+			Storage::store(grid.row(y0 + y), x0 + x, count, alive);
+		}
+	}
+}
+
+/**
+ * Soup::run(options, soup)
+ *
+ * Seed one soup, step it until it settles or runs out of generations, and census what is left.
+ *
+ * @example
+ *
+ *      Soup::Options options;
+ *      Soup::Result result = Soup::run(options, 42);
+ *      std::cout << result.generations << " " << result.census << std::endl;
+ *
+ * @param options
+ *      How to seed and run the soup.
+ *
+ * @param soup
+ *      The number of the soup within the search.
+ *
+ * @return
+ *      What happened to the soup.
+ *
+ * @throws
+ *      Throws std::runtime_error if the options are out of range.
+ */
+Soup::Result Soup::run(const Options &options, const std::uint64_t soup) {
+	check_options(options);
+
+	const int size = options.world_size;
+	const int corner = (size - options.soup_size) / 2;
+	BitGrid current(size, size);
+	BitGrid next(size, size);
+	fill(current, corner, corner, options.soup_size, options.soup_size, options.seed, soup, options.density);
+
+	// The hashes of the last max_period generations, generation g is kept at g % (max_period + 1)
+	const int window = options.max_period + 1;
+	std::vector<std::uint64_t> recent(window);
+	recent[0] = current.hash();
+
+	Result result;
+	result.soup = soup;
+	result.generations = options.max_generations;
+
+	for (int generation = 1; generation <= options.max_generations && result.period == 0; generation++) {
+		BitWorld::step(current, next, options.toroidal);
+		std::swap(current, next);
+
+		const std::uint64_t hash = current.hash();
+		for (int period = 1; period <= std::min(generation, options.max_period); period++) {
+			if (recent[(generation - period) % window] == hash) {
+				result.generations = generation - period;
+				result.period = period;
+				break;
+			}
+		}
+		recent[generation % window] = hash;
+	}
+
+	result.population = current.get_alive_cells();
+	result.census = Census::take(Grid(current), 0, 1);
+	return result;
+}
+
+/**
+ * Soup::search(options, first, count, output)
+ *
+ * Run a range of soups on a pool of worker threads, streaming each result to an output in soup order.
+ *
+ * @example
+ *
+ *      // Search a million soups on every core and save every result
+ *      std::ofstream file("soups.csv");
+ *      Soup::Options options;
+ *      options.seed = 7;
+ *      Soup::Summary summary = Soup::search(options, 0, 1000000, &file);
+ *      std::cout << summary;
+ *
+ * @param options
+ *      How to seed and run each soup, and how many threads to run them on.
+ *
+ * @param first
+ *      The number of the first soup.
+ *
+ * @param count
+ *      The number of soups to run.
+ *
+ * @param output
+ *      Optional parameter. A stream to write each result to with Soup::write, after a header.
+ *      Defaults to nullptr, only totalling the results.
+ *
+ * @return
+ *      The totals of every soup.
+ *
+ * @throws
+ *      Throws std::runtime_error if the options are out of range.
+ */
+Soup::Summary Soup::search(const Options &options, const std::uint64_t first, const std::uint64_t count,
+						   std::ostream *output) {
+	check_options(options);
+
+	unsigned int threads = options.threads;
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	threads = static_cast<unsigned int>(std::max<std::uint64_t>(1, std::min<std::uint64_t>(threads, count)));
+
+	// A slot holds a result once ready is the soup's index in the search plus 1
+	struct Slot {
+		std::atomic<std::uint64_t> ready;
+		Result result;
+	};
+	const std::uint64_t slot_count = static_cast<std::uint64_t>(threads) * slots_per_thread;
+	std::unique_ptr<Slot[]> slots(new Slot[slot_count]);
+	for (std::uint64_t i = 0; i < slot_count; i++) {
+		slots[i].ready = 0;
+	}
+
+	std::atomic<std::uint64_t> next_soup(0);
+	std::atomic<std::uint64_t> written(0);
+	std::vector<Summary> summaries(threads);
+
+	auto work = [&](const unsigned int worker) {
+		Summary &summary = summaries[worker];
+		for (std::uint64_t i = next_soup.fetch_add(1); i < count; i = next_soup.fetch_add(1)) {
+			Result result = run(options, first + i);
+			summary.add(result);
+
+			if (output) {
+				while (i >= written.load(std::memory_order_acquire) + slot_count) {
+					std::this_thread::yield();
+				}
+				Slot &slot = slots[i % slot_count];
+				slot.result = std::move(result);
+				slot.ready.store(i + 1, std::memory_order_release);
+			}
+		}
+	};
+
+	// The calling thread writes if there is an output, so the workers never wait on the stream
+	std::vector<std::thread> workers;
+	for (unsigned int t = output ? 0 : 1; t < threads; t++) {
+		workers.emplace_back(work, t);
+	}
+
+	if (output) {
+		write_header(*output);
+		for (std::uint64_t i = 0; i < count; i++) {
+			Slot &slot = slots[i % slot_count];
+			while (slot.ready.load(std::memory_order_acquire) != i + 1) {
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+			write(*output, slot.result);
+			written.store(i + 1, std::memory_order_release);
+		}
+	} else {
+		work(0);
+	}
+
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+
+	Summary total;
+	for (const Summary &summary : summaries) {
+		total.merge(summary);
+	}
+	return total;
+}
+
+/**
+ * Soup::Summary::add(result)
+ *
+ * Add one soup to the totals.
+ *
+ * @param result
+ *      The soup to add.
+ */
+void Soup::Summary::add(const Result &result) {
+	this->soups++;
+	this->stabilised += result.period > 0;
+	this->generations += result.generations;
+	this->population += result.population;
+	this->objects += result.census.objects;
+	this->still_lifes += result.census.still_lifes;
+	this->oscillators += result.census.oscillators;
+	this->spaceships += result.census.spaceships;
+	this->methuselahs += result.census.methuselahs;
+	this->unknown += result.census.unknown;
+	for (const auto &count : result.census.counts) {
+		this->counts[count.first] += count.second;
+	}
+	if (result.generations > this->longest_generations) {
+		this->longest_generations = result.generations;
+		this->longest_soup = result.soup;
+	}
+}
+
+/**
+ * Soup::Summary::merge(other)
+ *
+ * Add the totals of another summary to this one.
+ *
+ * @param other
+ *      The summary to add.
+ */
+void Soup::Summary::merge(const Summary &other) {
+	this->soups += other.soups;
+	this->stabilised += other.stabilised;
+	this->generations += other.generations;
+	this->population += other.population;
+	this->objects += other.objects;
+	this->still_lifes += other.still_lifes;
+	this->oscillators += other.oscillators;
+	this->spaceships += other.spaceships;
+	this->methuselahs += other.methuselahs;
+	this->unknown += other.unknown;
+	for (const auto &count : other.counts) {
+		this->counts[count.first] += count.second;
+	}
+	if (other.longest_generations > this->longest_generations ||
+		(other.longest_generations == this->longest_generations && other.longest_soup < this->longest_soup)) {
+		this->longest_generations = other.longest_generations;
+		this->longest_soup = other.longest_soup;
+	}
+}
+
+/**
+ * Soup::write_header(output_stream)
+ *
+ * Write the CSV header line matching Soup::write.
+ *
+ * @param output_stream
+ *      The stream to write to.
+ */
+void Soup::write_header(std::ostream &output_stream) {
+	output_stream << "soup,generations,period,population,objects,still_lifes,oscillators,spaceships,methuselahs,"
+					 "unknown,census" << std::endl;
+}
+
+/**
+ * Soup::write(output_stream, result)
+ *
+ * Write one soup as a CSV line. The census is a quoted list of name=count pairs separated by semicolons.
+ *
+ * @example
+ *
+ *      42,311,2,67,9,6,3,0,0,0,"blinker=3;block=4;boat=1;beehive=1"
+ *
+ * @param output_stream
+ *      The stream to write to.
+ *
+ * @param result
+ *      The soup to write.
+ */
+void Soup::write(std::ostream &output_stream, const Result &result) {
+	output_stream << result.soup << ','
+				  << result.generations << ','
+				  << result.period << ','
+				  << result.population << ','
+				  << result.census.objects << ','
+				  << result.census.still_lifes << ','
+				  << result.census.oscillators << ','
+				  << result.census.spaceships << ','
+				  << result.census.methuselahs << ','
+				  << result.census.unknown << ",\"";
+	bool separate = false;
+	for (const auto &count : result.census.counts) {
+		output_stream << (separate ? ";" : "") << count.first << '=' << count.second;
+		separate = true;
+	}
+	output_stream << '"' << '\n';
+}
+
+/**
+ * operator<<(output_stream, summary)
+ *
+ * Print the totals of a search as a summary line, the longest lived soup, and one line per named object.
+ *
+ * @param output_stream - An ascii mode output stream such as std::cout.
+ * @param summary - The totals to print.
+ * @return Returns a reference to the output stream to enable operator chaining.
+ */
+std::ostream &operator<<(std::ostream &output_stream, const Soup::Summary &summary) {
+	output_stream << "Soups " << summary.soups <<
+		" | Stabilised " << summary.stabilised <<
+		" | Mean generations " << (summary.soups ? static_cast<double>(summary.generations) / summary.soups : 0) <<
+		" | Mean population " << (summary.soups ? static_cast<double>(summary.population) / summary.soups : 0) << std::endl;
+
+	output_stream << "Objects " << summary.objects <<
+		" | Still lifes " << summary.still_lifes <<
+		" | Oscillators " << summary.oscillators <<
+		" | Spaceships " << summary.spaceships <<
+		" | Methuselahs " << summary.methuselahs <<
+		" | Unknown " << summary.unknown << std::endl;
+
+	if (summary.longest_generations >= 0) {
+		output_stream << "Longest lived soup " << summary.longest_soup << " settled after "
+					  << summary.longest_generations << " generations" << std::endl;
+	}
+
+	for (const auto &count : summary.counts) {
+		output_stream << "  " << count.first << ": " << count.second << std::endl;
+	}
+
+	return output_stream;
+}
+
+// Compile both layouts once
+template void Soup::fill<ByteCells>(Grid &grid, int x0, int y0, int width, int height, std::uint64_t seed,
+									std::uint64_t soup, double density);
+template void Soup::fill<BitCells>(BitGrid &grid, int x0, int y0, int width, int height, std::uint64_t seed,
+								   std::uint64_t soup, double density);
@@ -0,0 +1,96 @@
+/**
+ * Declares a Soup namespace for searching random soups in process, across every core.
+ * Rich documentation for the api and behaviour the Soup namespace can be found in soup.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include "census.h"
+#include "grid.h"
+
+/**
+ * Declare the interface of the Soup namespace for seeding, running and censusing random soups.
+ */
+namespace Soup {
+
+	// Errors
+	const std::string soup_size_not_valid_error = "The soup must be a positive size no larger than the world: ";
+	const std::string density_not_valid_error = "The soup density must be between 0 and 1: ";
+	const std::string generations_not_valid_error = "The generation and period limits must be positive: ";
+	const std::string region_out_of_bounds_error = "The soup region does not fit inside the grid";
+
+	/**
+	 * How each soup is seeded and run.
+	 *      - A soup_size square of random cells is placed in the centre of a world_size square world.
+	 *      - The soup is stepped until a state repeats within max_period generations, or max_generations pass.
+	 *      - Bounded worlds turn escaping gliders into debris at the edge, toroidal ones keep them flying.
+	 *      - threads is the number of soups run at once, 0 uses every core.
+	 */
+	struct Options {
+		std::uint64_t seed = 1;
+		int soup_size = 16;
+		int world_size = 128;
+		double density = 0.5;
+		int max_generations = 10000;
+		int max_period = 30;
+		bool toroidal = false;
+		unsigned int threads = 0;
+	};
+
+	/**
+	 * What happened to one soup.
+	 * generations is when the soup first entered its final cycle, and period is the length of that cycle.
+	 * A soup which did not settle within the limit has a period of 0 and is censused where it stopped.
+	 */
+	struct Result {
+		std::uint64_t soup = 0;
+		int generations = 0;
+		int period = 0;
+		unsigned int population = 0;
+		Census::Result census;
+	};
+
+	/**
+	 * The totals of many soups.
+	 * Each worker keeps its own Summary, so they are merged once at the end rather than shared.
+	 */
+	struct Summary {
+		std::uint64_t soups = 0;
+		std::uint64_t stabilised = 0;
+		std::uint64_t generations = 0;
+		std::uint64_t population = 0;
+		std::uint64_t objects = 0;
+		std::uint64_t still_lifes = 0;
+		std::uint64_t oscillators = 0;
+		std::uint64_t spaceships = 0;
+		std::uint64_t methuselahs = 0;
+		std::uint64_t unknown = 0;
+		std::uint64_t longest_soup = 0;
+		int longest_generations = -1;
+		std::map<std::string, std::uint64_t> counts;
+
+		void add(const Result &result);
+		void merge(const Summary &other);
+	};
+
+	std::uint64_t random(std::uint64_t key, std::uint64_t counter);
+
+	template <typename Storage>
+	void fill(BasicGrid<Storage> &grid, int x0, int y0, int width, int height, std::uint64_t seed,
+			  std::uint64_t soup, double density = 0.5);
+
+	Result run(const Options &options, std::uint64_t soup);
+	Summary search(const Options &options, std::uint64_t first, std::uint64_t count, std::ostream *output = nullptr);
+
+	void write_header(std::ostream &output_stream);
+	void write(std::ostream &output_stream, const Result &result);
+};
+
+std::ostream &operator<<(std::ostream &output_stream, const Soup::Summary &summary);
+
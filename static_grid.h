@@ -0,0 +1,242 @@
+/**
+ * Declares and defines a class representing a small 2d grid of cells whose size is fixed at compile time.
+ *      - The cells live inline in the object, so making, copying and dropping a StaticGrid never touches the heap.
+ *      - Every member which does not build a Grid is constexpr, so small patterns can be built, rotated
+ *        and hashed while compiling.
+ *      - A StaticGrid can be passed anywhere a const GridView& is taken without copying its cells,
+ *        and converts to a Grid with a single copy.
+ *
+ * Being templates, the members are defined here rather than in a .cpp file.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include "grid.h"
+
+/**
+ * Declare and define the StaticGrid class for a Width x Height grid of cells stored inline.
+ * Cells are one byte each in row major order, the same layout as a Grid, so a GridView can point straight at them.
+ */
+template <int Width, int Height>
+class StaticGrid {
+	static_assert(Width > 0 && Height > 0, "A StaticGrid must have a positive width and height");
+
+private:
+	std::array<Cell, Width * Height> cells;
+
+	static constexpr void check_if_in_bounds(const int x, const int y) {
+		if (x < 0 || y < 0 || x >= Width || y >= Height) {
+			throw std::out_of_range("The coordinate is not a valid coordinate within the static grid");
+		}
+	}
+
+public:
+	static constexpr int width = Width;
+	static constexpr int height = Height;
+
+	/**
+	 * Construct a grid of dead cells.
+	 */
+	constexpr StaticGrid() : cells() {
+		for (Cell &cell : this->cells) {
+			cell = Cell::DEAD;
+		}
+	}
+
+	/**
+	 * Parse a plaintext pattern, rows are separated by '/' with '#' alive and '.' or ' ' dead.
+	 * Rows shorter than the grid, or fewer rows than the grid, leave the rest of the cells dead.
+	 *
+	 * @example
+	 *
+	 *      constexpr StaticGrid<3, 3> glider = StaticGrid<3, 3>::parse(".#./..#/###");
+	 *
+	 * @throws
+	 *      Throws std::out_of_range if the pattern does not fit in the grid,
+	 *      or std::runtime_error if a character is not a cell or a row separator.
+	 *      In a constant expression either is a compile error.
+	 */
+	static constexpr StaticGrid parse(const char *plaintext) {
+		StaticGrid grid;
+		int x = 0;
+		int y = 0;
+		for (const char *c = plaintext; *c != '\0'; c++) {
+			if (*c == '/') {
+				x = 0;
+				y++;
+			} else if (*c == '#' || *c == '.' || *c == ' ') {
+				check_if_in_bounds(x, y);
+				grid.cells[y * Width + x] = (*c == '#') ? Cell::ALIVE : Cell::DEAD;
+				x++;
+			} else {
+				throw std::runtime_error("The character for a cell is not '#', '.' or ' '");
+			}
+		}
+		return grid;
+	}
+
+	constexpr int get_width() const {
+		return Width;
+	}
+
+	constexpr int get_height() const {
+		return Height;
+	}
+
+	constexpr unsigned int get_total_cells() const {
+		return Width * Height;
+	}
+
+	constexpr unsigned int get_alive_cells() const {
+		unsigned int alive = 0;
+		for (const Cell cell : this->cells) {
+			alive += (cell == Cell::ALIVE);
+		}
+		return alive;
+	}
+
+	constexpr unsigned int get_dead_cells() const {
+		return get_total_cells() - get_alive_cells();
+	}
+
+	/**
+	 * Get or set the cell at x, y.
+	 *
+	 * @throws
+	 *      Throws std::out_of_range if x, y is not a valid coordinate within the grid.
+	 */
+	constexpr Cell get(const int x, const int y) const {
+		check_if_in_bounds(x, y);
+		return this->cells[y * Width + x];
+	}
+
+	constexpr void set(const int x, const int y, const Cell value) {
+		check_if_in_bounds(x, y);
+		this->cells[y * Width + x] = value;
+	}
+
+	/**
+	 * Get a reference to the cell at x, y without a bounds check.
+	 */
+	constexpr Cell & operator()(const int x, const int y) {
+		return this->cells[y * Width + x];
+	}
+
+	constexpr const Cell & operator()(const int x, const int y) const {
+		return this->cells[y * Width + x];
+	}
+
+	constexpr bool operator==(const StaticGrid &other) const {
+		for (int i = 0; i < Width * Height; i++) {
+			if (this->cells[i] != other.cells[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	constexpr bool operator!=(const StaticGrid &other) const {
+		return !(*this == other);
+	}
+
+	/**
+	 * Rotate the grid by a multiple of 90 degrees clockwise, matching Grid::rotate(Rotation).
+	 * The rotation is a template argument as odd rotations swap the width and height of the result type.
+	 *
+	 * @example
+	 *
+	 *      constexpr StaticGrid<4, 5> upright = Zoo::light_weight_spaceship().rotate<1>();
+	 */
+	template <int Rotation>
+	constexpr StaticGrid<(Rotation % 2 == 0) ? Width : Height, (Rotation % 2 == 0) ? Height : Width> rotate() const {
+		constexpr int turns = ((Rotation % 4) + 4) % 4;
+		StaticGrid<(Rotation % 2 == 0) ? Width : Height, (Rotation % 2 == 0) ? Height : Width> rotated;
+		for (int y = 0; y < rotated.get_height(); y++) {
+			for (int x = 0; x < rotated.get_width(); x++) {
+				switch (turns) {
+					case 0: rotated(x, y) = (*this)(x, y); break;
+					case 1: rotated(x, y) = (*this)(y, Height - 1 - x); break;
+					case 2: rotated(x, y) = (*this)(Width - 1 - x, Height - 1 - y); break;
+					default: rotated(x, y) = (*this)(Width - 1 - y, x); break;
+				}
+			}
+		}
+		return rotated;
+	}
+
+	/**
+	 * Rotate the grid by a rotation only known at run time, giving a Grid as the result size depends on it.
+	 */
+	Grid rotate(const int rotation) const {
+		return view().materialize().rotate(rotation);
+	}
+
+	/**
+	 * Mirror the grid left to right, matching Grid::flip().
+	 */
+	constexpr StaticGrid flip() const {
+		StaticGrid flipped;
+		for (int y = 0; y < Height; y++) {
+			for (int x = 0; x < Width; x++) {
+				flipped(x, y) = (*this)(Width - 1 - x, y);
+			}
+		}
+		return flipped;
+	}
+
+	/**
+	 * Hash the size and cells of the grid with CellHash, matching GridView::hash and the Catalogue.
+	 * The hash is the same whether it is taken at compile time or at run time.
+	 */
+	constexpr std::uint64_t hash() const {
+		CellHash hash(Width, Height);
+		for (int y = 0; y < Height; y++) {
+			hash.mix_row(Width, [this, y](const int x) {
+				return (*this)(x, y) == Cell::ALIVE;
+			});
+		}
+		return hash.finish();
+	}
+
+	/**
+	 * View the cells in place, the view is only valid while the grid is alive.
+	 * The conversion lets a StaticGrid be passed straight to Grid::merge, Catalogue::lookup and the like.
+	 *
+	 * @example
+	 *
+	 *      // Stamp a glider without building a Grid for it
+	 *      grid.merge(Zoo::glider(), 10, 20);
+	 */
+	GridView view() const {
+		return GridView(this->cells.data(), Width, Height, Width);
+	}
+
+	operator GridView() const {
+		return view();
+	}
+
+	/**
+	 * Copy the cells into a Grid, which is one allocation and one copy of Width x Height bytes.
+	 *
+	 * @example
+	 *
+	 *      Grid glider = Zoo::glider();
+	 */
+	operator Grid() const {
+		return view().materialize();
+	}
+};
+
+/**
+ * Print a StaticGrid the same way as a Grid.
+ */
+template <int Width, int Height>
+std::ostream & operator<<(std::ostream & output_stream, const StaticGrid<Width, Height> &grid) {
+	return output_stream << grid.view();
+}
@@ -0,0 +1,138 @@
+/**
+ * Declares and defines a class representing a small 2d world whose size is fixed at compile time.
+ *      - A StaticWorld holds two StaticGrid buffers inline, so stepping it never touches the heap.
+ *          - The buffers swap roles after each step by flipping an index, rather than copying cells.
+ *      - Stepping is constexpr, so a pattern can be run forward while compiling.
+ *      - The width and height are template arguments, so every loop bound is a constant the compiler can unroll.
+ *
+ * Being templates, the members are defined here rather than in a .cpp file.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <array>
+#include "static_grid.h"
+
+/**
+ * Declare and define the StaticWorld class for a Width x Height world.
+ * The rules match World, toroidal worlds wrap on both edges.
+ */
+template <int Width, int Height>
+class StaticWorld {
+
+private:
+	StaticGrid<Width, Height> states[2];
+	int current;
+
+public:
+	/**
+	 * Construct a world of dead cells.
+	 */
+	constexpr StaticWorld() : states(), current(0) {}
+
+	/**
+	 * Construct a world starting from a grid.
+	 *
+	 * @example
+	 *
+	 *      constexpr StaticWorld<3, 3> world(Zoo::glider());
+	 */
+	explicit constexpr StaticWorld(const StaticGrid<Width, Height> &initial_state)
+		: states{initial_state, StaticGrid<Width, Height>()}, current(0) {}
+
+	constexpr int get_width() const {
+		return Width;
+	}
+
+	constexpr int get_height() const {
+		return Height;
+	}
+
+	constexpr unsigned int get_total_cells() const {
+		return states[current].get_total_cells();
+	}
+
+	constexpr unsigned int get_alive_cells() const {
+		return states[current].get_alive_cells();
+	}
+
+	constexpr unsigned int get_dead_cells() const {
+		return states[current].get_dead_cells();
+	}
+
+	constexpr const StaticGrid<Width, Height> & get_state() const {
+		return states[current];
+	}
+
+	/**
+	 * Step the world forward one generation, swapping the roles of the state buffers afterwards.
+	 *
+	 * @example
+	 *
+	 *      // A blinker is back where it started after two steps, checked while compiling
+	 *      constexpr auto blinker = StaticGrid<3, 3>::parse("/###");
+	 *      constexpr auto twice = [] { StaticWorld<3, 3> world(blinker); world.advance(2); return world.get_state(); }();
+	 *      static_assert(twice == blinker, "A blinker has period 2");
+	 *
+	 * @param toroidal
+	 *      Optional parameter. If true then the step will consider the grid as a torus, where the left edge
+	 *      wraps to the right edge and the top to the bottom. Defaults to false.
+	 */
+	constexpr void step(const bool toroidal = false) {
+		step(states[current], states[1 - current], toroidal);
+		current = 1 - current;
+	}
+
+	/**
+	 * Advance the world forward steps generations.
+	 */
+	constexpr void advance(const int steps, const bool toroidal = false) {
+		for (int i = 0; i < steps; i++) {
+			step(toroidal);
+		}
+	}
+
+	/**
+	 * Write the generation after source into destination.
+	 * The source is first copied as 0s and 1s into a buffer with a one cell border, dead for a bounded world
+	 * or wrapped from the opposite edge for a toroidal one, so counting neighbours needs no edge checks.
+	 */
+	static constexpr void step(const StaticGrid<Width, Height> &source, StaticGrid<Width, Height> &destination,
+							   const bool toroidal = false) {
+		constexpr int padded_width = Width + 2;
+		std::array<unsigned char, (Width + 2) * (Height + 2)> padded = {};
+		for (int y = -1; y <= Height; y++) {
+			for (int x = -1; x <= Width; x++) {
+				const bool inside = x >= 0 && y >= 0 && x < Width && y < Height;
+				if (inside || toroidal) {
+					const Cell cell = source((x + Width) % Width, (y + Height) % Height);
+					padded[(y + 1) * padded_width + x + 1] = (cell == Cell::ALIVE);
+				}
+			}
+		}
+
+		for (int y = 0; y < Height; y++) {
+			const unsigned char *above = padded.data() + y * padded_width;
+			const unsigned char *middle = above + padded_width;
+			const unsigned char *below = middle + padded_width;
+			for (int x = 0; x < Width; x++) {
+				const unsigned int neighbours = above[x] + above[x + 1] + above[x + 2] +
+												middle[x] + middle[x + 2] +
+												below[x] + below[x + 1] + below[x + 2];
+				const bool alive = middle[x + 1];
+				destination(x, y) = (neighbours == 3 || (neighbours == 2 && alive)) ? Cell::ALIVE : Cell::DEAD;
+			}
+		}
+	}
+
+	/**
+	 * Give the generation after grid, so a pattern can be stepped inside a constant expression.
+	 */
+	static constexpr StaticGrid<Width, Height> next(const StaticGrid<Width, Height> &grid, const bool toroidal = false) {
+		StaticGrid<Width, Height> destination;
+		step(grid, destination, toroidal);
+		return destination;
+	}
+};
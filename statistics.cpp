@@ -0,0 +1,228 @@
+/**
+ * Implements a Statistics namespace for recording what happens in each generation of a World.
+ *      - A World or a step kernel fills in a Generation with the population, births and deaths of a step.
+ *          - Counting is only done when a sink is given, so a World without one pays a single null check per step.
+ *
+ *      - A History keeps the most recent generations in a fixed size ring buffer.
+ *          - Recording never allocates, so a long run keeps a bounded window of its latest steps.
+ *          - Generations are numbered as they are recorded, so the window says where in the run it is.
+ *
+ *      - A History can be exported as CSV or JSON for plotting or comparing runs.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "statistics.h"
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+/**
+ * Statistics::History::History(capacity)
+ *
+ * Construct an empty history which keeps the last capacity generations.
+ *
+ * @example
+ *
+ *      // Keep the last 256 generations of a world
+ *      Statistics::History history(256);
+ *      world.set_statistics(&history);
+ *
+ * @param capacity
+ *      Optional parameter. The number of generations to keep. Defaults to 1024.
+ *
+ * @throws
+ *      Throws std::runtime_error if the capacity is not positive.
+ */
+Statistics::History::History(const int capacity) : capacity(capacity > 0 ? capacity : 0), next(0), recorded(0) {
+	if (capacity <= 0) {
+		throw std::runtime_error(capacity_not_positive_error + std::to_string(capacity));
+	}
+	this->generations.reserve(this->capacity);
+}
+
+/**
+ * Statistics::History::record(generation)
+ *
+ * Add a generation to the history, numbering it and overwriting the oldest if the history is full.
+ *
+ * @param generation
+ *      The counts of the step, its generation number is set by the history.
+ */
+void Statistics::History::record(Generation generation) {
+	this->recorded++;
+	generation.generation = this->recorded;
+
+	if (this->generations.size() < this->capacity) {
+		this->generations.push_back(generation);
+	} else {
+		this->generations[this->next] = generation;
+	}
+	this->next = (this->next + 1) % this->capacity;
+}
+
+/**
+ * Statistics::History::clear()
+ *
+ * Forget every generation and restart the numbering from 1.
+ */
+void Statistics::History::clear() {
+	this->generations.clear();
+	this->next = 0;
+	this->recorded = 0;
+}
+
+/**
+ * Statistics::History::get_capacity()
+ *
+ * @return
+ *      The number of generations the history can keep.
+ */
+std::size_t Statistics::History::get_capacity() const {
+	return this->capacity;
+}
+
+/**
+ * Statistics::History::get_size()
+ *
+ * @return
+ *      The number of generations currently kept, at most the capacity.
+ */
+std::size_t Statistics::History::get_size() const {
+	return this->generations.size();
+}
+
+/**
+ * Statistics::History::get_recorded()
+ *
+ * @return
+ *      The number of generations recorded since the history was made or cleared, including any overwritten.
+ */
+std::uint64_t Statistics::History::get_recorded() const {
+	return this->recorded;
+}
+
+/**
+ * Statistics::History::operator[](index)
+ *
+ * Get a kept generation, oldest first.
+ *
+ * @example
+ *
+ *      // Print the population of every kept generation
+ *      for (std::size_t i = 0; i < history.get_size(); i++) {
+ *          std::cout << history[i].population << std::endl;
+ *      }
+ *
+ * @param index
+ *      The index from the oldest kept generation.
+ *
+ * @throws
+ *      Throws std::out_of_range if the index is not less than the size.
+ */
+const Statistics::Generation & Statistics::History::operator[](const std::size_t index) const {
+	if (index >= this->generations.size()) {
+		throw std::out_of_range(std::to_string(index) + " is not a valid index within the history");
+	}
+	// Until the buffer wraps the oldest is at 0, after that it is the next slot to be overwritten
+	const std::size_t oldest = this->generations.size() < this->capacity ? 0 : this->next;
+	return this->generations[(oldest + index) % this->generations.size()];
+}
+
+/**
+ * Statistics::History::latest()
+ *
+ * @return
+ *      The most recently recorded generation.
+ *
+ * @throws
+ *      Throws std::out_of_range if the history is empty.
+ */
+const Statistics::Generation & Statistics::History::latest() const {
+	if (this->generations.empty()) {
+		throw std::out_of_range("The history is empty");
+	}
+	return (*this)[this->generations.size() - 1];
+}
+
+/**
+ * Statistics::History::write_csv(output_stream)
+ *
+ * Write the kept generations oldest first as CSV, with a header line.
+ *
+ * @example
+ *
+ *      generation,population,births,deaths,changed,seconds
+ *      1,5,2,2,4,1.2e-07
+ *
+ * @param output_stream
+ *      The stream to write to.
+ */
+void Statistics::History::write_csv(std::ostream &output_stream) const {
+	output_stream << "generation,population,births,deaths,changed,seconds" << std::endl;
+	for (std::size_t i = 0; i < get_size(); i++) {
+		const Generation &generation = (*this)[i];
+		output_stream << generation.generation << ','
+					  << generation.population << ','
+					  << generation.births << ','
+					  << generation.deaths << ','
+					  << generation.changed() << ','
+					  << std::setprecision(9) << generation.seconds << std::endl;
+	}
+}
+
+/**
+ * Statistics::History::write_json(output_stream)
+ *
+ * Write the kept generations oldest first as a JSON array of objects.
+ *
+ * @param output_stream
+ *      The stream to write to.
+ */
+void Statistics::History::write_json(std::ostream &output_stream) const {
+	output_stream << "[" << std::endl;
+	for (std::size_t i = 0; i < get_size(); i++) {
+		const Generation &generation = (*this)[i];
+		output_stream << "  {\"generation\": " << generation.generation
+					  << ", \"population\": " << generation.population
+					  << ", \"births\": " << generation.births
+					  << ", \"deaths\": " << generation.deaths
+					  << ", \"changed\": " << generation.changed()
+					  << ", \"seconds\": " << std::setprecision(9) << generation.seconds
+					  << "}" << (i + 1 < get_size() ? "," : "") << std::endl;
+	}
+	output_stream << "]" << std::endl;
+}
+
+/**
+ * Statistics::save(path, history)
+ *
+ * Save a history to a file, as JSON if the path ends in .json and as CSV otherwise.
+ *
+ * @example
+ *
+ *      Statistics::save("run.csv", history);
+ *
+ * @param path
+ *      The std::string path to the file to write to.
+ *
+ * @param history
+ *      The history to write out.
+ *
+ * @throws
+ *      Throws std::runtime_error if the file cannot be opened.
+ */
+void Statistics::save(const std::string &path, const History &history) {
+	std::ofstream file(path);
+	if (!file) {
+		throw std::runtime_error(file_cannot_be_opened_error + path);
+	}
+
+	const std::string json = ".json";
+	if (path.size() >= json.size() && path.compare(path.size() - json.size(), json.size(), json) == 0) {
+		history.write_json(file);
+	} else {
+		history.write_csv(file);
+	}
+}
@@ -0,0 +1,72 @@
+/**
+ * Declares a Statistics namespace for recording what happens in each generation of a World.
+ * Rich documentation for the api and behaviour the Statistics namespace can be found in statistics.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Declare the interface of the Statistics namespace for per-generation counts and timings.
+ */
+namespace Statistics {
+
+	// Errors
+	const std::string capacity_not_positive_error = "The history capacity must be a positive integer: ";
+	const std::string file_cannot_be_opened_error = "File cannot be opened: ";
+
+	/**
+	 * The counts for one step.
+	 *      - generation is the number of steps taken when the counts were recorded, starting at 1.
+	 *      - population is the number of alive cells after the step.
+	 *      - births and deaths are the cells which became alive or dead in the step.
+	 *      - seconds is the wall time of the step, 0 if it was not timed.
+	 */
+	struct Generation {
+		std::uint64_t generation = 0;
+		std::uint64_t population = 0;
+		std::uint64_t births = 0;
+		std::uint64_t deaths = 0;
+		double seconds = 0;
+
+		std::uint64_t changed() const {
+			return births + deaths;
+		}
+	};
+
+	/**
+	 * A ring buffer of the most recent generations.
+	 * Once full, each new generation overwrites the oldest.
+	 */
+	class History {
+	private:
+		std::vector<Generation> generations;
+		std::size_t capacity;
+		std::size_t next;
+		std::uint64_t recorded;
+
+	public:
+		explicit History(int capacity = 1024);
+
+		void record(Generation generation);
+		void clear();
+
+		std::size_t get_capacity() const;
+		std::size_t get_size() const;
+		std::uint64_t get_recorded() const;
+
+		const Generation & operator[](std::size_t index) const;
+		const Generation & latest() const;
+
+		void write_csv(std::ostream &output_stream) const;
+		void write_json(std::ostream &output_stream) const;
+	};
+
+	void save(const std::string &path, const History &history);
+};
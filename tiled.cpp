@@ -0,0 +1,677 @@
+/**
+ * Implements a TiledGrid class of copy-on-write tiles, and a TiledWorld which steps it sharing unchanged tiles.
+ *      - A Grid is one contiguous buffer, so a snapshot of a world for history, undo or a concurrent reader
+ *        copies every cell, however little changed since the last one.
+ *
+ *      - A TiledGrid is a row major array of pointers to 64 x 64 cell tiles.
+ *          - Tiles are bit-packed, one 64 bit word per row, as BitGrid packs cells.
+ *          - Tiles are reference counted. Copying a grid copies the pointers, and setting a cell of a tile
+ *            which is shared with another grid first gives this grid its own copy of the tile.
+ *          - Every tile with no alive cells is one shared dead tile, so empty space costs a pointer.
+ *          - Cells past the right or bottom edge of the last tiles are always dead.
+ *
+ *      - TiledGrid::step(source, destination, toroidal) steps a tile at a time with the bit-sliced adder
+ *        the bit-packed kernel uses, reading the edge cells of the 8 neighbouring tiles.
+ *          - A dead tile whose 8 neighbours are dead stays the dead tile without being stepped.
+ *          - A tile which comes out the same as the source tile shares the source tile's pointer.
+ *          - A tile which comes out dead shares the dead tile.
+ *          - Otherwise the destination's own tile is overwritten if nothing else shares it, or a new one made.
+ *          - So stepping back and forth between two grids only allocates for tiles which changed and are
+ *            held by a snapshot, and a history of snapshots costs memory in proportion to the change.
+ *
+ *      - Settled soups are mostly blocks, beehives and blinkers, which repeat every 1 or 2 generations.
+ *        A TiledWorld steps with replay on, since its next state holds the generation before its current one.
+ *          - Each stepped tile is flagged as repeating if it comes out the same as the tile two generations
+ *            before, which the destination still holds. Still lifes repeat with period 1 and so also 2.
+ *          - A tile is only stepped from its own cells and the edges of its 8 neighbours. So if those 9 tiles
+ *            are all repeating, the tile's next state is the same as the one two generations before. It is
+ *            frozen: the destination's tile is kept as it is, without being stepped, copied or compared.
+ *          - One repeat is enough to make this exact, so tiles are frozen as soon as their neighbourhood
+ *            repeats, and a frozen tile keeps its flag for as long as it stays frozen.
+ *          - A tile is reactivated on the first generation any of its neighbours stops repeating, so a glider
+ *            arriving at a block wakes it one generation before it could change.
+ *
+ *      - Copies of a grid share tiles through their reference counts, which are atomic, but the grid itself
+ *        is not synchronised. A snapshot taken on one thread can be read freely on another.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "tiled.h"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+/**
+ * The tile every dead tile of every grid shares. It is never written, as the reference held here
+ * means it is always shared.
+ * @return The dead tile.
+ */
+static const std::shared_ptr<TiledGrid::Tile> & dead_tile() {
+	static const std::shared_ptr<TiledGrid::Tile> dead = std::make_shared<TiledGrid::Tile>(TiledGrid::Tile());
+	return dead;
+}
+
+/**
+ * Check whether a tile has no alive cells.
+ * @param tile - The tile.
+ * @return True if every cell of the tile is dead.
+ */
+static bool is_dead(const TiledGrid::Tile &tile) {
+	for (const std::uint64_t row : tile.rows) {
+		if (row != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * TiledGrid::TiledGrid()
+ *
+ * Construct an empty tiled grid with 0 width and 0 height.
+ */
+TiledGrid::TiledGrid() : TiledGrid(0, 0) {}
+
+/**
+ * TiledGrid::TiledGrid(width, height)
+ *
+ * Construct a tiled grid with every cell dead. Every tile is the shared dead tile, so no cells are allocated.
+ *
+ * @example
+ *
+ *      // Make a 4096x4096 grid which costs 4096 pointers
+ *      TiledGrid grid(4096, 4096);
+ *
+ * @param width
+ *      The width of the grid. Negative widths are treated as 0.
+ *
+ * @param height
+ *      The height of the grid. Negative heights are treated as 0.
+ */
+TiledGrid::TiledGrid(const int width, const int height)
+		: grid_width(std::max(width, 0)), grid_height(std::max(height, 0)),
+		  tiles_across((std::max(width, 0) + tile_size - 1) / tile_size),
+		  tiles_down((std::max(height, 0) + tile_size - 1) / tile_size),
+		  tiles(static_cast<std::size_t>(tiles_across) * tiles_down, dead_tile()),
+		  repeating(tiles.size(), 0) {}
+
+/**
+ * TiledGrid::TiledGrid(grid)
+ *
+ * Construct a tiled grid holding the cells of a grid or view of either layout.
+ * Tiles with no alive cells share the dead tile.
+ *
+ * @example
+ *
+ *      TiledGrid grid(GridView(Zoo::load_ascii("path/to/file.gol")));
+ *
+ * @param grid
+ *      The cells to copy.
+ */
+template <typename Storage>
+TiledGrid::TiledGrid(const BasicGridView<Storage> &grid) : TiledGrid(grid.get_width(), grid.get_height()) {
+	Tile scratch;
+	for (int tile_y = 0; tile_y < this->tiles_down; tile_y++) {
+		for (int tile_x = 0; tile_x < this->tiles_across; tile_x++) {
+			const int x0 = tile_x * tile_size;
+			const int y0 = tile_y * tile_size;
+			const int columns = std::min(tile_size, this->grid_width - x0);
+			for (int row = 0; row < tile_size; row++) {
+				scratch.rows[row] = y0 + row < this->grid_height ?
+									Storage::load(grid.row(y0 + row), grid.get_offset() + x0, columns) : 0;
+			}
+			if (!is_dead(scratch)) {
+				this->tiles[static_cast<std::size_t>(tile_y) * this->tiles_across + tile_x] = std::make_shared<Tile>(scratch);
+			}
+		}
+	}
+}
+
+/**
+ * TiledGrid::get_width()
+ *
+ * @return
+ *      The width of the grid.
+ */
+int TiledGrid::get_width() const {
+	return this->grid_width;
+}
+
+/**
+ * TiledGrid::get_height()
+ *
+ * @return
+ *      The height of the grid.
+ */
+int TiledGrid::get_height() const {
+	return this->grid_height;
+}
+
+/**
+ * TiledGrid::get_tiles_across()
+ *
+ * @return
+ *      The number of columns of tiles, the last of which may be partly past the right edge.
+ */
+int TiledGrid::get_tiles_across() const {
+	return this->tiles_across;
+}
+
+/**
+ * TiledGrid::get_tiles_down()
+ *
+ * @return
+ *      The number of rows of tiles, the last of which may be partly past the bottom edge.
+ */
+int TiledGrid::get_tiles_down() const {
+	return this->tiles_down;
+}
+
+/**
+ * TiledGrid::get_total_cells()
+ *
+ * @return
+ *      The number of cells in the grid, width * height.
+ */
+unsigned int TiledGrid::get_total_cells() const {
+	return static_cast<unsigned int>(this->grid_width) * static_cast<unsigned int>(this->grid_height);
+}
+
+/**
+ * TiledGrid::get_alive_cells()
+ *
+ * Count the alive cells a word at a time, skipping tiles which share the dead tile.
+ *
+ * @return
+ *      The number of alive cells.
+ */
+unsigned int TiledGrid::get_alive_cells() const {
+	unsigned int alive = 0;
+	for (const std::shared_ptr<Tile> &tile : this->tiles) {
+		if (tile == dead_tile()) {
+			continue;
+		}
+		for (const std::uint64_t row : tile->rows) {
+			alive += static_cast<unsigned int>(std::bitset<64>(row).count());
+		}
+	}
+	return alive;
+}
+
+/**
+ * Check if a coordinate is inside the grid.
+ * @param x - The x coordinate.
+ * @param y - The y coordinate.
+ *
+ * @throws - std::out_of_range if the coordinate is outside the grid.
+ */
+void TiledGrid::check_if_in_bounds(const int x, const int y) const {
+	if (x >= this->grid_width || y >= this->grid_height || x < 0 || y < 0) {
+		std::stringstream ss;
+		ss << x << ", " << y << " is not a valid coordinate within the grid";
+		throw std::out_of_range(ss.str());
+	}
+}
+
+/**
+ * Get a tile of this grid which can be written, copying it first if it is shared.
+ * @param tile_x - The column of the tile.
+ * @param tile_y - The row of the tile.
+ * @return The tile, owned by this grid alone.
+ */
+TiledGrid::Tile & TiledGrid::writable_tile(const int tile_x, const int tile_y) {
+	std::shared_ptr<Tile> &tile = this->tiles[static_cast<std::size_t>(tile_y) * this->tiles_across + tile_x];
+	if (tile.use_count() > 1) {
+		tile = std::make_shared<Tile>(*tile);
+	}
+	return *tile;
+}
+
+/**
+ * TiledGrid::get(x, y)
+ *
+ * @example
+ *
+ *      TiledGrid grid(4, 4);
+ *      Cell cell = grid.get(1, 2);
+ *
+ * @param x
+ *      The x coordinate of the cell.
+ *
+ * @param y
+ *      The y coordinate of the cell.
+ *
+ * @return
+ *      The value of the cell.
+ *
+ * @throws
+ *      std::out_of_range if the coordinate is outside the grid.
+ */
+Cell TiledGrid::get(const int x, const int y) const {
+	check_if_in_bounds(x, y);
+	const std::uint64_t row = tile(x / tile_size, y / tile_size)->rows[y % tile_size];
+	return (row >> (x % tile_size)) & 1 ? Cell::ALIVE : Cell::DEAD;
+}
+
+/**
+ * TiledGrid::set(x, y, value)
+ *
+ * Set a cell, first copying its tile if any other grid shares it.
+ * The tile is no longer considered repeating, so a step with replay steps it and its neighbours again.
+ *
+ * @example
+ *
+ *      TiledGrid grid(4096, 4096);
+ *      TiledGrid snapshot = grid;
+ *
+ *      // Copies one 64x64 tile, the snapshot keeps the original
+ *      grid.set(100, 100, Cell::ALIVE);
+ *
+ * @param x
+ *      The x coordinate of the cell.
+ *
+ * @param y
+ *      The y coordinate of the cell.
+ *
+ * @param value
+ *      The new value of the cell.
+ *
+ * @throws
+ *      std::out_of_range if the coordinate is outside the grid.
+ */
+void TiledGrid::set(const int x, const int y, const Cell value) {
+	check_if_in_bounds(x, y);
+	this->repeating[static_cast<std::size_t>(y / tile_size) * this->tiles_across + x / tile_size] = 0;
+	std::uint64_t &row = writable_tile(x / tile_size, y / tile_size).rows[y % tile_size];
+	const std::uint64_t bit = std::uint64_t(1) << (x % tile_size);
+	row = value == Cell::ALIVE ? row | bit : row & ~bit;
+}
+
+/**
+ * TiledGrid::tile(tile_x, tile_y)
+ *
+ * @param tile_x
+ *      The column of the tile.
+ *
+ * @param tile_y
+ *      The row of the tile.
+ *
+ * @return
+ *      The tile, which may be shared with other grids and must not be held past the next change to this grid.
+ */
+const TiledGrid::Tile * TiledGrid::tile(const int tile_x, const int tile_y) const {
+	return this->tiles[static_cast<std::size_t>(tile_y) * this->tiles_across + tile_x].get();
+}
+
+/**
+ * TiledGrid::count_shared(other)
+ *
+ * Count the tiles this grid shares with another of the same size, such as a snapshot of it.
+ *
+ * @param other
+ *      The other grid.
+ *
+ * @return
+ *      The number of tile positions holding the same tile in both grids, dead tiles included.
+ *      0 if the grids are different sizes.
+ */
+std::size_t TiledGrid::count_shared(const TiledGrid &other) const {
+	if (other.grid_width != this->grid_width || other.grid_height != this->grid_height) {
+		return 0;
+	}
+	std::size_t shared = 0;
+	for (std::size_t i = 0; i < this->tiles.size(); i++) {
+		shared += this->tiles[i] == other.tiles[i];
+	}
+	return shared;
+}
+
+/**
+ * TiledGrid::materialize()
+ *
+ * Copy the cells into a contiguous bit-packed grid.
+ *
+ * @return
+ *      A new BitGrid holding the same cells.
+ */
+BitGrid TiledGrid::materialize() const {
+	BitGrid grid(this->grid_width, this->grid_height);
+	for (int y = 0; y < this->grid_height; y++) {
+		for (int tile_x = 0; tile_x < this->tiles_across; tile_x++) {
+			const int x0 = tile_x * tile_size;
+			BitCells::store(grid.row(y), x0, std::min(tile_size, this->grid_width - x0),
+							tile(tile_x, y / tile_size)->rows[y % tile_size]);
+		}
+	}
+	return grid;
+}
+
+/**
+ * TiledGrid::distinct_bytes(grids)
+ *
+ * The memory a set of grids holds between them, such as a history of snapshots,
+ * counting each shared tile once and the dead tile not at all.
+ *
+ * @example
+ *
+ *      std::vector<TiledGrid> history;
+ *      for (int i = 0; i < 100; i++) {
+ *          world.step();
+ *          history.push_back(world.get_state());
+ *      }
+ *      std::size_t bytes = TiledGrid::distinct_bytes(history);
+ *
+ * @param grids
+ *      The grids.
+ *
+ * @return
+ *      The bytes of every distinct tile plus the tile pointers of every grid.
+ */
+std::size_t TiledGrid::distinct_bytes(const std::vector<TiledGrid> &grids) {
+	std::unordered_set<const Tile *> distinct;
+	std::size_t pointers = 0;
+	for (const TiledGrid &grid : grids) {
+		pointers += grid.tiles.size() * sizeof(std::shared_ptr<Tile>);
+		for (const std::shared_ptr<Tile> &tile : grid.tiles) {
+			if (tile != dead_tile()) {
+				distinct.insert(tile.get());
+			}
+		}
+	}
+	return distinct.size() * sizeof(Tile) + pointers;
+}
+
+/**
+ * TiledGrid::step(source, destination, toroidal, replay)
+ *
+ * Take one step in Conway's Game of Life from one tiled grid into another, a tile at a time.
+ * Each row of a tile is stepped 64 cells at once, as BitWorld::step does, from the rows above and below
+ * and the edge cells of the tiles either side, wrapping around the grid if toroidal.
+ * A tile which is unchanged shares the source's tile, a dead tile shares the dead tile, and otherwise the
+ * destination's tile is reused if nothing else holds it. The destination is resized if it is not the same size.
+ *
+ * With replay, the destination must hold the generation before the source, stepped with the same topology.
+ * A tile whose neighbourhood of 9 tiles all repeat the tiles of two generations before keeps the destination's
+ * tile without being stepped, and every other tile is flagged as repeating if it comes out the same as the
+ * destination's tile. Without replay no tile is flagged, so the first step of a world is taken without it.
+ *
+ * @example
+ *
+ *      TiledGrid current(GridView(Zoo::glider())), next;
+ *      TiledGrid::step(current, next);
+ *
+ * @param source
+ *      The grid to step.
+ *
+ * @param destination
+ *      The grid to write the next generation into, which must not be the source.
+ *
+ * @param toroidal
+ *      Optional parameter. If true then the step will consider the grid as a torus, where the left edge
+ *      wraps to the right edge and the top to the bottom. Defaults to false.
+ *
+ * @param replay
+ *      Optional parameter. If true then the destination holds the generation before the source, and tiles whose
+ *      neighbourhood repeats are replayed from it. Defaults to false.
+ *
+ * @return
+ *      The number of tiles replayed rather than stepped.
+ */
+std::size_t TiledGrid::step(const TiledGrid &source, TiledGrid &destination, const bool toroidal, bool replay) {
+	const int width = source.grid_width;
+	const int height = source.grid_height;
+	if (destination.grid_width != width || destination.grid_height != height) {
+		destination = TiledGrid(width, height);
+		replay = false;
+	}
+	std::size_t replayed = 0;
+
+	// One row of cells with the cells either side of it, from the tiles to its left and right
+	struct Line {
+		std::uint64_t word;
+		std::uint64_t west;
+		std::uint64_t east;
+	};
+	auto cell = [&source](const int x, const int y) -> std::uint64_t {
+		return (source.tile(x / tile_size, y / tile_size)->rows[y % tile_size] >> (x % tile_size)) & 1;
+	};
+
+	Tile scratch;
+	for (int tile_y = 0; tile_y < source.tiles_down; tile_y++) {
+		for (int tile_x = 0; tile_x < source.tiles_across; tile_x++) {
+			const int x0 = tile_x * tile_size;
+			const int y0 = tile_y * tile_size;
+			const int columns = std::min(tile_size, width - x0);
+			const int rows = std::min(tile_size, height - y0);
+			const std::uint64_t mask = columns == tile_size ? ~std::uint64_t(0) : (std::uint64_t(1) << columns) - 1;
+			const std::size_t index = static_cast<std::size_t>(tile_y) * destination.tiles_across + tile_x;
+			std::shared_ptr<Tile> &target = destination.tiles[index];
+
+			// Nothing can be born in a dead tile with dead neighbours, so empty space is not stepped at all,
+			// and a tile whose neighbourhood repeats will repeat too, so it keeps the tile of two generations before
+			bool quiet = true;
+			bool settled = replay;
+			for (int dy = -1; dy <= 1 && (quiet || settled); dy++) {
+				for (int dx = -1; dx <= 1 && (quiet || settled); dx++) {
+					int neighbour_x = tile_x + dx;
+					int neighbour_y = tile_y + dy;
+					if (toroidal) {
+						neighbour_x = (neighbour_x + source.tiles_across) % source.tiles_across;
+						neighbour_y = (neighbour_y + source.tiles_down) % source.tiles_down;
+					} else if (neighbour_x < 0 || neighbour_x >= source.tiles_across ||
+							   neighbour_y < 0 || neighbour_y >= source.tiles_down) {
+						continue;
+					}
+					const std::size_t neighbour = static_cast<std::size_t>(neighbour_y) * source.tiles_across + neighbour_x;
+					quiet = quiet && source.tiles[neighbour] == dead_tile();
+					settled = settled && source.repeating[neighbour];
+				}
+			}
+			if (settled) {
+				destination.repeating[index] = 1;
+				replayed++;
+				continue;
+			}
+			if (quiet) {
+				destination.repeating[index] = replay && target == dead_tile();
+				target = dead_tile();
+				continue;
+			}
+
+			auto line = [&](int y) -> Line {
+				if (y < 0 || y >= height) {
+					if (!toroidal) {
+						return Line{0, 0, 0};
+					}
+					y = (y + height) % height;
+				}
+				Line result{source.tile(tile_x, y / tile_size)->rows[y % tile_size], 0, 0};
+				if (x0 > 0 || toroidal) {
+					result.west = cell(x0 > 0 ? x0 - 1 : width - 1, y);
+				}
+				if (columns < tile_size) {
+					// The cell past the last column is the first column of a torus, in the first unused bit
+					result.word |= toroidal ? cell(0, y) << columns : 0;
+				} else if (x0 + tile_size < width || toroidal) {
+					result.east = cell(x0 + tile_size < width ? x0 + tile_size : 0, y);
+				}
+				return result;
+			};
+
+			Line above = line(y0 - 1);
+			Line middle = line(y0);
+			for (int row = 0; row < tile_size; row++) {
+				if (row >= rows) {
+					scratch.rows[row] = 0;
+					continue;
+				}
+				const Line below = line(y0 + row + 1);
+				const std::uint64_t neighbours[8] = {
+					(above.word << 1) | above.west, above.word, (above.word >> 1) | (above.east << 63),
+					(middle.word << 1) | middle.west, (middle.word >> 1) | (middle.east << 63),
+					(below.word << 1) | below.west, below.word, (below.word >> 1) | (below.east << 63)
+				};
+
+				// Count to 3 bit by bit, with fours set once any cell reaches 4 neighbours
+				std::uint64_t ones = 0, twos = 0, fours = 0;
+				for (const std::uint64_t neighbour : neighbours) {
+					const std::uint64_t carry = ones & neighbour;
+					ones ^= neighbour;
+					fours |= twos & carry;
+					twos ^= carry;
+				}
+				scratch.rows[row] = ~fours & twos & (ones | middle.word) & mask;
+				above = middle;
+				middle = below;
+			}
+
+			const std::shared_ptr<Tile> &current = source.tiles[static_cast<std::size_t>(tile_y) * source.tiles_across + tile_x];
+			const bool repeats = replay && std::memcmp(scratch.rows, target->rows, sizeof(scratch.rows)) == 0;
+			destination.repeating[index] = repeats;
+			if (std::memcmp(scratch.rows, current->rows, sizeof(scratch.rows)) == 0) {
+				target = current;
+			} else if (repeats) {
+				// The destination already holds this tile from two generations before
+			} else if (is_dead(scratch)) {
+				target = dead_tile();
+			} else if (target.use_count() == 1) {
+				*target = scratch;
+			} else {
+				target = std::make_shared<Tile>(scratch);
+			}
+		}
+	}
+	return replayed;
+}
+
+/**
+ * TiledWorld::TiledWorld()
+ *
+ * Construct an empty tiled world with 0 width and 0 height.
+ */
+TiledWorld::TiledWorld() = default;
+
+/**
+ * TiledWorld::TiledWorld(initial_state)
+ *
+ * Construct a tiled world starting from a tiled grid, sharing its tiles.
+ *
+ * @example
+ *
+ *      TiledWorld world(TiledGrid(GridView(Zoo::load_ascii("path/to/file.gol"))));
+ *
+ * @param initial_state
+ *      The state of the constructed world.
+ */
+TiledWorld::TiledWorld(const TiledGrid &initial_state)
+		: current_state(initial_state), next_state(initial_state.get_width(), initial_state.get_height()) {}
+
+/**
+ * TiledWorld::get_width()
+ *
+ * @return
+ *      The width of the world.
+ */
+unsigned int TiledWorld::get_width() const {
+	return static_cast<unsigned int>(this->current_state.get_width());
+}
+
+/**
+ * TiledWorld::get_height()
+ *
+ * @return
+ *      The height of the world.
+ */
+unsigned int TiledWorld::get_height() const {
+	return static_cast<unsigned int>(this->current_state.get_height());
+}
+
+/**
+ * TiledWorld::get_alive_cells()
+ *
+ * @return
+ *      The number of alive cells in the current state.
+ */
+unsigned int TiledWorld::get_alive_cells() const {
+	return this->current_state.get_alive_cells();
+}
+
+/**
+ * TiledWorld::get_state()
+ *
+ * The current state. Copying it is a snapshot which shares every tile, and only costs memory
+ * as the world changes the tiles after it.
+ *
+ * @example
+ *
+ *      std::vector<TiledGrid> history;
+ *      world.step();
+ *      history.push_back(world.get_state());
+ *
+ * @return
+ *      A reference to the current state.
+ */
+const TiledGrid & TiledWorld::get_state() const {
+	return this->current_state;
+}
+
+/**
+ * TiledWorld::get_replayed_tiles()
+ *
+ * @return
+ *      The number of tiles the last step replayed from the generation before instead of stepping.
+ */
+std::size_t TiledWorld::get_replayed_tiles() const {
+	return this->replayed;
+}
+
+/**
+ * TiledWorld::step(toroidal)
+ *
+ * Take one step in Conway's Game of Life with TiledGrid::step(source, destination, toroidal, replay), then swap the grids.
+ * Tiles which did not change are shared with the previous generation, and tiles of the old next state
+ * which no snapshot holds are overwritten rather than allocated again.
+ *
+ * Once the world has stepped, its next state holds the generation before its current one, so later steps
+ * replay tiles whose neighbourhood repeats with period 1 or 2 instead of stepping them.
+ * Changing the topology between steps takes that step without replay, so no tile is replayed again until it
+ * has repeated under the new topology.
+ *
+ * @param toroidal
+ *      Optional parameter. If true then the step will consider the grid as a torus, where the left edge
+ *      wraps to the right edge and the top to the bottom. Defaults to false.
+ */
+void TiledWorld::step(const bool toroidal) {
+	const bool replay = this->has_previous && this->previous_toroidal == toroidal;
+	this->replayed = TiledGrid::step(this->current_state, this->next_state, toroidal, replay);
+	std::swap(this->current_state, this->next_state);
+	this->has_previous = true;
+	this->previous_toroidal = toroidal;
+}
+
+/**
+ * TiledWorld::advance(steps, toroidal)
+ *
+ * Advance multiple steps with TiledWorld::step(toroidal).
+ *
+ * @param steps
+ *      The number of steps to advance the world forward.
+ *
+ * @param toroidal
+ *      Optional parameter. If true then the step will consider the grid as a torus, where the left edge
+ *      wraps to the right edge and the top to the bottom. Defaults to false.
+ */
+void TiledWorld::advance(const int steps, const bool toroidal) {
+	for (int i = 0; i < steps; i++) {
+		step(toroidal);
+	}
+}
+
+// Grids of both layouts can be tiled
+template TiledGrid::TiledGrid(const BasicGridView<ByteCells> &grid);
+template TiledGrid::TiledGrid(const BasicGridView<BitCells> &grid);
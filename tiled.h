@@ -0,0 +1,96 @@
+/**
+ * Declares a TiledGrid class of copy-on-write tiles, and a TiledWorld which steps it sharing unchanged tiles.
+ * Rich documentation for the api and behaviour of the TiledGrid and TiledWorld classes can be found in tiled.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "grid.h"
+
+/**
+ * Declare the structure of the TiledGrid class for a grid of reference counted, bit-packed tiles.
+ *
+ * Copying a TiledGrid copies pointers to its tiles, not its cells. A tile is only copied when a cell
+ * of a grid sharing it is set, so a copy of a grid is a cheap snapshot which costs memory as it diverges.
+ */
+class TiledGrid {
+public:
+	// Tiles are 64 x 64 cells, one 64 bit word per row
+	static constexpr int tile_size = 64;
+
+	/**
+	 * The cells of one tile, row by row, cell x of a row in bit x of its word.
+	 */
+	struct Tile {
+		std::uint64_t rows[tile_size];
+	};
+
+private:
+	int grid_width;
+	int grid_height;
+	int tiles_across;
+	int tiles_down;
+	std::vector<std::shared_ptr<Tile>> tiles;
+	std::vector<unsigned char> repeating;
+
+	void check_if_in_bounds(int x, int y) const;
+	Tile & writable_tile(int tile_x, int tile_y);
+
+public:
+	TiledGrid();
+	TiledGrid(int width, int height);
+	template <typename Storage> explicit TiledGrid(const BasicGridView<Storage> &grid);
+
+	int get_width() const;
+	int get_height() const;
+	int get_tiles_across() const;
+	int get_tiles_down() const;
+	unsigned int get_total_cells() const;
+	unsigned int get_alive_cells() const;
+
+	Cell get(int x, int y) const;
+	void set(int x, int y, Cell value);
+
+	const Tile * tile(int tile_x, int tile_y) const;
+	std::size_t count_shared(const TiledGrid &other) const;
+	BitGrid materialize() const;
+
+	static std::size_t distinct_bytes(const std::vector<TiledGrid> &grids);
+	static std::size_t step(const TiledGrid &source, TiledGrid &destination, bool toroidal = false, bool replay = false);
+};
+
+/**
+ * Declare the structure of the TiledWorld class for stepping a TiledGrid.
+ *
+ * Like a World it keeps its current and next state, but a step shares every tile which did not change
+ * with the generation before, so a snapshot taken each generation only costs the tiles that changed.
+ * Tiles whose neighbourhood repeats with period 1 or 2 are not stepped at all, their next state is the
+ * tile the world already holds from the generation before.
+ */
+class TiledWorld {
+private:
+	TiledGrid current_state;
+	TiledGrid next_state;
+	bool has_previous = false;
+	bool previous_toroidal = false;
+	std::size_t replayed = 0;
+
+public:
+	TiledWorld();
+	explicit TiledWorld(const TiledGrid &initial_state);
+
+	unsigned int get_width() const;
+	unsigned int get_height() const;
+	unsigned int get_alive_cells() const;
+	const TiledGrid & get_state() const;
+	std::size_t get_replayed_tiles() const;
+
+	void step(bool toroidal = false);
+	void advance(int steps, bool toroidal = false);
+};
@@ -0,0 +1,278 @@
+/**
+ * Implements a Topology namespace for finding the cores and NUMA nodes of the machine and pinning threads to them.
+ *      - On a machine with several sockets each has its own memory, and Linux places a page on the node of
+ *        the thread which first writes it. A threaded step is only as fast as the slowest band, so a band
+ *        whose rows live on the other socket holds back the whole step.
+ *
+ *      - Placement is off until Topology::enable() is called. Once on:
+ *          - Step workers are pinned, band by band, to cpus chosen by Topology::cpu_for(worker, workers).
+ *          - World::place(grid, threads) moves each band of a grid's rows to the node of the worker which steps it.
+ *          - It is off by default since pinning fights the scheduler when several processes share the machine.
+ *
+ *      - The topology is read once from sysfs, and only includes cpus the process is allowed to run on.
+ *          - Nodes come from /sys/devices/system/node/node<n>/cpulist.
+ *          - Hardware threads of one core come from /sys/devices/system/cpu/cpu<n>/topology/thread_siblings_list.
+ *          - Elsewhere, or if sysfs cannot be read, every cpu is on node 0 and is its own core.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "topology.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Whether workers are pinned and grids placed
+static std::atomic<bool> placing(false);
+
+/**
+ * Parse a sysfs cpu list, such as "0-3,8-11".
+ * @param path - The file holding the list.
+ * @return The cpus in the list, empty if the file cannot be read.
+ */
+static std::vector<int> read_cpu_list(const std::string &path) {
+	std::vector<int> list;
+	std::ifstream input(path);
+	std::string text;
+	if (!std::getline(input, text)) {
+		return list;
+	}
+
+	std::stringstream ranges(text);
+	std::string range;
+	while (std::getline(ranges, range, ',')) {
+		int first = 0, last = 0;
+		const std::size_t dash = range.find('-');
+		try {
+			first = std::stoi(range.substr(0, dash));
+			last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+		}
+		catch (const std::exception &) {
+			continue;
+		}
+		for (int cpu = first; cpu <= last; cpu++) {
+			list.push_back(cpu);
+		}
+	}
+	return list;
+}
+
+/**
+ * Detect the cpus the process may run on, ordered by node, then first hardware threads before their siblings.
+ * @return The cpus, never empty.
+ */
+static std::vector<Topology::Cpu> detect() {
+	std::vector<Topology::Cpu> found;
+
+#if defined(__linux__)
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	const bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+	std::vector<int> online = read_cpu_list("/sys/devices/system/cpu/online");
+	for (const int id : online) {
+		if (have_mask && (id >= CPU_SETSIZE || !CPU_ISSET(id, &allowed))) {
+			continue;
+		}
+		Topology::Cpu cpu;
+		cpu.id = id;
+
+		const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(id);
+		const std::vector<int> siblings = read_cpu_list(base + "/topology/thread_siblings_list");
+		const auto position = std::find(siblings.begin(), siblings.end(), id);
+		cpu.sibling = position == siblings.end() ? 0 : static_cast<int>(position - siblings.begin());
+
+		for (int node = 0; node < 1024; node++) {
+			std::ifstream exists("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+			if (!exists) {
+				break;
+			}
+			const std::vector<int> members = read_cpu_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+			if (std::find(members.begin(), members.end(), id) != members.end()) {
+				cpu.node = node;
+				break;
+			}
+		}
+		found.push_back(cpu);
+	}
+#endif
+
+	if (found.empty()) {
+		const int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+		for (int id = 0; id < count; id++) {
+			Topology::Cpu cpu;
+			cpu.id = id;
+			found.push_back(cpu);
+		}
+	}
+
+	std::stable_sort(found.begin(), found.end(), [](const Topology::Cpu &a, const Topology::Cpu &b) {
+		return a.node != b.node ? a.node < b.node : a.sibling != b.sibling ? a.sibling < b.sibling : a.id < b.id;
+	});
+	return found;
+}
+
+/**
+ * Topology::enable(on)
+ *
+ * Turn pinning of step workers and placement of grids on or off for every thread.
+ *
+ * @example
+ *
+ *      Topology::enable();
+ *      World::place(current, 8);
+ *      World::place(next, 8);
+ *      World::step(current, next, false, 8);
+ *
+ * @param on
+ *      Optional parameter. True to pin and place, false to leave it to the scheduler. Defaults to true.
+ */
+void Topology::enable(const bool on) {
+	placing.store(on, std::memory_order_relaxed);
+}
+
+/**
+ * Topology::enabled()
+ *
+ * @return
+ *      True if step workers are pinned and grids placed.
+ */
+bool Topology::enabled() {
+	return placing.load(std::memory_order_relaxed);
+}
+
+/**
+ * Topology::cpus()
+ *
+ * The cpus the process may run on, read once on first use.
+ * Ordered by node, and within a node every core's first hardware thread before any second one.
+ *
+ * @return
+ *      The cpus, never empty.
+ */
+const std::vector<Topology::Cpu> & Topology::cpus() {
+	static const std::vector<Cpu> found = detect();
+	return found;
+}
+
+/**
+ * Topology::nodes()
+ *
+ * @return
+ *      The number of NUMA nodes with cpus the process may run on.
+ */
+int Topology::nodes() {
+	int count = 0;
+	int last = -1;
+	for (const Cpu &cpu : cpus()) {
+		if (cpu.node != last) {
+			count++;
+			last = cpu.node;
+		}
+	}
+	return count;
+}
+
+/**
+ * Topology::cpu_for(worker, workers)
+ *
+ * Choose the cpu for one of a number of workers stepping consecutive bands of rows.
+ * Workers are shared between nodes in proportion to their cpus, in order, so neighbouring bands are on
+ * the same node and only the rows either side of a node's last band cross between sockets.
+ * Within a node workers take separate cores first, and only share a core once every core has a worker.
+ *
+ * @example
+ *
+ *      // Two sockets of 8 cores, 4 workers, two on each socket
+ *      int cpu = Topology::cpu_for(2, 4);
+ *
+ * @param worker
+ *      The worker, from 0.
+ *
+ * @param workers
+ *      The number of workers.
+ *
+ * @return
+ *      The id of the cpu the worker should be pinned to.
+ */
+int Topology::cpu_for(const unsigned int worker, const unsigned int workers) {
+	const std::vector<Cpu> &all = cpus();
+	const std::size_t count = all.size();
+	if (workers <= 1) {
+		return all[0].id;
+	}
+
+	// The range of cpus whose share of the workers includes this one
+	const std::size_t position = (static_cast<std::size_t>(worker) * count) / workers;
+	const int node = all[position].node;
+	std::size_t first = position;
+	while (first > 0 && all[first - 1].node == node) {
+		first--;
+	}
+	std::size_t end = position;
+	while (end < count && all[end].node == node) {
+		end++;
+	}
+
+	// The first worker on this node, so workers fill a node's cores in order
+	unsigned int first_worker = static_cast<unsigned int>((first * workers + count - 1) / count);
+	return all[first + (worker - first_worker) % (end - first)].id;
+}
+
+/**
+ * Topology::pin(cpu)
+ *
+ * Pin the calling thread to one cpu.
+ *
+ * @param cpu
+ *      The id of the cpu.
+ *
+ * @return
+ *      True if the thread was pinned, false if the cpu is not allowed or pinning is not supported.
+ */
+bool Topology::pin(const int cpu) {
+#if defined(__linux__)
+	if (cpu < 0 || cpu >= CPU_SETSIZE) {
+		return false;
+	}
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	(void) cpu;
+	return false;
+#endif
+}
+
+/**
+ * Topology::unpin()
+ *
+ * Let the calling thread run on any cpu the process may run on again, undoing Topology::pin.
+ *
+ * @return
+ *      True if the thread was unpinned, false if pinning is not supported.
+ */
+bool Topology::unpin() {
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (const Cpu &cpu : cpus()) {
+		if (cpu.id >= 0 && cpu.id < CPU_SETSIZE) {
+			CPU_SET(cpu.id, &set);
+		}
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
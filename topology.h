@@ -0,0 +1,36 @@
+/**
+ * Declares a Topology namespace for finding the cores and NUMA nodes of the machine and pinning threads to them.
+ * Rich documentation for the api and behaviour of the Topology namespace can be found in topology.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <vector>
+
+/**
+ * Declare the interface of the Topology namespace for placing step workers near their memory.
+ */
+namespace Topology {
+
+	/**
+	 * A logical cpu the process may run on.
+	 *      - node is its NUMA node, 0 on machines with one.
+	 *      - sibling is 0 for the first hardware thread of a core, 1 for the second and so on.
+	 */
+	struct Cpu {
+		int id = 0;
+		int node = 0;
+		int sibling = 0;
+	};
+
+	void enable(bool on = true);
+	bool enabled();
+
+	const std::vector<Cpu> & cpus();
+	int nodes();
+	int cpu_for(unsigned int worker, unsigned int workers);
+	bool pin(int cpu);
+	bool unpin();
+};
@@ -0,0 +1,226 @@
+/**
+ * Implements a Workers namespace for pools of threads which are started once and run the bands of many steps.
+ *      - A threaded step splits its rows into bands and steps each on its own thread. Starting those threads
+ *        for every step costs more than stepping a small band, and a daemon stepping many worlds all day
+ *        starts millions of them.
+ *
+ *      - A Pool starts its threads once, and each run wakes them to take one task apiece.
+ *          - The calling thread runs task 0 itself, worker i runs task i + 1, and the call returns once all are done.
+ *          - A pinned run gives every task to a worker, worker i running task i on the cpu Topology::cpu_for
+ *            chooses, so the calling thread is never pinned. Workers stay pinned until a run needs them
+ *            elsewhere, so a step with the same number of bands as the last pins nothing.
+ *          - A run which needs more workers than the pool has starts the rest, which then stay for later runs.
+ *          - The task is passed as a pointer and a function, so running one does not allocate.
+ *
+ *      - Each thread has a current pool, used by the step kernels.
+ *          - It is the pool of the innermost Workers::Use on the thread, such as the one Server::serve makes.
+ *          - Otherwise it is a pool of the thread's own, started the first time it is needed and stopped when
+ *            the thread exits, so a thread which steps many times starts its workers once.
+ *          - A process forked while a thread had a pool has none of its workers, so it starts a pool of its own.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+
+#include "workers.h"
+#include "topology.h"
+#include <memory>
+#include <unistd.h>
+
+// The pool of the innermost Workers::Use on this thread, if any
+static thread_local Workers::Pool *used = nullptr;
+
+/**
+ * Workers::Pool::Pool(workers)
+ *
+ * Construct a pool and start its workers, which wait until the pool is run.
+ *
+ * @example
+ *
+ *      // Start a worker for every core but the calling thread's
+ *      Workers::Pool pool(std::thread::hardware_concurrency() - 1);
+ *
+ * @param workers
+ *      Optional parameter. The number of workers to start now, more are started when a run needs them.
+ *      Defaults to 0.
+ */
+Workers::Pool::Pool(const unsigned int workers)
+		: call(nullptr), context(nullptr), tasks(0), first(1), pinned_for(0), remaining(0), round(0), stopping(false),
+		  process(static_cast<int>(getpid())) {
+	for (unsigned int index = 0; index < workers; index++) {
+		this->threads.emplace_back(&Pool::work, this, index);
+	}
+}
+
+/**
+ * Workers::Pool::~Pool()
+ *
+ * Stop and join every worker.
+ */
+Workers::Pool::~Pool() {
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->stopping = true;
+	}
+	this->wake.notify_all();
+	for (std::thread &thread : this->threads) {
+		thread.join();
+	}
+}
+
+/**
+ * The loop of one worker, taking task index + 1 of each run which has that many tasks, or task index if pinned.
+ * @param index - The worker, from 0.
+ */
+void Workers::Pool::work(const unsigned int index) {
+	std::uint64_t seen = 0;
+	unsigned int pinned = 0;
+	std::unique_lock<std::mutex> guard(this->lock);
+	while (true) {
+		this->wake.wait(guard, [this, seen]() {
+			return this->stopping || this->round != seen;
+		});
+		if (this->stopping) {
+			return;
+		}
+		seen = this->round;
+
+		const unsigned int task = index + this->first;
+		if (task >= this->tasks) {
+			continue;
+		}
+		void (*const call)(const void *, unsigned int) = this->call;
+		const void *const context = this->context;
+		const unsigned int pin = this->pinned_for;
+
+		guard.unlock();
+		if (pin != pinned) {
+			if (pin > 0) {
+				Topology::pin(Topology::cpu_for(task, pin));
+			} else {
+				Topology::unpin();
+			}
+			pinned = pin;
+		}
+		call(context, task);
+		guard.lock();
+
+		if (--this->remaining == 0) {
+			this->finished.notify_one();
+		}
+	}
+}
+
+/**
+ * Run a task function over the tasks of a run, the first on the calling thread unless pinned, and wait for the workers.
+ * @param tasks - The number of tasks.
+ * @param pinned - If true every task runs on a pinned worker.
+ * @param call - Called with the context and the index of each task.
+ * @param context - The task.
+ */
+void Workers::Pool::dispatch(const unsigned int tasks, const bool pinned,
+							 void (*const call)(const void *, unsigned int), const void *const context) {
+	if (tasks == 0) {
+		return;
+	}
+	if (tasks == 1 && !pinned) {
+		call(context, 0);
+		return;
+	}
+
+	const unsigned int first = pinned ? 0 : 1;
+	while (this->threads.size() < tasks - first) {
+		this->threads.emplace_back(&Pool::work, this, static_cast<unsigned int>(this->threads.size()));
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(this->lock);
+		this->call = call;
+		this->context = context;
+		this->tasks = tasks;
+		this->first = first;
+		this->pinned_for = pinned ? tasks : 0;
+		this->remaining = tasks - first;
+		this->round++;
+	}
+	this->wake.notify_all();
+
+	if (!pinned) {
+		call(context, 0);
+	}
+
+	std::unique_lock<std::mutex> guard(this->lock);
+	this->finished.wait(guard, [this]() {
+		return this->remaining == 0;
+	});
+}
+
+/**
+ * Workers::Pool::size()
+ *
+ * @return
+ *      The number of workers started, not counting the thread which runs the pool.
+ */
+unsigned int Workers::Pool::size() const {
+	return static_cast<unsigned int>(this->threads.size());
+}
+
+/**
+ * Workers::Pool::is_owned_by_this_process()
+ *
+ * @return
+ *      False in a process forked from the one which made the pool, where its workers do not exist.
+ */
+bool Workers::Pool::is_owned_by_this_process() const {
+	return this->process == static_cast<int>(getpid());
+}
+
+/**
+ * Workers::current()
+ *
+ * The pool the step kernels of the calling thread run their bands on.
+ *
+ * @example
+ *
+ *      // Step the bands of a grid on the calling thread's workers
+ *      Workers::current().run(bands, [&](const unsigned int band) {
+ *          step_band(band);
+ *      });
+ *
+ * @return
+ *      The pool of the innermost Workers::Use on this thread, or else the thread's own pool.
+ */
+Workers::Pool & Workers::current() {
+	if (used != nullptr && used->is_owned_by_this_process()) {
+		return *used;
+	}
+
+	// A pool copied by fork has no workers and may have been locked by one, so it is abandoned rather than freed
+	static thread_local std::unique_ptr<Pool> own;
+	if (!own || !own->is_owned_by_this_process()) {
+		own.release();
+		own.reset(new Pool());
+	}
+	return *own;
+}
+
+/**
+ * Workers::Use::Use(pool)
+ *
+ * Make a pool the calling thread's current pool until this goes out of scope.
+ *
+ * @param pool
+ *      The pool, which must outlive this.
+ */
+Workers::Use::Use(Pool &pool) : previous(used) {
+	used = &pool;
+}
+
+/**
+ * Workers::Use::~Use()
+ *
+ * Restore the calling thread's previous pool.
+ */
+Workers::Use::~Use() {
+	used = this->previous;
+}
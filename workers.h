@@ -0,0 +1,97 @@
+/**
+ * Declares a Workers namespace for pools of threads which are started once and run the bands of many steps.
+ * Rich documentation for the api and behaviour of the Workers namespace can be found in workers.cpp.
+ *
+ * @author **REMOVED**
+ * @date March, 2020
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Declare the interface of the Workers namespace for running the tasks of a step on threads kept between steps.
+ */
+namespace Workers {
+
+	/**
+	 * Threads which wait between runs, so a run of tasks neither starts threads nor allocates.
+	 * A pool runs one set of tasks at a time, for the thread which owns it.
+	 *
+	 * @example
+	 *
+	 *      Workers::Pool pool(8);
+	 *      pool.run(8, [&](const unsigned int task) {
+	 *          step_band(task);
+	 *      });
+	 */
+	class Pool {
+	private:
+		std::vector<std::thread> threads;
+		std::mutex lock;
+		std::condition_variable wake;
+		std::condition_variable finished;
+		void (*call)(const void *context, unsigned int task);
+		const void *context;
+		unsigned int tasks;
+		unsigned int first;
+		unsigned int pinned_for;
+		unsigned int remaining;
+		std::uint64_t round;
+		bool stopping;
+		int process;
+
+		void work(unsigned int index);
+		void dispatch(unsigned int tasks, bool pinned, void (*call)(const void *context, unsigned int task),
+					  const void *context);
+
+	public:
+		explicit Pool(unsigned int workers = 0);
+		~Pool();
+
+		Pool(const Pool &) = delete;
+		Pool & operator=(const Pool &) = delete;
+
+		unsigned int size() const;
+		bool is_owned_by_this_process() const;
+
+		/**
+		 * Run task(0) to task(tasks - 1), each on its own thread, and wait for them all.
+		 * If pinned, every task runs on a worker pinned to the cpu Topology::cpu_for(task, tasks) chooses.
+		 * Defined here so any callable can be run without wrapping it in a std::function.
+		 */
+		template <typename Task>
+		void run(const unsigned int tasks, const Task &task, const bool pinned = false) {
+			dispatch(tasks, pinned, [](const void *context, const unsigned int index) {
+				(*static_cast<const Task *>(context))(index);
+			}, &task);
+		}
+	};
+
+	Pool & current();
+
+	/**
+	 * Make a pool the current pool of the calling thread while in scope, restoring the previous one afterwards.
+	 *
+	 * @example
+	 *
+	 *      Workers::Pool pool(16);
+	 *      Workers::Use use(pool);
+	 *      BitWorld::step(current, next, false, 16);
+	 */
+	class Use {
+	private:
+		Pool *previous;
+
+	public:
+		explicit Use(Pool &pool);
+		~Use();
+
+		Use(const Use &) = delete;
+		Use & operator=(const Use &) = delete;
+	};
+};
@@ -1,7 +1,9 @@
 /**
  * Implements a class representing a 2d grid world for simulating a cellular automaton.
  *      - Worlds can be constructed empty, from a size, or from an existing Grid with an initial state for the world.
+ *          - A temporary Grid is moved into the world rather than copied.
  *      - Worlds can be resized.
+ *          - Both the current and next state grids are resized in place around a chosen anchor.
  *      - Worlds can return counts of the alive and dead cells in the current Grid state.
  *      - Worlds can return their current Grid state.
  *
@@ -14,6 +16,27 @@
  *      - Worlds have a private helper function used to count the number of alive cells in a 3x3 neighbours
  *        around a given cell.
  *
+ *      - Any grid or view can be stepped straight into another grid without constructing a World.
+ *          - One byte per cell grids are stepped a row at a time by summing columns.
+ *          - Bit-packed grids are stepped 64 cells at a time with bitwise adders.
+ *          - The rows can be split into bands stepped on several threads at once, by workers kept between steps.
+ *
+ *      - World is the one byte per cell instance of the BasicWorld template, BitWorld steps bit-packed grids.
+ *
+ *      - A World can be given a Statistics::History to record the population, births, deaths and wall time
+ *        of every step into.
+ *          - Without one nothing is counted or timed, so the only cost is a null check per step.
+ *          - The step kernels can fill in the same counts, counting 64 cells at a time after each band of rows.
+ *
+ *      - A World can be given a Changes::Set to record which tiles, rows and cells every step changed, so
+ *        renderers and recorders can skip the rest of the grid without comparing it.
+ *          - World::step and the step kernels note the changes of each row as soon as it is written,
+ *            64 cells at a time. While profiling, World::step_in_phases re-reads the rows in a pass of its own
+ *            so change tracking is measured as its own phase.
+ *
+ *      - While Profile is enabled, World::step runs its neighbour count, rule application and buffer swap as
+ *        separate passes so each can be measured as its own phase. The step kernels are measured as a whole.
+ *
  *      - Updating the world state can conditionally be performed using a toroidal topology.
  *          - Moving off the left edge you appear on the right edge and vice versa.
  *          - Moving off the top edge you appear on the bottom edge and vice versa.
@@ -22,6 +45,17 @@
  * @date March, 2020
  */
 #include "world.h"
+#include "profile.h"
+#include "topology.h"
+#include "workers.h"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 
 // Include the minimal number of headers needed to support your implementation.
@@ -38,7 +72,8 @@
  *      World world;
  *
  */
-World::World() : World(0) {}
+template <typename Storage>
+BasicWorld<Storage>::BasicWorld() : BasicWorld(0) {}
 
 /**
  * World::World(square_size)
@@ -59,7 +94,8 @@ World::World() : World(0) {}
  * @param square_size
  *      The edge size to use for the width and height of the world.
  */
-World::World(const int square_size) : World(square_size, square_size) {}
+template <typename Storage>
+BasicWorld<Storage>::BasicWorld(const int square_size) : BasicWorld(square_size, square_size) {}
 
 /**
  * World::World(width, height)
@@ -76,10 +112,31 @@ World::World(const int square_size) : World(square_size, square_size) {}
  * @param height
  *      The height of the world.
  */
-World::World(const int width, const int height) {
-	this->current_state = Grid(width, height);
-	this->next_state = Grid(width, height);
-}
+template <typename Storage>
+BasicWorld<Storage>::BasicWorld(const int width, const int height)
+	: BasicWorld(width, height, Memory::get_default_policy()) {}
+
+/**
+ * World::World(width, height, policy)
+ *
+ * Construct a world with the desired size filled with dead cells,
+ * with both grids allocated by a chosen policy instead of the default policy.
+ *
+ * @example
+ *
+ *      // Make a 65536x65536 world backed by transparent huge pages
+ *      World world(65536, 65536, Memory::Policy::HUGE_PAGES);
+ *
+ * @param width
+ *      The width of the world.
+ * @param height
+ *      The height of the world.
+ * @param policy
+ *      Where to allocate the cells of both grids from.
+ */
+template <typename Storage>
+BasicWorld<Storage>::BasicWorld(const int width, const int height, const Memory::Policy policy)
+	: current_state(width, height, policy), next_state(width, height, policy) {}
 
 /**
  * World::World(initial_state)
@@ -98,12 +155,36 @@ World::World(const int width, const int height) {
  *      World bad_world = grid; // All around me are familiar faces...
  *
  * @param initial_state
+ *      The state of the constructed world. Both grids use the same allocation policy as the initial state.
+ */
+template <typename Storage>
+BasicWorld<Storage>::BasicWorld(const BasicGrid<Storage> &initial_state)
+	: current_state(initial_state),
+	  next_state(initial_state.get_width(), initial_state.get_height(), initial_state.get_policy()) {}
+
+/**
+ * World::World(initial_state)
+ *
+ * Construct a world by taking over the cells of a grid which is no longer needed, without copying them.
+ * The next state buffer is drawn from the same allocation policy, which for the default pool
+ * is usually a recycled buffer.
+ *
+ * @example
+ *
+ *      // Load a grid and hand it straight to a world
+ *      World world(Zoo::load_binary("path/to/file.bgol"));
+ *
+ *      // Or hand over a named grid, which is left empty
+ *      Grid grid = Zoo::load_ascii("path/to/file.gol");
+ *      World other(std::move(grid));
+ *
+ * @param initial_state
  *      The state of the constructed world.
  */
-World::World(const Grid &initial_state) {
-	this->current_state = initial_state;
-	this->next_state = Grid(this->current_state.get_width(), this->current_state.get_height());
-}
+template <typename Storage>
+BasicWorld<Storage>::BasicWorld(BasicGrid<Storage> &&initial_state)
+	: current_state(std::move(initial_state)),
+	  next_state(current_state.get_width(), current_state.get_height(), current_state.get_policy()) {}
 
 /**
  * World::get_width()
@@ -128,7 +209,8 @@ World::World(const Grid &initial_state) {
  * @return
  *      The width of the world.
  */
-unsigned int World::get_width() const {
+template <typename Storage>
+unsigned int BasicWorld<Storage>::get_width() const {
 	return current_state.get_width();
 }
 
@@ -155,7 +237,8 @@ unsigned int World::get_width() const {
  * @return
  *      The height of the world.
  */
-unsigned int World::get_height() const {
+template <typename Storage>
+unsigned int BasicWorld<Storage>::get_height() const {
 	return current_state.get_height();
 }
 
@@ -182,7 +265,8 @@ unsigned int World::get_height() const {
  * @return
  *      The number of total cells.
  */
-unsigned int World::get_total_cells() const {
+template <typename Storage>
+unsigned int BasicWorld<Storage>::get_total_cells() const {
 	return current_state.get_total_cells();
 }
 
@@ -209,7 +293,8 @@ unsigned int World::get_total_cells() const {
  * @return
  *      The number of alive cells.
  */
-unsigned int World::get_alive_cells() const {
+template <typename Storage>
+unsigned int BasicWorld<Storage>::get_alive_cells() const {
 	return current_state.get_alive_cells();
 }
 
@@ -236,7 +321,8 @@ unsigned int World::get_alive_cells() const {
  * @return
  *      The number of dead cells.
  */
-unsigned int World::get_dead_cells() const {
+template <typename Storage>
+unsigned int BasicWorld<Storage>::get_dead_cells() const {
 	return current_state.get_dead_cells();
 }
 
@@ -264,7 +350,8 @@ unsigned int World::get_dead_cells() const {
  * @return
  *      A reference to the current state.
  */
-const Grid& World::get_state() const {
+template <typename Storage>
+const BasicGrid<Storage>& BasicWorld<Storage>::get_state() const {
 	return current_state;
 }
 
@@ -287,7 +374,8 @@ const Grid& World::get_state() const {
  * @param square_size
  *      The new edge size for both the width and height of the grid.
  */
-void World::resize(const int square_size) {
+template <typename Storage>
+void BasicWorld<Storage>::resize(const int square_size) {
 	resize(square_size, square_size);
 }
 
@@ -313,8 +401,96 @@ void World::resize(const int square_size) {
  * @param new_height
  *      The new height for the grid.
  */
-void World::resize(const int new_width, const int new_height) {
-	current_state.resize(new_width, new_height);
+template <typename Storage>
+void BasicWorld<Storage>::resize(const int new_width, const int new_height) {
+	resize(new_width, new_height, 0, 0);
+}
+
+/**
+ * World::resize(new_width, new_height, anchor)
+ *
+ * Resize the current state grid in to the new width and height, keeping the content pinned to a chosen anchor.
+ * See Grid::resize(width, height, anchor).
+ *
+ * @example
+ *
+ *      // Make a world
+ *      World world(4, 4);
+ *
+ *      // Grow the world to 8x8 with the original 4x4 in the middle
+ *      world.resize(8, 8, Anchor::CENTRE);
+ *
+ * @param new_width
+ *      The new width for the grid.
+ *
+ * @param new_height
+ *      The new height for the grid.
+ *
+ * @param anchor
+ *      The point of the world which stays fixed.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::resize(const int new_width, const int new_height, const Anchor anchor) {
+	current_state.resize(new_width, new_height, anchor);
+	resize_next_state();
+}
+
+/**
+ * World::resize(new_width, new_height, x_offset, y_offset)
+ *
+ * Resize the current state grid in to the new width and height, moving the old content so its top left corner
+ * lands on x_offset, y_offset. See Grid::resize(width, height, x_offset, y_offset).
+ *
+ * Both grids are resized in place so capacity reserved with World::reserve(cells) is reused.
+ *
+ * @param new_width
+ *      The new width for the grid.
+ *
+ * @param new_height
+ *      The new height for the grid.
+ *
+ * @param x_offset
+ *      Where the old left edge lands in the resized world.
+ *
+ * @param y_offset
+ *      Where the old top edge lands in the resized world.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::resize(const int new_width, const int new_height, const int x_offset, const int y_offset) {
+	current_state.resize(new_width, new_height, x_offset, y_offset);
+	resize_next_state();
+}
+
+/**
+ * World::reserve(cells)
+ *
+ * Reserve storage in both grids for at least the given number of cells,
+ * so the world can later grow up to that many cells without allocating.
+ *
+ * @example
+ *
+ *      // Make a world which is expected to grow to 4096x4096
+ *      World world(256);
+ *      world.reserve(4096 * 4096);
+ *
+ * @param cells
+ *      The number of cells to make room for.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::reserve(const std::size_t cells) {
+	current_state.reserve(cells);
+	next_state.reserve(cells);
+}
+
+/**
+ * Match the size of the next state grid to the current state grid.
+ * The old values in the next state do not need to be preserved, so the grid is emptied first
+ * which skips moving its rows but keeps its capacity.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::resize_next_state() {
+	next_state.resize(0, 0);
+	next_state.resize(current_state.get_width(), current_state.get_height());
 }
 
 /**
@@ -348,7 +524,8 @@ void World::resize(const int new_width, const int new_height) {
  * @return
  *      Returns the number of alive neighbours.
  */
-unsigned int World::count_neighbours(const int x, const int y, const bool toroidal) {
+template <typename Storage>
+unsigned int BasicWorld<Storage>::count_neighbours(const int x, const int y, const bool toroidal) {
 
 	unsigned int alive_cell_count = 0;
 	int height = this->current_state.get_height();
@@ -356,7 +533,7 @@ unsigned int World::count_neighbours(const int x, const int y, const bool toroid
 
 	if (toroidal) {
 		alive_cell_count = 	is_alive(((x - 1) + width) % width, ((y - 1) + height) % height) + // top left
-							is_alive(x, ((y - 1) + height) % width) + // top
+							is_alive(x, ((y - 1) + height) % height) + // top
 							is_alive(((x + 1) + width) % width, ((y - 1) + height) % height) + // top right
 							is_alive(((x - 1) + width) % width, y) + // middle left
 							// Don't count middle square
@@ -418,10 +595,122 @@ unsigned int World::count_neighbours(const int x, const int y, const bool toroid
  * @param y - The y coordinate.
  * @return boolean - True if cell alive, false otherwise.
  */
-bool World::is_alive(const int x, const int y) {
+template <typename Storage>
+bool BasicWorld<Storage>::is_alive(const int x, const int y) {
 	return this->current_state.get(x, y) == Cell::ALIVE;
 }
 
+/**
+ * World::set_statistics(history)
+ *
+ * Record the counts and wall time of every following step into a history, or stop recording.
+ * The history is not owned by the world and must outlive it, or be unset first.
+ *
+ * @example
+ *
+ *      // Record the last 256 generations and save them as CSV
+ *      Statistics::History history(256);
+ *      World world(Zoo::load_ascii("path/to/file.gol"));
+ *      world.set_statistics(&history);
+ *      world.advance(1000);
+ *      Statistics::save("path/to/stats.csv", history);
+ *
+ * @param history
+ *      The history to record into, or nullptr to stop recording.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::set_statistics(Statistics::History *history) {
+	this->statistics = history;
+}
+
+/**
+ * World::get_statistics()
+ *
+ * @return
+ *      The history steps are being recorded into, or nullptr if they are not.
+ */
+template <typename Storage>
+Statistics::History * BasicWorld<Storage>::get_statistics() const {
+	return this->statistics;
+}
+
+/**
+ * World::set_publisher(publisher)
+ *
+ * Publish the current state into shared memory now and after every following step, or stop publishing.
+ * The publisher is not owned by the world and must outlive it, or be unset first.
+ * Only the member World::step(toroidal) publishes, callers of the static step kernels publish themselves.
+ *
+ * @example
+ *
+ *      // Let viewers in other processes map /dev/shm/gol while the world runs
+ *      World world(Zoo::load_ascii("path/to/file.gol"));
+ *      Shared::Publisher publisher("/gol", world.get_width(), world.get_height());
+ *      world.set_publisher(&publisher);
+ *      world.advance(1000);
+ *
+ * @param publisher
+ *      The publisher to publish through, or nullptr to stop publishing.
+ *
+ * @throws
+ *      std::runtime_error if the world is larger than the publisher's segment.
+ *      Steps of a world resized beyond the segment throw the same.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::set_publisher(Shared::Publisher *publisher) {
+	this->publisher = publisher;
+	if (this->publisher != nullptr) {
+		this->publisher->publish(BasicGridView<Storage>(this->current_state));
+	}
+}
+
+/**
+ * World::get_publisher()
+ *
+ * @return
+ *      The publisher steps are being published through, or nullptr if they are not.
+ */
+template <typename Storage>
+Shared::Publisher * BasicWorld<Storage>::get_publisher() const {
+	return this->publisher;
+}
+
+/**
+ * World::set_changes(changes)
+ *
+ * Record which tiles, rows and cells each following step changes into a change set, or stop recording.
+ * The set only holds the changes of the latest step. It is not owned by the world and must outlive it, or be unset first.
+ *
+ * @example
+ *
+ *      // Print only the cells each step changed
+ *      World world(Zoo::load_ascii("path/to/file.gol"));
+ *      Changes::Set changes;
+ *      world.set_changes(&changes);
+ *      world.step();
+ *      for (const Changes::Point &cell : changes.get_born()) {
+ *          std::cout << cell.x << ", " << cell.y << " born" << std::endl;
+ *      }
+ *
+ * @param changes
+ *      The change set to record into, or nullptr to stop recording.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::set_changes(Changes::Set *changes) {
+	this->changes = changes;
+}
+
+/**
+ * World::get_changes()
+ *
+ * @return
+ *      The change set steps are being recorded into, or nullptr if they are not.
+ */
+template <typename Storage>
+Changes::Set * BasicWorld<Storage>::get_changes() const {
+	return this->changes;
+}
+
 /**
  * World::step(toroidal)
  *
@@ -429,6 +718,10 @@ bool World::is_alive(const int x, const int y) {
  *
  * Reads from the current state grid and writes to the next state grid. Then swaps the grids.
  * Should be implemented by invoking World::count_neighbours(x, y, toroidal).
+ * If a statistics history is set, the births, deaths, population and wall time of the step are recorded into it.
+ * If a change set is set, the tiles, rows and cells the step changed are recorded into it before the swap.
+ * If a publisher is set, the new current state is published into shared memory once the grids are swapped.
+ * If profiling is enabled the step is taken in separate measured phases instead, see World::step_in_phases(toroidal).
  * Swapping the grids should be done in O(1) constant time, and should not invoke a copy.
  * Try and boil the logic down to the fewest and most simple conditional statements.
  *
@@ -442,10 +735,25 @@ bool World::is_alive(const int x, const int y) {
  *      Optional parameter. If true then the step will consider the grid as a torus, where the left edge
  *      wraps to the right edge and the top to the bottom. Defaults to false.
  */
-void World::step(const bool toroidal) {
+template <typename Storage>
+void BasicWorld<Storage>::step(const bool toroidal) {
+	if (Profile::enabled()) {
+		step_in_phases(toroidal);
+		return;
+	}
+
+	const bool counting = this->statistics != nullptr;
+	const auto start = counting ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	Statistics::Generation counts;
+
+	// Rows are stepped in order, so each is noted in the change set as soon as it is written while still in cache
+	if (this->changes != nullptr) {
+		this->changes->reset(this->current_state.get_width(), this->current_state.get_height());
+	}
+
 	unsigned int neighbours;
-	for (int i = 0; i < this->current_state.get_width(); i++) {
-		for (int j = 0; j < this->current_state.get_height(); j++) {
+	for (int j = 0; j < this->current_state.get_height(); j++) {
+		for (int i = 0; i < this->current_state.get_width(); i++) {
 			neighbours = count_neighbours(i,j, toroidal);
 
 			if (neighbours == 2) {
@@ -455,10 +763,110 @@ void World::step(const bool toroidal) {
 			} else {
 				this->next_state.set(i, j, Cell::DEAD);
 			}
+
+			if (counting) {
+				const bool was_alive = this->current_state.get(i, j) == Cell::ALIVE;
+				const bool now_alive = this->next_state.get(i, j) == Cell::ALIVE;
+				counts.population += now_alive;
+				counts.births += now_alive && !was_alive;
+				counts.deaths += was_alive && !now_alive;
+			}
+		}
+
+		if (this->changes != nullptr) {
+			this->changes->template record_row<Storage>(j, this->current_state.row(j), this->next_state.row(j));
 		}
 	}
 
 	std::swap(this->current_state, this->next_state);
+
+	if (counting) {
+		counts.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		this->statistics->record(counts);
+	}
+
+	if (this->publisher != nullptr) {
+		this->publisher->publish(BasicGridView<Storage>(this->current_state));
+	}
+}
+
+/**
+ * World::step_in_phases(toroidal)
+ *
+ * Take one step as World::step(toroidal) does, but as three passes each measured as a Profile phase.
+ *      - "World::step neighbour count" counts the neighbours of every cell into a buffer.
+ *      - "World::step rule application" writes the next state from the counts, and counts births and deaths
+ *        if a statistics history is set.
+ *      - "World::step change tracking" records the changes of the step, if a change set is set, re-reading
+ *        both grids rather than noting each row as it is written as World::step does.
+ *      - "World::step buffer swap" swaps the current and next state grids.
+ *      - "World::step publish" publishes the new current state, if a publisher is set.
+ *
+ * Splitting the loop costs a buffer of one count per cell, so it is only done while profiling.
+ *
+ * @param toroidal
+ *      If true then the step will consider the grid as a torus, where the left edge
+ *      wraps to the right edge and the top to the bottom.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::step_in_phases(const bool toroidal) {
+	const bool counting = this->statistics != nullptr;
+	const auto start = counting ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	Statistics::Generation counts;
+
+	const int width = this->current_state.get_width();
+	const int height = this->current_state.get_height();
+	std::vector<unsigned char> neighbours(static_cast<std::size_t>(width) * height);
+
+	{
+		Profile::Scope scope("World::step neighbour count");
+		for (int i = 0; i < width; i++) {
+			for (int j = 0; j < height; j++) {
+				neighbours[static_cast<std::size_t>(j) * width + i] = count_neighbours(i, j, toroidal);
+			}
+		}
+	}
+
+	{
+		Profile::Scope scope("World::step rule application");
+		for (int i = 0; i < width; i++) {
+			for (int j = 0; j < height; j++) {
+				const unsigned char count = neighbours[static_cast<std::size_t>(j) * width + i];
+				const bool was_alive = this->current_state.get(i, j) == Cell::ALIVE;
+				const bool now_alive = count == 3 || (count == 2 && was_alive);
+				this->next_state.set(i, j, now_alive ? Cell::ALIVE : Cell::DEAD);
+
+				if (counting) {
+					counts.population += now_alive;
+					counts.births += now_alive && !was_alive;
+					counts.deaths += was_alive && !now_alive;
+				}
+			}
+		}
+	}
+
+	if (this->changes != nullptr) {
+		Profile::Scope scope("World::step change tracking");
+		this->changes->reset(width, height);
+		for (int j = 0; j < height; j++) {
+			this->changes->template record_row<Storage>(j, this->current_state.row(j), this->next_state.row(j));
+		}
+	}
+
+	{
+		Profile::Scope scope("World::step buffer swap");
+		std::swap(this->current_state, this->next_state);
+	}
+
+	if (counting) {
+		counts.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		this->statistics->record(counts);
+	}
+
+	if (this->publisher != nullptr) {
+		Profile::Scope scope("World::step publish");
+		this->publisher->publish(BasicGridView<Storage>(this->current_state));
+	}
 }
 
 /**
@@ -474,8 +882,624 @@ void World::step(const bool toroidal) {
  *      Optional parameter. If true then the step will consider the grid as a torus, where the left edge
  *      wraps to the right edge and the top to the bottom. Defaults to false.
  */
-void World::advance(const int steps, const bool toroidal) {
+template <typename Storage>
+void BasicWorld<Storage>::advance(const int steps, const bool toroidal) {
 	for (int i = 0; i < steps; i ++) {
 		step(toroidal);
 	}
 }
+
+/**
+ * World::crop_ahead(x0, y0, x1, y1, generations, toroidal)
+ *
+ * Get what a window of the world will look like after a number of generations, without advancing the world.
+ * See World::crop_ahead(source, x0, y0, x1, y1, generations, toroidal, threads).
+ *
+ * @example
+ *
+ *      // What will the 8x8 in the top left corner look like in 100 generations?
+ *      World world(Zoo::load_ascii("path/to/file.gol"));
+ *      Grid corner = world.crop_ahead(0, 0, 8, 8, 100);
+ *
+ * @param x0
+ *      Left coordinate of the window on x-axis.
+ *
+ * @param y0
+ *      Top coordinate of the window on y-axis.
+ *
+ * @param x1
+ *      Right coordinate of the window on x-axis (1 greater than the largest index).
+ *
+ * @param y1
+ *      Bottom coordinate of the window on y-axis (1 greater than the largest index).
+ *
+ * @param generations
+ *      The number of generations ahead to look. 0 or fewer crops the current state.
+ *
+ * @param toroidal
+ *      Optional parameter. If true then the world is a torus, as for World::step(toroidal). Defaults to false.
+ *
+ * @return
+ *      A new grid the size of the window holding its cells after the given number of generations.
+ *
+ * @throws
+ *      std::exception or sub-class if the window is not within the world, as for Grid::crop(x0, y0, x1, y1).
+ */
+template <typename Storage>
+BasicGrid<Storage> BasicWorld<Storage>::crop_ahead(const int x0, const int y0, const int x1, const int y1,
+												   const int generations, const bool toroidal) const {
+	return crop_ahead(this->current_state, x0, y0, x1, y1, generations, toroidal);
+}
+
+/**
+ * World::crop_ahead(source, x0, y0, x1, y1, generations, toroidal, threads)
+ *
+ * Get what a window of a grid will look like after a number of generations, stepping only the cells which
+ * can affect it. A cell only depends on its neighbours a generation before, so the window after N generations
+ * only depends on the window grown by N cells on every side at the start, its backward light cone.
+ *      - The cone is copied out of the grid, clipped to its edges unless toroidal, and stepped as a bounded grid.
+ *      - The cells on the cut edges of the cone are wrong after each step, since their outside neighbours were
+ *        left out, so the cone is cropped by a cell on every cut edge after each generation and shrinks to
+ *        exactly the window at the end. Edges which are the grid's own stay, as a bounded step would.
+ *      - When toroidal the cone wraps, and may be copied with rows or columns repeated if it is wider or
+ *        taller than the grid. If the cone is not smaller than the whole grid it is cheaper to step the whole
+ *        grid, so that is done instead.
+ *
+ * So a small window costs about its cone, roughly (w + 2N)(h + 2N) cells a generation at most,
+ * instead of the whole grid every generation.
+ *
+ * @example
+ *
+ *      // The centre 16x16 of a large soup after 64 generations, stepping about a 144x144 cone
+ *      BitGrid soup(Zoo::load_ascii("path/to/soup.gol"));
+ *      BitGrid centre = BitWorld::crop_ahead(soup, 2040, 2040, 2056, 2056, 64);
+ *
+ * @param source
+ *      The grid at generation 0.
+ *
+ * @param x0
+ *      Left coordinate of the window on x-axis.
+ *
+ * @param y0
+ *      Top coordinate of the window on y-axis.
+ *
+ * @param x1
+ *      Right coordinate of the window on x-axis (1 greater than the largest index).
+ *
+ * @param y1
+ *      Bottom coordinate of the window on y-axis (1 greater than the largest index).
+ *
+ * @param generations
+ *      The number of generations ahead to look. 0 or fewer crops the source.
+ *
+ * @param toroidal
+ *      Optional parameter. If true then the grid is a torus, as for World::step(toroidal). Defaults to false.
+ *
+ * @param threads
+ *      Optional parameter. The number of threads to step the cone with, 0 uses every core. Defaults to 1.
+ *
+ * @return
+ *      A new grid the size of the window holding its cells after the given number of generations.
+ *
+ * @throws
+ *      std::exception or sub-class if the window is not within the grid, as for Grid::crop(x0, y0, x1, y1).
+ */
+template <typename Storage>
+BasicGrid<Storage> BasicWorld<Storage>::crop_ahead(const BasicGridView<Storage> &source, const int x0, const int y0,
+												   const int x1, const int y1, const int generations,
+												   const bool toroidal, const unsigned int threads) {
+	const BasicGridView<Storage> window = source.crop(x0, y0, x1, y1);
+	if (generations <= 0) {
+		return window.materialize();
+	}
+
+	const std::int64_t width = source.get_width();
+	const std::int64_t height = source.get_height();
+
+	// The cone a number of generations before the window, clipped to the grid unless it wraps
+	struct Cone {
+		std::int64_t x0, y0, x1, y1;
+	};
+	auto cone = [&](const std::int64_t margin) {
+		Cone region = {x0 - margin, y0 - margin, x1 + margin, y1 + margin};
+		if (!toroidal) {
+			region = {std::max<std::int64_t>(region.x0, 0), std::max<std::int64_t>(region.y0, 0),
+					  std::min(region.x1, width), std::min(region.y1, height)};
+		}
+		return region;
+	};
+
+	Cone previous = cone(generations);
+	if (toroidal && static_cast<double>(previous.x1 - previous.x0) * (previous.y1 - previous.y0) >= static_cast<double>(width * height)) {
+		BasicGrid<Storage> current = source.materialize(), next;
+		for (int generation = 0; generation < generations; generation++) {
+			step(current, next, true, threads);
+			std::swap(current, next);
+		}
+		return current.crop(x0, y0, x1, y1);
+	}
+
+	// Copy the cone out a run at a time, wrapping around the grid where it crosses an edge
+	BasicGrid<Storage> current(static_cast<int>(previous.x1 - previous.x0), static_cast<int>(previous.y1 - previous.y0));
+	for (std::int64_t y = previous.y0; y < previous.y1; y++) {
+		const typename Storage::Word *row = source.row(static_cast<int>(((y % height) + height) % height));
+		for (std::int64_t x = previous.x0; x < previous.x1;) {
+			const std::int64_t from = ((x % width) + width) % width;
+			const std::int64_t count = std::min(width - from, previous.x1 - x);
+			Storage::move(current.row(static_cast<int>(y - previous.y0)), static_cast<int>(x - previous.x0),
+						  row, source.get_offset() + static_cast<int>(from), static_cast<int>(count));
+			x += count;
+		}
+	}
+
+	BasicGrid<Storage> next;
+	BasicGridView<Storage> view(current);
+	for (int generation = 0; generation < generations; generation++) {
+		step(view, next, false, threads);
+		std::swap(current, next);
+
+		const Cone region = cone(generations - generation - 1);
+		view = current.crop_view(static_cast<int>(region.x0 - previous.x0), static_cast<int>(region.y0 - previous.y0),
+								 static_cast<int>(region.x1 - previous.x0), static_cast<int>(region.y1 - previous.y0));
+		previous = region;
+	}
+	return view.materialize();
+}
+
+// Bands are never shorter than this, so small grids are not split into slivers which cost more to start than to step
+static const int min_band_rows = 64;
+
+/**
+ * The number of bands the rows of a step are split into, one per thread asked for unless that makes them too short.
+ * @param height - The number of rows.
+ * @param threads - The number of threads asked for, 0 for every core.
+ * @return The number of bands, at least 1.
+ */
+static int count_bands(const int height, unsigned int threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	return std::max(1, std::min<int>(threads, height / min_band_rows));
+}
+
+/**
+ * Split the rows of a step into bands and step each band on its own thread, the first on the calling thread.
+ * The other bands run on the workers of the calling thread's Workers::current() pool, which are kept between
+ * steps, so a step starts no threads once the pool has grown to fit.
+ * If placement is enabled every band runs on a worker pinned to the cpu Topology::cpu_for(band, bands) chooses,
+ * including the first, so the calling thread is never pinned, and the band of a row is the same every step.
+ * Workers stay pinned between steps, so only a step with a different number of bands pins them again.
+ * @param height - The number of rows.
+ * @param threads - The number of threads to use, 0 uses every core.
+ * @param band - Called with the first row and one past the last row of each band.
+ */
+template <typename Band>
+static void step_bands(const int height, const unsigned int threads, const Band &band) {
+	const int bands = count_bands(height, threads);
+	if (bands == 1) {
+		band(0, height);
+		return;
+	}
+
+	Workers::current().run(bands, [&band, height, bands](const unsigned int task) {
+		const int b = static_cast<int>(task);
+		band((height * b) / bands, (height * (b + 1)) / bands);
+	}, Topology::enabled());
+}
+
+/**
+ * Add the population, births and deaths of one stepped row to a band's counts, 64 cells at a time.
+ * @param before - The row before the step.
+ * @param after - The row after the step.
+ * @param width - The number of cells in each row.
+ * @param counts - The counts to add to.
+ */
+template <typename Storage>
+static void count_row(const typename Storage::Word *before, const typename Storage::Word *after, const int width,
+					  Statistics::Generation &counts) {
+	for (int x = 0; x < width; x += 64) {
+		const int count = std::min(64, width - x);
+		const std::uint64_t was_alive = Storage::load(before, x, count);
+		const std::uint64_t now_alive = Storage::load(after, x, count);
+		counts.population += std::bitset<64>(now_alive).count();
+		counts.births += std::bitset<64>(now_alive & ~was_alive).count();
+		counts.deaths += std::bitset<64>(was_alive & ~now_alive).count();
+	}
+}
+
+/**
+ * Add one band's counts to the counts of the whole step.
+ * @param band - The counts of the band.
+ * @param counts - The counts of the step, or nullptr if the step is not being counted.
+ * @param lock - Guards the counts of the step against the other bands.
+ */
+static void add_counts(const Statistics::Generation &band, Statistics::Generation *counts, std::mutex &lock) {
+	if (counts) {
+		std::lock_guard<std::mutex> guard(lock);
+		counts->population += band.population;
+		counts->births += band.births;
+		counts->deaths += band.deaths;
+	}
+}
+
+/**
+ * Choose the change set a band of rows records into.
+ * A band of every row records straight into the step's set, any other records into one of its own to be merged.
+ * @param first - The first row of the band.
+ * @param end - One past the last row of the band.
+ * @param height - The number of rows of the step.
+ * @param own - The band's own set, reset to the step's size if it is used.
+ * @param changes - The change set of the step, already reset, or nullptr if the step is not being tracked.
+ * @return The set to record into, or nullptr if the step is not being tracked.
+ */
+static Changes::Set * band_changes(const int first, const int end, const int height, Changes::Set &own,
+								   Changes::Set *changes) {
+	if (!changes || (first == 0 && end == height)) {
+		return changes;
+	}
+	own = Changes::Set(changes->get_tile_size(), changes->is_listing_cells());
+	own.reset(changes->get_width(), changes->get_height());
+	return &own;
+}
+
+/**
+ * Merge the changes of one band into the change set of the whole step, unless the band recorded into it directly.
+ * @param band - The set the band recorded into.
+ * @param changes - The change set of the step, or nullptr if the step is not being tracked.
+ * @param lock - Guards the change set of the step against the other bands.
+ */
+static void merge_changes(const Changes::Set *band, Changes::Set *changes, std::mutex &lock) {
+	if (band && band != changes) {
+		std::lock_guard<std::mutex> guard(lock);
+		changes->merge(*band);
+	}
+}
+
+/**
+ * Compute the next state of one row from the rows above and below it.
+ * Each cell is alive if its lowest bit is set, so the 3 rows are summed column by column
+ * into column_sums and each neighbourhood is then 3 adjacent column sums minus the centre cell.
+ *
+ * @param above - The row above, or nullptr if it is outside a non-toroidal grid.
+ * @param middle - The row being updated.
+ * @param below - The row below, or nullptr if it is outside a non-toroidal grid.
+ * @param out - Where to write the next state of the row.
+ * @param width - The number of cells in each row.
+ * @param toroidal - True to wrap the left and right edges around.
+ * @param column_sums - Scratch space for (width + 2) sums.
+ */
+static void step_row(const Cell *above, const Cell *middle, const Cell *below, Cell *out,
+					 const int width, const bool toroidal, unsigned char *column_sums) {
+	unsigned char *sums = column_sums + 1;
+	for (int x = 0; x < width; x++) {
+		sums[x] = middle[x] & 1;
+	}
+	if (above) {
+		for (int x = 0; x < width; x++) {
+			sums[x] += above[x] & 1;
+		}
+	}
+	if (below) {
+		for (int x = 0; x < width; x++) {
+			sums[x] += below[x] & 1;
+		}
+	}
+	sums[-1] = toroidal ? sums[width - 1] : 0;
+	sums[width] = toroidal ? sums[0] : 0;
+
+	for (int x = 0; x < width; x++) {
+		const bool alive = middle[x] & 1;
+		const unsigned int neighbours = sums[x - 1] + sums[x] + sums[x + 1] - alive;
+		out[x] = (neighbours == 3 || (neighbours == 2 && alive)) ? Cell::ALIVE : Cell::DEAD;
+	}
+}
+
+/**
+ * World::step(source, destination, toroidal, threads)
+ *
+ * Take one step in Conway's Game of Life from any grid or view into another grid, without a World.
+ * The source is read in place, so a window of a larger grid can be stepped without copying it first.
+ * The destination is resized to the size of the source if needed and must not overlap it.
+ *
+ * Cells outside a non-toroidal source are considered dead, even if the source is a view inside a larger grid.
+ *
+ * Each row only reads the source and writes its own destination row, so bands of rows can be stepped
+ * on separate threads with no locking. Bands are at least 64 rows tall.
+ *
+ * @example
+ *
+ *      // Step the top left 16x16 corner of a grid on its own
+ *      Grid next;
+ *      World::step(grid.crop_view(0, 0, 16, 16), next);
+ *
+ *      // Step a large grid on every core
+ *      World::step(grid, next, false, 0);
+ *
+ * @param source
+ *      The grid or view to read the current state from.
+ *
+ * @param destination
+ *      The grid to write the next state to.
+ *
+ * @param toroidal
+ *      Optional parameter. If true then the step will consider the source as a torus, where the left edge
+ *      wraps to the right edge and the top to the bottom. Defaults to false.
+ *
+ * @param threads
+ *      Optional parameter. The number of threads to step with. Defaults to 1, 0 uses every core.
+ *
+ * @param counts
+ *      Optional parameter. If given, its population, births and deaths are set to those of the step.
+ *      Its generation and seconds are left for the caller. Defaults to nullptr, counting nothing.
+ *
+ * @param changes
+ *      Optional parameter. If given, it is reset to the size of the source and the tiles, rows and cells
+ *      the step changed are recorded into it. Defaults to nullptr, tracking nothing.
+ */
+template <>
+void BasicWorld<ByteCells>::step(const GridView &source, Grid &destination, const bool toroidal,
+								 const unsigned int threads, Statistics::Generation *counts, Changes::Set *changes) {
+	Profile::Scope scope("World::step kernel");
+	const int width = source.get_width();
+	const int height = source.get_height();
+
+	if (destination.get_width() != width || destination.get_height() != height) {
+		destination = Grid(width, height);
+		place(destination, threads);
+	}
+	if (counts) {
+		counts->population = counts->births = counts->deaths = 0;
+	}
+	if (changes) {
+		changes->reset(width, height);
+	}
+	if (width == 0 || height == 0) {
+		return;
+	}
+
+	std::mutex lock;
+	step_bands(height, threads, [&](const int first, const int end) {
+		std::vector<unsigned char> column_sums(width + 2);
+		Statistics::Generation band;
+		Changes::Set own;
+		Changes::Set *tracking = band_changes(first, end, height, own, changes);
+		for (int y = first; y < end; y++) {
+			const Cell *above = y > 0 ? source.row(y - 1) : (toroidal ? source.row(height - 1) : nullptr);
+			const Cell *below = y < height - 1 ? source.row(y + 1) : (toroidal ? source.row(0) : nullptr);
+			step_row(above, source.row(y), below, destination.row(y), width, toroidal, column_sums.data());
+			if (counts) {
+				count_row<ByteCells>(source.row(y), destination.row(y), width, band);
+			}
+			if (tracking) {
+				tracking->record_row<ByteCells>(y, source.row(y), destination.row(y));
+			}
+		}
+		add_counts(band, counts, lock);
+		merge_changes(tracking, changes, lock);
+	});
+}
+
+/**
+ * Add three words bit by bit, as 64 independent full adders.
+ * @param a - The first word.
+ * @param b - The second word.
+ * @param c - The third word.
+ * @param sum - Set to the low bit of each sum.
+ * @param carry - Set to the high bit of each sum.
+ */
+static void add_bits(const std::uint64_t a, const std::uint64_t b, const std::uint64_t c,
+					 std::uint64_t &sum, std::uint64_t &carry) {
+	sum = a ^ b ^ c;
+	carry = (a & b) | (c & (a ^ b));
+}
+
+/**
+ * Compute the next state of one bit-packed row from the rows above and below it, 64 cells at a time.
+ *
+ * For each word of the row, the 8 neighbours of all 64 cells are lined up as 8 words by taking the words above,
+ * below and beside it shifted by one cell, pulling in the edge cell of the next word over. The 8 words are summed
+ * by a tree of bitwise adders into a 3 bit count per cell. A count of 8 wraps to 0, which dies either way.
+ *
+ * @param above - The row above, or nullptr if it is outside a non-toroidal grid.
+ * @param middle - The row being updated.
+ * @param below - The row below, or nullptr if it is outside a non-toroidal grid.
+ * @param out - Where to write the next state of the row.
+ * @param width - The number of cells in each row.
+ * @param toroidal - True to wrap the left and right edges around.
+ */
+static void step_bit_row(const std::uint64_t *above, const std::uint64_t *middle, const std::uint64_t *below,
+						 std::uint64_t *out, const int width, const bool toroidal) {
+	const int words = (width + 63) / 64;
+	const int last = (width - 1) & 63;
+	const std::uint64_t last_mask = (width & 63) == 0 ? ~std::uint64_t(0) : (std::uint64_t(1) << (width & 63)) - 1;
+
+	// Cells past the width may belong to a larger grid this row is a view of, so they are masked off
+	auto word = [&](const std::uint64_t *row, const int i) -> std::uint64_t {
+		if (!row) {
+			return 0;
+		}
+		return i == words - 1 ? row[i] & last_mask : row[i];
+	};
+	// Each word shifted so every cell holds its west or east neighbour
+	auto west = [&](const std::uint64_t *row, const int i) -> std::uint64_t {
+		const std::uint64_t carry = i > 0 ? word(row, i - 1) >> 63 : (toroidal ? word(row, words - 1) >> last : 0);
+		return (word(row, i) << 1) | carry;
+	};
+	auto east = [&](const std::uint64_t *row, const int i) -> std::uint64_t {
+		const std::uint64_t carry = i < words - 1 ? word(row, i + 1) << 63 : (toroidal ? (word(row, 0) & 1) << last : 0);
+		return (word(row, i) >> 1) | carry;
+	};
+
+	for (int i = 0; i < words; i++) {
+		const std::uint64_t alive = word(middle, i);
+
+		std::uint64_t sum_above, carry_above, sum_side, carry_side, sum_all, carry_all;
+		add_bits(west(above, i), word(above, i), east(above, i), sum_above, carry_above);
+		add_bits(west(middle, i), east(middle, i), west(below, i), sum_side, carry_side);
+		const std::uint64_t sum_below = word(below, i) ^ east(below, i);
+		const std::uint64_t carry_below = word(below, i) & east(below, i);
+		add_bits(sum_above, sum_side, sum_below, sum_all, carry_all);
+
+		// The four carries are each worth 2
+		std::uint64_t twos, fours;
+		add_bits(carry_above, carry_side, carry_below, twos, fours);
+		const std::uint64_t bit_1 = twos ^ carry_all;
+		const std::uint64_t bit_2 = fours ^ (twos & carry_all);
+
+		// Alive with 2 or 3 neighbours, or born with 3
+		std::uint64_t next = bit_1 & ~bit_2 & (sum_all | alive);
+		if (i == words - 1) {
+			next &= last_mask;
+		}
+		out[i] = next;
+	}
+}
+
+/**
+ * World::step(source, destination, toroidal, threads)
+ *
+ * The bit-packed version of World::step(source, destination, toroidal, threads), stepping 64 cells per word operation.
+ * A view which starts part way through a word is copied to the start of its words first.
+ *
+ * @example
+ *
+ *      // Step a bit-packed soup without a World
+ *      BitGrid soup(Zoo::load_ascii("path/to/soup.gol")), next;
+ *      BitWorld::step(soup, next, true);
+ *
+ * @param source
+ *      The bit-packed grid or view to read the current state from.
+ *
+ * @param destination
+ *      The bit-packed grid to write the next state to.
+ *
+ * @param toroidal
+ *      Optional parameter. If true then the step will consider the source as a torus. Defaults to false.
+ *
+ * @param threads
+ *      Optional parameter. The number of threads to step with. Defaults to 1, 0 uses every core.
+ *
+ * @param counts
+ *      Optional parameter. If given, its population, births and deaths are set to those of the step.
+ *      Defaults to nullptr, counting nothing.
+ *
+ * @param changes
+ *      Optional parameter. If given, the changes of the step are recorded into it. Defaults to nullptr, tracking nothing.
+ */
+template <>
+void BasicWorld<BitCells>::step(const BitGridView &source, BitGrid &destination, const bool toroidal,
+								const unsigned int threads, Statistics::Generation *counts, Changes::Set *changes) {
+	if (source.get_offset() != 0) {
+		// Measured by the call on the materialized copy
+		step(source.materialize(), destination, toroidal, threads, counts, changes);
+		return;
+	}
+
+	Profile::Scope scope("BitWorld::step kernel");
+	const int width = source.get_width();
+	const int height = source.get_height();
+
+	if (destination.get_width() != width || destination.get_height() != height) {
+		destination = BitGrid(width, height);
+		place(destination, threads);
+	}
+	if (counts) {
+		counts->population = counts->births = counts->deaths = 0;
+	}
+	if (changes) {
+		changes->reset(width, height);
+	}
+	if (width == 0 || height == 0) {
+		return;
+	}
+
+	std::mutex lock;
+	step_bands(height, threads, [&](const int first, const int end) {
+		Statistics::Generation band;
+		Changes::Set own;
+		Changes::Set *tracking = band_changes(first, end, height, own, changes);
+		for (int y = first; y < end; y++) {
+			const std::uint64_t *above = y > 0 ? source.row(y - 1) : (toroidal ? source.row(height - 1) : nullptr);
+			const std::uint64_t *below = y < height - 1 ? source.row(y + 1) : (toroidal ? source.row(0) : nullptr);
+			step_bit_row(above, source.row(y), below, destination.row(y), width, toroidal);
+			if (counts) {
+				count_row<BitCells>(source.row(y), destination.row(y), width, band);
+			}
+			if (tracking) {
+				tracking->record_row<BitCells>(y, source.row(y), destination.row(y));
+			}
+		}
+		add_counts(band, counts, lock);
+		merge_changes(tracking, changes, lock);
+	});
+}
+
+/**
+ * World::place(grid, threads)
+ *
+ * Move each band of a grid's rows to the NUMA node of the pinned worker which steps that band,
+ * if placement is enabled with Topology::enable(). Does nothing otherwise.
+ * The bands are split as World::step(source, destination, toroidal, threads) splits them, so both grids
+ * of a step placed with the same number of threads stay placed however often they are swapped.
+ * A destination the step kernel has to allocate is placed by the kernel, a grid made or loaded by the
+ * caller should be placed once before stepping. Rows either side of a band boundary may share a page,
+ * which stays where it was.
+ *
+ * @example
+ *
+ *      Topology::enable();
+ *      BitGrid current(Zoo::load_ascii("path/to/file.gol")), next(current.get_width(), current.get_height());
+ *      BitWorld::place(current, 16);
+ *      BitWorld::place(next, 16);
+ *      for (int i = 0; i < 1000; i++) {
+ *          BitWorld::step(current, next, false, 16);
+ *          std::swap(current, next);
+ *      }
+ *
+ * @param grid
+ *      The grid to place. Its cells are unchanged.
+ *
+ * @param threads
+ *      The number of threads it will be stepped with, 0 for every core.
+ */
+template <typename Storage>
+void BasicWorld<Storage>::place(BasicGrid<Storage> &grid, const unsigned int threads) {
+	const int height = grid.get_height();
+	if (!Topology::enabled() || grid.get_width() == 0 || height == 0) {
+		return;
+	}
+
+	const std::size_t row_bytes = static_cast<std::size_t>(grid.get_stride()) * sizeof(typename Storage::Word);
+	step_bands(height, threads, [&grid, row_bytes](const int first, const int end) {
+		Memory::move_to_local_node(grid.row(first), row_bytes * (end - first));
+	});
+}
+
+/**
+ * World::bands(height, threads)
+ *
+ * The number of threads World::step(source, destination, toroidal, threads) steps a grid with height rows on,
+ * one band of rows each. Bands are at least 64 rows, so a short grid steps on fewer threads than it is given.
+ *
+ * @example
+ *
+ *      // A 256 row grid given 16 threads steps on 4
+ *      unsigned int used = BitWorld::bands(256, 16);
+ *
+ * @param height
+ *      The number of rows of the grid.
+ *
+ * @param threads
+ *      The number of threads the step is given, 0 for every core.
+ *
+ * @return
+ *      The number of bands, at least 1.
+ */
+template <typename Storage>
+unsigned int BasicWorld<Storage>::bands(const int height, const unsigned int threads) {
+	return static_cast<unsigned int>(count_bands(height, threads));
+}
+
+// Compile both layouts once, world.h declares them extern so other files only link against them
+template class BasicWorld<ByteCells>;
+template class BasicWorld<BitCells>;
@@ -13,44 +13,94 @@
 // Add the minimal number of includes you need in order to declare the class.
 // #include ...
 
+#include "changes.h"
 #include "grid.h"
+#include "shared.h"
+#include "statistics.h"
 
 /**
  * Declare the structure of the World class for representing a 2d grid world.
  *
  * A World holds two equally sized Grid objects for the current state and next state.
  *      - These buffers should be swapped using std::swap after each update step.
+ *
+ * BasicWorld is templated on the same storage policy as its grids.
+ * World steps one byte per cell grids, BitWorld steps bit-packed grids.
  */
-class World {
+template <typename Storage>
+class BasicWorld {
 
 private:
-	Grid current_state;
-	Grid next_state;
+	BasicGrid<Storage> current_state;
+	BasicGrid<Storage> next_state;
+	Statistics::History *statistics = nullptr;
+	Shared::Publisher *publisher = nullptr;
+	Changes::Set *changes = nullptr;
 
 	unsigned int count_neighbours(int x, int y, bool toroidal);
 	bool is_alive(int x, int y);
+	void resize_next_state();
+	void step_in_phases(bool toroidal);
 
 public:
-	World();
-	explicit World(int square_size);
-	World(int width, int gridHeight);
-	explicit World(const Grid &initial_state);
+	BasicWorld();
+	explicit BasicWorld(int square_size);
+	BasicWorld(int width, int gridHeight);
+	BasicWorld(int width, int height, Memory::Policy policy);
+	explicit BasicWorld(const BasicGrid<Storage> &initial_state);
+	explicit BasicWorld(BasicGrid<Storage> &&initial_state);
 
 	unsigned int get_width() const;
 	unsigned int get_height() const;
 	unsigned int get_total_cells() const;
 	unsigned int get_alive_cells() const;
 	unsigned int get_dead_cells() const;
-	const Grid& get_state() const;
+	const BasicGrid<Storage>& get_state() const;
 
 	void resize(int square_size);
 	void resize(int new_width, int new_height);
+	void resize(int new_width, int new_height, Anchor anchor);
+	void resize(int new_width, int new_height, int x_offset, int y_offset);
+	void reserve(std::size_t cells);
+
+	void set_statistics(Statistics::History *history);
+	Statistics::History * get_statistics() const;
+	void set_publisher(Shared::Publisher *publisher);
+	Shared::Publisher * get_publisher() const;
+	void set_changes(Changes::Set *changes);
+	Changes::Set * get_changes() const;
 
 	void step(bool toroidal = false);
 	void advance(int steps, bool toroidal = false);
+	BasicGrid<Storage> crop_ahead(int x0, int y0, int x1, int y1, int generations, bool toroidal = false) const;
+
+	static void step(const BasicGridView<Storage> &source, BasicGrid<Storage> &destination, bool toroidal = false,
+					 unsigned int threads = 1, Statistics::Generation *counts = nullptr,
+					 Changes::Set *changes = nullptr);
+	static void place(BasicGrid<Storage> &grid, unsigned int threads);
+	static unsigned int bands(int height, unsigned int threads);
+	static BasicGrid<Storage> crop_ahead(const BasicGridView<Storage> &source, int x0, int y0, int x1, int y1,
+										 int generations, bool toroidal = false, unsigned int threads = 1);
 
     // How to draw an owl:
     //      Step 1. Draw a circle.
     //      Step 2. Draw the rest of the owl.
 
 };
+
+typedef BasicWorld<ByteCells> World;
+typedef BasicWorld<BitCells> BitWorld;
+
+// Each layout has its own step kernel
+template <>
+void BasicWorld<ByteCells>::step(const BasicGridView<ByteCells> &source, BasicGrid<ByteCells> &destination,
+								 bool toroidal, unsigned int threads, Statistics::Generation *counts,
+								 Changes::Set *changes);
+template <>
+void BasicWorld<BitCells>::step(const BasicGridView<BitCells> &source, BasicGrid<BitCells> &destination,
+								bool toroidal, unsigned int threads, Statistics::Generation *counts,
+								Changes::Set *changes);
+
+// Both layouts are compiled once in world.cpp
+extern template class BasicWorld<ByteCells>;
+extern template class BasicWorld<BitCells>;
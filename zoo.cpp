@@ -1,7 +1,8 @@
 /**
  * Implements a Zoo namespace with methods for constructing Grid objects containing various creatures in the Game of Life.
  *      - Creatures like gliders, light weight spaceships, and r-pentominos can be spawned.
- *          - These creatures are drawn on a Grid the size of their bounding box.
+ *          - These creatures are drawn on a StaticGrid the size of their bounding box.
+ *          - They are constexpr and defined in zoo.h, so they can be used in constant expressions.
  *
  *      - Grids can be loaded from and saved to an ascii file format.
  *          - Ascii files are composed of:
@@ -18,6 +19,17 @@
  *                padded with zero or more 0 bits.
  *              - a 0 bit should be considered Cell::DEAD, a 1 bit should be considered Cell::ALIVE.
  *
+ *      - Grids can be loaded from the run length encoded .rle format most pattern collections are shared in.
+ *          - Lines starting with # before the header are comments.
+ *          - The header is x = width, y = height and an optional rule, which must be B3/S23.
+ *          - Then runs of cells: an optional count and b for Cell::DEAD or o for Cell::ALIVE,
+ *            $ ending a row, and ! ending the pattern. Cells a row leaves out are dead.
+ *
+ *      - Loading and saving are templated on the cell layout, so files move straight in and out of a Grid or a BitGrid.
+ *          - Rows are read and written 64 cells at a time through the layout's load and store kernels.
+ *          - The same format can be decoded from and encoded into memory, for patterns sent over a socket.
+ *          - Each load and save is measured as a Profile phase while profiling is enabled.
+ *
  * @author **REMOVED**
  * @date March, 2020
  */
@@ -26,128 +38,58 @@
 // #include ...
 
 #include "grid.h"
+#include "profile.h"
 #include "zoo.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
-/**
- * Zoo::glider()
- *
- * Construct a 3x3 grid containing a glider.
- * https://www.conwaylife.com/wiki/Glider
- *
- * @example
- *
- *      // Print a glider in a Grid the size of its bounding box.
- *      std::cout << Zoo::glider() << std::endl;
- *
- *      +---+
- *      | # |
- *      |  #|
- *      |###|
- *      +---+
- *
- * @return
- *      Returns a Grid containing a glider.
- */
-Grid Zoo::glider() {
-	Grid glider = Grid(3);
-
-	// Base
-	glider.set(0,2, Cell::ALIVE);
-	glider.set(1,2, Cell::ALIVE);
-	glider.set(2,2, Cell::ALIVE);
-
-	// Middle
-	glider.set(2,1, Cell::ALIVE);
-
-	// Top
-	glider.set(1,0, Cell::ALIVE);
-
-	return glider;
-}
+// The creatures are constant expressions, checked here while compiling
+static_assert(Zoo::glider().get_alive_cells() == 5, "A glider has 5 cells");
+static_assert(Zoo::r_pentomino().get_alive_cells() == 5, "An r-pentomino has 5 cells");
+static_assert(Zoo::light_weight_spaceship().get_alive_cells() == 9, "A light weight spaceship has 9 cells");
 
 /**
- * Zoo::r_pentomino()
- *
- * Construct a 3x3 grid containing an r-pentomino.
- * https://www.conwaylife.com/wiki/R-pentomino
- *
- * @example
- *
- *      // Print an r-pentomino in a Grid the size of its bounding box.
- *      std::cout << Zoo::r_pentomino() << std::endl;
- *
- *      +---+
- *      | ##|
- *      |## |
- *      | # |
- *      +---+
+ * read_bits(bytes, position, count)
  *
- * @return
- *      Returns a Grid containing a r-pentomino.
+ * Take count (at most 64) bits of a little endian bit stream, starting at bit position, as the low bits of a word.
  */
-Grid Zoo::r_pentomino() {
-	Grid r_pentomino = Grid(3);
-
-	// Bottom
-	r_pentomino.set(1,2, Cell::ALIVE);
-
-	// Middle
-	r_pentomino.set(0,1, Cell::ALIVE);
-	r_pentomino.set(1,1, Cell::ALIVE);
-
-	// Top
-	r_pentomino.set(1,0, Cell::ALIVE);
-	r_pentomino.set(2,0, Cell::ALIVE);
-
-	return r_pentomino;
+static std::uint64_t read_bits(const unsigned char *bytes, const std::size_t position, const int count) {
+	const std::size_t first = position / 8;
+	const int shift = static_cast<int>(position % 8);
+	const std::size_t last = (position + count + 7) / 8;
+
+	std::uint64_t bits = 0;
+	for (std::size_t i = first; i < last; i++) {
+		const int at = static_cast<int>(i - first) * 8 - shift;
+		bits |= at >= 0 ? static_cast<std::uint64_t>(bytes[i]) << at : static_cast<std::uint64_t>(bytes[i]) >> -at;
+	}
+	return count == 64 ? bits : bits & ((std::uint64_t(1) << count) - 1);
 }
 
 /**
- * Zoo::light_weight_spaceship()
- *
- * Construct a 5x4 grid containing a light weight spaceship.
- * https://www.conwaylife.com/wiki/Lightweight_spaceship
+ * write_bits(bytes, position, count, bits)
  *
- * @example
- *
- *      // Print a light weight spaceship in a Grid the size of its bounding box.
- *      std::cout << Zoo::light_weight_spaceship() << std::endl;
- *
- *      +-----+
- *      | #  #|
- *      |#    |
- *      |#   #|
- *      |#### |
- *      +-----+
- *
- * @return
- *      Returns a grid containing a light weight spaceship.
+ * Set the count (at most 64) low bits of a word into a zeroed little endian bit stream, starting at bit position.
  */
-Grid Zoo::light_weight_spaceship() {
-	Grid light_weight_spaceship = Grid(5,4);
-
-	// Bottom
-	light_weight_spaceship.set(0,3,Cell::ALIVE);
-	light_weight_spaceship.set(1,3,Cell::ALIVE);
-	light_weight_spaceship.set(2,3,Cell::ALIVE);
-	light_weight_spaceship.set(3,3,Cell::ALIVE);
-
-	// Bottom middle
-	light_weight_spaceship.set(0,2,Cell::ALIVE);
-	light_weight_spaceship.set(4,2,Cell::ALIVE);
-
-	// Top middle
-	light_weight_spaceship.set(0,1,Cell::ALIVE);
-
-	// Top
-	light_weight_spaceship.set(1,0,Cell::ALIVE);
-	light_weight_spaceship.set(4,0,Cell::ALIVE);
-
-	return light_weight_spaceship;
-
+static void write_bits(unsigned char *bytes, const std::size_t position, const int count,
+					   const std::uint64_t bits) {
+	const std::size_t first = position / 8;
+	const int shift = static_cast<int>(position % 8);
+	const std::size_t last = (position + count + 7) / 8;
+	const std::uint64_t masked = count == 64 ? bits : bits & ((std::uint64_t(1) << count) - 1);
+
+	for (std::size_t i = first; i < last; i++) {
+		const int at = static_cast<int>(i - first) * 8 - shift;
+		bytes[i] |= static_cast<unsigned char>(at >= 0 ? masked >> at : masked << -at);
+	}
 }
 
 /**
@@ -161,6 +103,9 @@ Grid Zoo::light_weight_spaceship() {
  *      // Load an ascii file from a directory
  *      Grid grid = Zoo::load_ascii("path/to/file.gol");
  *
+ *      // Load the same file bit-packed
+ *      BitGrid bits = Zoo::load_ascii<BitCells>("path/to/file.gol");
+ *
  * @param path
  *      The std::string path to the file to read in.
  *
@@ -173,8 +118,41 @@ Grid Zoo::light_weight_spaceship() {
  *          - The parsed width or height is not a positive integer.
  *          - Newline characters are not found when expected during parsing.
  *          - The character for a cell is not the ALIVE or DEAD character.
+ *          - The file has more rows than the parsed height.
  */
-Grid Zoo::load_ascii(const std::string& path) {
+template <typename Storage>
+BasicGrid<Storage> Zoo::load_ascii(const std::string& path) {
+	BasicGrid<Storage> grid;
+	load_ascii(path, grid);
+	return grid;
+}
+
+/**
+ * Zoo::load_ascii(path, grid)
+ *
+ * Load an ascii file into an existing grid, as Zoo::load_ascii(path) does.
+ * The grid is only reallocated if its size changes, so a worker loading many files of one size reuses its buffer.
+ *
+ * @example
+ *
+ *      // Load a run of files into the same grid
+ *      BitGrid grid;
+ *      for (const std::string &path : paths) {
+ *          Zoo::load_ascii(path, grid);
+ *      }
+ *
+ * @param path
+ *      The std::string path to the file to read in.
+ *
+ * @param grid
+ *      The grid to load into. Cells the file does not reach are dead, as they are in a new grid.
+ *
+ * @throws
+ *      Throws std::runtime_error or sub-class as Zoo::load_ascii(path) does. The grid may be partly loaded.
+ */
+template <typename Storage>
+void Zoo::load_ascii(const std::string& path, BasicGrid<Storage>& grid) {
+	Profile::Scope scope("Zoo::load_ascii");
 	std::ifstream input(path);
 
 	if (!input) {
@@ -196,15 +174,27 @@ Grid Zoo::load_ascii(const std::string& path) {
 		throw std::runtime_error(newline_characters_not_found_error);
 	}
 
-	Grid grid = Grid(width, height);
+	if (grid.get_width() != width || grid.get_height() != height) {
+		grid = BasicGrid<Storage>(width, height);
+	}
 
+	// Cells are gathered into a word of alive bits and stored 64 at a time
+	std::uint64_t alive = 0;
 	int x = 0;
 	int y = 0;
 	while (input.get(c)) {
 		if (c != '\n' && x != width) { // Only read if new line "\n" at the end of width of the grid
 			if (c == Cell::ALIVE || c == Cell::DEAD) { // Check if char is in enum
-				grid.set(x, y, static_cast<Cell>(c));
+				if (y >= height) {
+					throw std::runtime_error(too_many_rows_error);
+				}
+				alive |= static_cast<std::uint64_t>(c == Cell::ALIVE) << (x % 64);
 				x++;
+				if (x % 64 == 0 || x == width) { // Chunk full, store it
+					const int chunk_x = (x - 1) / 64 * 64;
+					Storage::store(grid.row(y), chunk_x, x - chunk_x, alive);
+					alive = 0;
+				}
 				if (x == width) { // Reached end of line, reset variables, read new line char
 					y++;
 					x = 0;
@@ -218,7 +208,14 @@ Grid Zoo::load_ascii(const std::string& path) {
 		}
 	}
 
-	return grid;
+	// A file which ends early leaves the rest dead, including the unstored cells of its last row
+	if (y < height) {
+		const int chunk_x = x / 64 * 64;
+		Storage::fill(grid.row(y), chunk_x, width - chunk_x, Cell::DEAD);
+		for (int rest = y + 1; rest < height; rest++) {
+			Storage::fill(grid.row(rest), 0, width, Cell::DEAD);
+		}
+	}
 }
 
 /**
@@ -249,24 +246,20 @@ Grid Zoo::load_ascii(const std::string& path) {
  * @throws
  *      Throws std::runtime_error or sub-class if the file cannot be opened.
  */
-void Zoo::save_ascii(const std::string& path, const Grid& grid) {
+template <typename Storage>
+void Zoo::save_ascii(const std::string& path, const BasicGrid<Storage>& grid) {
+	Profile::Scope scope("Zoo::save_ascii");
 	std::ofstream file(path);
 
 	if (file.is_open()) {
 		// Add width and height at the top with new line char
 		file << grid.get_width() << " " << grid.get_height() << "\n";
 
-		// Read array from top left corner going across then down and add char by char to file
+		// Write each row from the top left corner down, followed by a new line char
 		for (int y = 0; y < grid.get_height(); y++) {
-			for (int x = 0; x < grid.get_width(); x++) {
-				char c = (char) grid.get(x, y);
-				// If end of row add char followed by new line char
-				if (x >= grid.get_width() - 1) {
-					file << c << "\n";
-					break;
-				} else {
-					file << c;
-				}
+			if (grid.get_width() > 0) {
+				Storage::write_row(file, grid.row(y), 0, grid.get_width());
+				file << "\n";
 			}
 		}
 	} else {
@@ -286,6 +279,9 @@ void Zoo::save_ascii(const std::string& path, const Grid& grid) {
  *      // Load an binary file from a directory
  *      Grid grid = Zoo::load_binary("path/to/file.bgol");
  *
+ *      // Load the same file bit-packed
+ *      BitGrid bits = Zoo::load_binary<BitCells>("path/to/file.bgol");
+ *
  * @param path
  *      The std::string path to the file to read in.
  *
@@ -297,63 +293,29 @@ void Zoo::save_ascii(const std::string& path, const Grid& grid) {
  *          - The file cannot be opened.
  *          - The file ends unexpectedly.
  */
-Grid Zoo::load_binary(const std::string& path) {
-
+template <typename Storage>
+BasicGrid<Storage> Zoo::load_binary(const std::string& path) {
+	Profile::Scope scope("Zoo::load_binary");
 	std::ifstream file(path, std::ios::binary);
 	if(!file) {
 		throw std::runtime_error(file_cannot_be_opened_error + path);
 	}
 
-	int width, height;
-	file.read(reinterpret_cast<char *>(&width), 4);
-	file.read(reinterpret_cast<char *>(&height), 4);
-
-	// Check if negative numbers exist, zero them
-	if (width < 0) {
-		width = 0;
-	}
-	if (height < 0) {
-		height = 0;
-	}
-
-	Grid grid = Grid(width, height);
-	int x = 0;
-	int y = 0;
-	unsigned int grid_size = (width * height) - 1; // -1 since grid starts from 0 not 1
-
-	for (unsigned int cell_count = 0; cell_count < grid_size;) {
-		char byte = 0;
-		file.read(&byte, 1);
-
-		// Check if file ends unexpectedly
-		if (!file) {
-			throw std::runtime_error(file_ends_unexpectedly_error);
-		}
-
-		// Loop through byte and set Cell to dead or alive
-		for (int bit_no = 0; bit_no <= 7; bit_no++) {
-
-			// Reached end of row, increment height
-			if(x >= width) {
-				x = 0;
-				y++;
-				if(y >= height) { // Read whole grid, break
-					break;
-				}
-			}
-
-			// Set the cell_count depending on the bit value
-			if(((byte >> bit_no) & 1) == 1) {
-				grid.set(x, y, Cell::ALIVE);
-			} else {
-				grid.set(x, y, Cell::DEAD);
-			}
-
-			x++;
-			cell_count++;
-		}
+	// Read the header, then the whole bit stream, and decode them together
+	std::vector<unsigned char> bytes(8);
+	file.read(reinterpret_cast<char *>(bytes.data()), 8);
+	if (!file) {
+		throw std::runtime_error(file_ends_unexpectedly_error);
 	}
-
+	int width, height;
+	std::memcpy(&width, bytes.data(), 4);
+	std::memcpy(&height, bytes.data() + 4, 4);
+	const std::size_t cells = static_cast<std::size_t>(std::max(width, 0)) * std::max(height, 0);
+	bytes.resize(8 + (cells + 7) / 8);
+	file.read(reinterpret_cast<char *>(bytes.data() + 8), bytes.size() - 8);
+
+	BasicGrid<Storage> grid;
+	decode_binary(bytes.data(), file ? bytes.size() : 8 + file.gcount(), grid);
 	return grid;
 }
 
@@ -385,52 +347,356 @@ Grid Zoo::load_binary(const std::string& path) {
  * @throws
  *      Throws std::runtime_error or sub-class if the file cannot be opened.
  */
-void Zoo::save_binary(const std::string& path, const Grid& grid) {
+template <typename Storage>
+void Zoo::save_binary(const std::string& path, const BasicGrid<Storage>& grid) {
+	Profile::Scope scope("Zoo::save_binary");
 	std::ofstream file(path, std::ios::out | std::ios::binary);
 
 	if(!file) {
 		throw std::runtime_error(file_cannot_be_opened_error + path);
 	}
 
-	// Grab width and height
-	int width = grid.get_width();
-	int height = grid.get_height();
+	std::vector<unsigned char> bytes;
+	encode_binary(grid.view(), bytes);
+	file.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
 
-	// Write to file as 4 bytes
-	file.write((char*)&width,4);
-	file.write((char*)&height,4);
+/**
+ * Zoo::decode_binary(data, size, grid)
+ *
+ * Parse a grid from the bytes of a binary .bgol file held in memory, such as a message from a socket.
+ * The grid is only reallocated if its size changes, so decoding into the same grid again does not allocate.
+ *
+ * @example
+ *
+ *      // Decode a pattern received from a client
+ *      BitGrid grid;
+ *      Zoo::decode_binary(message.data(), message.size(), grid);
+ *
+ * @param data
+ *      The bytes of the file: the 4 byte width, the 4 byte height and the bit stream.
+ *
+ * @param size
+ *      The number of bytes available, trailing bytes after the bit stream are ignored.
+ *
+ * @param grid
+ *      The grid to decode into.
+ *
+ * @throws
+ *      Throws std::runtime_error or sub-class if the bytes end before the header or the bit stream does.
+ */
+template <typename Storage>
+void Zoo::decode_binary(const unsigned char *data, const std::size_t size, BasicGrid<Storage> &grid) {
+	if (size < 8) {
+		throw std::runtime_error(file_ends_unexpectedly_error);
+	}
 
-	char byte = 0;
-	int bit_count = 0;
-	int cell_count = 0;
+	int width, height;
+	std::memcpy(&width, data, 4);
+	std::memcpy(&height, data + 4, 4);
 
-	// Loop through grid, starting in top left corner going across then down
+	// Check if negative numbers exist, zero them
+	if (width < 0) {
+		width = 0;
+	}
+	if (height < 0) {
+		height = 0;
+	}
+
+	// Every byte of the bit stream must be there, including the padding in the last one
+	const std::size_t bytes = (static_cast<std::size_t>(width) * height + 7) / 8;
+	if (size - 8 < bytes) {
+		throw std::runtime_error(file_ends_unexpectedly_error);
+	}
+
+	if (grid.get_width() != width || grid.get_height() != height) {
+		grid = BasicGrid<Storage>(width, height);
+	}
+
+	// The stream runs on from one row to the next, so each row is cut out of it 64 cells at a time
+	const unsigned char *bits = data + 8;
 	for (int y = 0; y < height; y++) {
-		for (int x = 0; x < width; x++) {
-
-			// Reached end of byte
-			if (bit_count > 7) {
-				// Save byte to file
-				file.write(&byte, 1);
-				// Reset bit count
-				bit_count = 0;
-				// Reset byte;
-				byte = 0;
-			}
+		for (int x = 0; x < width; x += 64) {
+			const int count = std::min(64, width - x);
+			const std::size_t position = static_cast<std::size_t>(y) * width + x;
+			Storage::store(grid.row(y), x, count, read_bits(bits, position, count));
+		}
+	}
+}
+
+/**
+ * Zoo::encode_binary(view, bytes)
+ *
+ * Write a grid or view as the bytes of a binary .bgol file held in memory, replacing the contents of bytes.
+ * The vector keeps its capacity, so encoding into the same vector again does not allocate once it is big enough.
+ *
+ * @example
+ *
+ *      // Encode a window of a world to send to a client
+ *      std::vector<unsigned char> message;
+ *      Zoo::encode_binary(grid.crop_view(0, 0, 64, 64), message);
+ *
+ * @param view
+ *      The cells to encode.
+ *
+ * @param bytes
+ *      The vector to write the width, height and bit stream into.
+ */
+template <typename Storage>
+void Zoo::encode_binary(const BasicGridView<Storage> &view, std::vector<unsigned char> &bytes) {
+	const int width = view.get_width();
+	const int height = view.get_height();
+
+	// Write the width and height as 4 bytes each, then the zeroed bit stream
+	bytes.assign(8 + (static_cast<std::size_t>(width) * height + 7) / 8, 0);
+	std::memcpy(bytes.data(), &width, 4);
+	std::memcpy(bytes.data() + 4, &height, 4);
+
+	// Pack each row into the bit stream 64 cells at a time, the last byte is padded with 0 bits
+	unsigned char *bits = bytes.data() + 8;
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x += 64) {
+			const int count = std::min(64, width - x);
+			const std::size_t position = static_cast<std::size_t>(y) * width + x;
+			write_bits(bits, position, count, Storage::load(view.row(y), view.get_offset() + x, count));
+		}
+	}
+}
+
+/**
+ * trim(text)
+ *
+ * Copy a string without the white space at either end.
+ */
+static std::string trim(const std::string &text) {
+	std::size_t first = 0;
+	std::size_t end = text.size();
+	while (first < end && std::isspace(static_cast<unsigned char>(text[first]))) {
+		first++;
+	}
+	while (end > first && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+		end--;
+	}
+	return text.substr(first, end - first);
+}
+
+/**
+ * Zoo::check_rule(rule)
+ *
+ * Check that a rule is the only one the worlds step, Conway's B3/S23.
+ * Birth and survival notation is accepted either way round, as is the older survival/birth 23/3,
+ * ignoring case and white space.
+ *
+ * @example
+ *
+ *      Zoo::check_rule("B3/S23");      // Fine
+ *      Zoo::check_rule("b3 / s23");    // Fine
+ *      Zoo::check_rule("B36/S23");     // Throws
+ *
+ * @param rule
+ *      The rule, as written in an RLE header.
+ *
+ * @throws
+ *      Throws std::runtime_error if the rule is any other.
+ */
+void Zoo::check_rule(const std::string& rule) {
+	std::string normal;
+	for (const char c : rule) {
+		if (!std::isspace(static_cast<unsigned char>(c))) {
+			normal += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+		}
+	}
+	if (normal != "B3/S23" && normal != "S23/B3" && normal != "23/3") {
+		throw std::runtime_error(unsupported_rule_error + rule);
+	}
+}
+
+/**
+ * Zoo::load_rle(path)
+ *
+ * Load a run length encoded .rle file and parse it as a grid of cells.
+ *
+ * @example
+ *
+ *      // Load a pattern downloaded from a collection, bit-packed
+ *      BitGrid grid = Zoo::load_rle<BitCells>("path/to/gosper_glider_gun.rle");
+ *
+ * @param path
+ *      The std::string path to the file to read in.
+ *
+ * @return
+ *      Returns the parsed grid.
+ *
+ * @throws
+ *      Throws std::runtime_error or sub-class if the file cannot be opened, or as Zoo::decode_rle does.
+ */
+template <typename Storage>
+BasicGrid<Storage> Zoo::load_rle(const std::string& path) {
+	Profile::Scope scope("Zoo::load_rle");
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error(file_cannot_be_opened_error + path);
+	}
+
+	const std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	BasicGrid<Storage> grid;
+	decode_rle(text.data(), text.size(), grid);
+	return grid;
+}
+
+/**
+ * Zoo::decode_rle(text, size, grid, max_cells)
+ *
+ * Parse a grid from the text of a run length encoded .rle file held in memory, such as a message from a socket.
+ * The grid is only reallocated if its size changes, so decoding into the same grid again does not allocate.
+ *
+ * @example
+ *
+ *      // Decode a glider
+ *      BitGrid grid;
+ *      const std::string glider = "x = 3, y = 3, rule = B3/S23\nbo$2bo$3o!";
+ *      Zoo::decode_rle(glider.data(), glider.size(), grid);
+ *
+ * @param text
+ *      The text of the file. Anything after the ! which ends the pattern is ignored.
+ *
+ * @param size
+ *      The number of characters of text.
+ *
+ * @param grid
+ *      The grid to decode into.
+ *
+ * @param max_cells
+ *      Optional parameter. The most cells the header may ask for, so a few bytes of text from an untrusted
+ *      source cannot make a huge grid. Defaults to no limit.
+ *
+ * @throws
+ *      Throws std::runtime_error or sub-class if:
+ *          - The header is missing, or its width or height is missing or not a non-negative integer.
+ *          - The header's rule is not B3/S23.
+ *          - The width times the height is more than max_cells.
+ *          - The pattern has a character other than a digit, b, o, $, ! or white space.
+ *          - A row is wider than the width, or the pattern has cells below the height.
+ */
+template <typename Storage>
+void Zoo::decode_rle(const char *text, const std::size_t size, BasicGrid<Storage> &grid, const std::size_t max_cells) {
+	std::size_t position = 0;
+
+	// Skip the comment lines before the header
+	while (position < size) {
+		while (position < size && std::isspace(static_cast<unsigned char>(text[position]))) {
+			position++;
+		}
+		if (position == size || text[position] != '#') {
+			break;
+		}
+		while (position < size && text[position] != '\n') {
+			position++;
+		}
+	}
 
-			// Flip bit in byte variable to 1 if cell alive
-			if(grid.get(x, y) == Cell::ALIVE) {
-				byte += (1 << bit_count);
+	// The header is one line of comma separated key = value pairs
+	const char *header_end = std::find(text + position, text + size, '\n');
+	const std::string header(text + position, header_end);
+	position = static_cast<std::size_t>(header_end - text);
+
+	long long width = -1, height = -1;
+	std::stringstream pairs(header);
+	std::string pair;
+	while (std::getline(pairs, pair, ',')) {
+		const std::size_t equals = pair.find('=');
+		if (equals == std::string::npos) {
+			throw std::runtime_error(rle_header_error + header);
+		}
+		const std::string key = trim(pair.substr(0, equals));
+		const std::string value = trim(pair.substr(equals + 1));
+		if (key == "x" || key == "y") {
+			std::size_t used = 0;
+			long long number = -1;
+			try {
+				number = std::stoll(value, &used);
+			}
+			catch (const std::logic_error &) {
+				used = 0;
+			}
+			if (used == 0 || used != value.size() || number < 0 || number > INT_MAX) {
+				throw std::runtime_error(rle_header_error + header);
 			}
+			(key == "x" ? width : height) = number;
+		} else if (key == "rule") {
+			check_rule(value);
+		}
+	}
+	if (width < 0 || height < 0) {
+		throw std::runtime_error(rle_header_error + header);
+	}
+	if (height > 0 && static_cast<unsigned long long>(width) > max_cells / static_cast<unsigned long long>(height)) {
+		throw std::runtime_error(rle_too_many_cells_error + std::to_string(max_cells));
+	}
 
-			// Increment variables
-			bit_count++;
-			cell_count++;
+	if (grid.get_width() != width || grid.get_height() != height) {
+		grid = BasicGrid<Storage>(static_cast<int>(width), static_cast<int>(height));
+	} else {
+		for (int y = 0; y < height; y++) {
+			Storage::fill(grid.row(y), 0, static_cast<int>(width), Cell::DEAD);
 		}
 	}
 
-	// Pad file with 0 bits if needed
-	if (bit_count > 0) {
-		file.write(&byte, 1);
+	// Each run is a count, 1 if left out, and a tag. Counts are capped, as any count that large is an error anyway
+	long long x = 0;
+	long long y = 0;
+	long long count = 0;
+	for (; position < size; position++) {
+		const char c = text[position];
+		if (c >= '0' && c <= '9') {
+			count = std::min<long long>(count * 10 + (c - '0'), LLONG_MAX / 20);
+			continue;
+		}
+		if (std::isspace(static_cast<unsigned char>(c))) {
+			continue;
+		}
+		if (c == '!') {
+			break;
+		}
+
+		const long long run = count == 0 ? 1 : count;
+		count = 0;
+		if (c == '$') {
+			y = std::min(y + run, height + 1);
+			x = 0;
+		} else if (c == 'b' || c == 'o') {
+			if (run > width - x) {
+				throw std::runtime_error(rle_row_too_long_error);
+			}
+			if (y >= height) {
+				throw std::runtime_error(too_many_rows_error);
+			}
+			if (c == 'o') {
+				Storage::fill(grid.row(static_cast<int>(y)), static_cast<int>(x), static_cast<int>(run), Cell::ALIVE);
+			}
+			x += run;
+		} else {
+			throw std::runtime_error(rle_unexpected_character_error + std::string(1, c));
+		}
 	}
 }
+
+// Both layouts are compiled once here
+template BasicGrid<ByteCells> Zoo::load_ascii<ByteCells>(const std::string& path);
+template BasicGrid<BitCells> Zoo::load_ascii<BitCells>(const std::string& path);
+template void Zoo::load_ascii<ByteCells>(const std::string& path, Grid& grid);
+template void Zoo::load_ascii<BitCells>(const std::string& path, BitGrid& grid);
+template void Zoo::save_ascii<ByteCells>(const std::string& path, const BasicGrid<ByteCells>& grid);
+template void Zoo::save_ascii<BitCells>(const std::string& path, const BasicGrid<BitCells>& grid);
+template BasicGrid<ByteCells> Zoo::load_binary<ByteCells>(const std::string& path);
+template BasicGrid<BitCells> Zoo::load_binary<BitCells>(const std::string& path);
+template void Zoo::save_binary<ByteCells>(const std::string& path, const BasicGrid<ByteCells>& grid);
+template void Zoo::save_binary<BitCells>(const std::string& path, const BasicGrid<BitCells>& grid);
+template void Zoo::decode_binary<ByteCells>(const unsigned char *data, std::size_t size, Grid &grid);
+template void Zoo::decode_binary<BitCells>(const unsigned char *data, std::size_t size, BitGrid &grid);
+template void Zoo::encode_binary<ByteCells>(const GridView &view, std::vector<unsigned char> &bytes);
+template void Zoo::encode_binary<BitCells>(const BitGridView &view, std::vector<unsigned char> &bytes);
+template BasicGrid<ByteCells> Zoo::load_rle<ByteCells>(const std::string& path);
+template BasicGrid<BitCells> Zoo::load_rle<BitCells>(const std::string& path);
+template void Zoo::decode_rle<ByteCells>(const char *text, std::size_t size, Grid &grid, std::size_t max_cells);
+template void Zoo::decode_rle<BitCells>(const char *text, std::size_t size, BitGrid &grid, std::size_t max_cells);
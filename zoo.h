@@ -1,6 +1,7 @@
 /**
  * Declares a Zoo namespace with methods for constructing Grid objects containing various creatures in the Game of Life.
  * Rich documentation for the api and behaviour the Zoo namespace can be found in zoo.cpp.
+ * The creatures are constexpr, so they are defined and documented here.
  *
  * The test suites provide granular BDD style (Behaviour Driven Development) test cases
  * which will help further understand the specification you need to code to.
@@ -12,7 +13,10 @@
 
 // Add the minimal number of includes you need in order to declare the namespace.
 // #include ...
+#include <cstdint>
+#include <vector>
 #include "grid.h"
+#include "static_grid.h"
 
 /**
  * Declare the interface of the Zoo namespace for constructing lifeforms and saving and loading them from file.
@@ -25,12 +29,114 @@ namespace Zoo {
 	const std::string file_ends_unexpectedly_error = "File ends unexpectedly";
 	const std::string char_not_in_cell_enum_error = "The character for a cell is not the ALIVE or DEAD character";
 	const std::string height_or_width_not_positive_error = "The parsed grid width or grid height is not a positive integer:";
+	const std::string too_many_rows_error = "The file has more rows than the parsed grid height";
+	const std::string rle_header_error = "The RLE header is not of the form x = width, y = height: ";
+	const std::string rle_unexpected_character_error = "The RLE pattern has a character which is not a cell, $ or !: ";
+	const std::string rle_row_too_long_error = "The RLE pattern has a row wider than the header's width";
+	const std::string rle_too_many_cells_error = "The RLE pattern has more cells than the limit: ";
+	const std::string unsupported_rule_error = "Only the rule B3/S23 is supported: ";
 
-	Grid glider();
-	Grid r_pentomino();
-	Grid light_weight_spaceship();
-	Grid load_ascii(const std::string& path);
-	void save_ascii(const std::string& path, const Grid& grid);
-	Grid load_binary(const std::string& path);
-	void save_binary(const std::string& path, const Grid& grid);
+	/**
+	 * Zoo::glider()
+	 *
+	 * Construct a 3x3 grid containing a glider.
+	 * https://www.conwaylife.com/wiki/Glider
+	 *
+	 * @example
+	 *
+	 *      // Print a glider in a grid the size of its bounding box.
+	 *      std::cout << Zoo::glider() << std::endl;
+	 *
+	 *      +---+
+	 *      | # |
+	 *      |  #|
+	 *      |###|
+	 *      +---+
+	 *
+	 *      // Or build one while compiling
+	 *      constexpr StaticGrid<3, 3> glider = Zoo::glider();
+	 *
+	 * @return
+	 *      Returns a StaticGrid containing a glider, which converts to a Grid or GridView where one is needed.
+	 */
+	constexpr StaticGrid<3, 3> glider() {
+		return StaticGrid<3, 3>::parse(".#./..#/###");
+	}
+
+	/**
+	 * Zoo::r_pentomino()
+	 *
+	 * Construct a 3x3 grid containing an r-pentomino.
+	 * https://www.conwaylife.com/wiki/R-pentomino
+	 *
+	 * @example
+	 *
+	 *      // Print an r-pentomino in a grid the size of its bounding box.
+	 *      std::cout << Zoo::r_pentomino() << std::endl;
+	 *
+	 *      +---+
+	 *      | ##|
+	 *      |## |
+	 *      | # |
+	 *      +---+
+	 *
+	 * @return
+	 *      Returns a StaticGrid containing a r-pentomino, which converts to a Grid or GridView where one is needed.
+	 */
+	constexpr StaticGrid<3, 3> r_pentomino() {
+		return StaticGrid<3, 3>::parse(".##/##./.#.");
+	}
+
+	/**
+	 * Zoo::light_weight_spaceship()
+	 *
+	 * Construct a 5x4 grid containing a light weight spaceship.
+	 * https://www.conwaylife.com/wiki/Lightweight_spaceship
+	 *
+	 * @example
+	 *
+	 *      // Print a light weight spaceship in a grid the size of its bounding box.
+	 *      std::cout << Zoo::light_weight_spaceship() << std::endl;
+	 *
+	 *      +-----+
+	 *      | #  #|
+	 *      |#    |
+	 *      |#   #|
+	 *      |#### |
+	 *      +-----+
+	 *
+	 * @return
+	 *      Returns a StaticGrid containing a light weight spaceship, which converts to a Grid or GridView
+	 *      where one is needed.
+	 */
+	constexpr StaticGrid<5, 4> light_weight_spaceship() {
+		return StaticGrid<5, 4>::parse(".#..#/#..../#...#/####.");
+	}
+
+
+	// Files can be loaded into and saved from either cell layout, a plain Grid by default
+	template <typename Storage = ByteCells>
+	BasicGrid<Storage> load_ascii(const std::string& path);
+	template <typename Storage>
+	void load_ascii(const std::string& path, BasicGrid<Storage>& grid);
+	template <typename Storage>
+	void save_ascii(const std::string& path, const BasicGrid<Storage>& grid);
+	template <typename Storage = ByteCells>
+	BasicGrid<Storage> load_binary(const std::string& path);
+	template <typename Storage>
+	void save_binary(const std::string& path, const BasicGrid<Storage>& grid);
+
+	// The binary format can also be decoded from and encoded into memory
+	template <typename Storage>
+	void decode_binary(const unsigned char *data, std::size_t size, BasicGrid<Storage>& grid);
+	template <typename Storage>
+	void encode_binary(const BasicGridView<Storage>& view, std::vector<unsigned char>& bytes);
+
+	// Run length encoded patterns, as most pattern collections are shared, can be loaded from a file or memory
+	template <typename Storage = ByteCells>
+	BasicGrid<Storage> load_rle(const std::string& path);
+	template <typename Storage>
+	void decode_rle(const char *text, std::size_t size, BasicGrid<Storage>& grid, std::size_t max_cells = SIZE_MAX);
+
+	void check_rule(const std::string& rule);
 };